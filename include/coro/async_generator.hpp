@@ -0,0 +1,264 @@
+#pragma once
+
+#include "coro/frame_allocator.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace coro
+{
+template<typename T>
+class async_generator;
+
+namespace detail
+{
+template<typename T>
+class async_generator_promise : public pooled_frame
+{
+public:
+    using value_type     = std::remove_reference_t<T>;
+    using reference_type = std::conditional_t<std::is_reference_v<T>, T, T&>;
+    using pointer_type   = value_type*;
+
+    /// Hands control back to the consumer that asked for the next value, or that the generator completed.
+    struct yield_awaitable
+    {
+        auto await_ready() const noexcept -> bool { return false; }
+
+        auto await_suspend(std::coroutine_handle<async_generator_promise> producer) noexcept -> std::coroutine_handle<>
+        {
+            return producer.promise().m_consumer;
+        }
+
+        auto await_resume() noexcept -> void {}
+    };
+
+    async_generator_promise() noexcept = default;
+
+    auto get_return_object() noexcept -> async_generator<T>;
+
+    /// The producer does not run until the consumer first asks for a value.
+    auto initial_suspend() const noexcept { return std::suspend_always{}; }
+
+    auto final_suspend() noexcept { return yield_awaitable{}; }
+
+    auto yield_value(value_type& value) noexcept -> yield_awaitable
+    {
+        m_value = std::addressof(value);
+        return yield_awaitable{};
+    }
+
+    auto yield_value(value_type&& value) noexcept -> yield_awaitable
+    {
+        // The temporary lives until the producer is resumed, which is after the consumer is done with it.
+        m_value = std::addressof(value);
+        return yield_awaitable{};
+    }
+
+    auto unhandled_exception() noexcept -> void { m_exception = std::current_exception(); }
+
+    auto return_void() noexcept -> void {}
+
+    auto value() const noexcept -> reference_type { return static_cast<reference_type>(*m_value); }
+
+    auto consumer(std::coroutine_handle<> consumer) noexcept -> void { m_consumer = consumer; }
+
+    auto rethrow_if_exception() -> void
+    {
+        if (m_exception)
+        {
+            std::rethrow_exception(std::exchange(m_exception, nullptr));
+        }
+    }
+
+private:
+    pointer_type            m_value{nullptr};
+    std::exception_ptr      m_exception{nullptr};
+    std::coroutine_handle<> m_consumer{nullptr};
+};
+
+struct async_generator_sentinel
+{
+};
+
+template<typename T>
+class async_generator_iterator
+{
+    using coroutine_handle = std::coroutine_handle<async_generator_promise<T>>;
+
+public:
+    using iterator_category = std::input_iterator_tag;
+    using difference_type   = std::ptrdiff_t;
+    using value_type        = typename async_generator_promise<T>::value_type;
+    using reference         = typename async_generator_promise<T>::reference_type;
+    using pointer           = typename async_generator_promise<T>::pointer_type;
+
+    /// Resumes the producer until it yields its next value or completes.
+    struct advance_operation
+    {
+        auto await_ready() const noexcept -> bool { return m_coroutine == nullptr || m_coroutine.done(); }
+
+        auto await_suspend(std::coroutine_handle<> consumer) noexcept -> std::coroutine_handle<>
+        {
+            m_coroutine.promise().consumer(consumer);
+            return m_coroutine;
+        }
+
+        auto await_resume() -> async_generator_iterator&
+        {
+            if (m_coroutine != nullptr && m_coroutine.done())
+            {
+                m_coroutine.promise().rethrow_if_exception();
+            }
+            return m_iterator;
+        }
+
+        coroutine_handle          m_coroutine;
+        async_generator_iterator& m_iterator;
+    };
+
+    async_generator_iterator() noexcept {}
+
+    explicit async_generator_iterator(coroutine_handle coroutine) noexcept : m_coroutine(coroutine) {}
+
+    friend auto operator==(const async_generator_iterator& it, async_generator_sentinel) noexcept -> bool
+    {
+        return it.m_coroutine == nullptr || it.m_coroutine.done();
+    }
+
+    friend auto operator!=(const async_generator_iterator& it, async_generator_sentinel s) noexcept -> bool
+    {
+        return !(it == s);
+    }
+
+    friend auto operator==(async_generator_sentinel s, const async_generator_iterator& it) noexcept -> bool
+    {
+        return (it == s);
+    }
+
+    friend auto operator!=(async_generator_sentinel s, const async_generator_iterator& it) noexcept -> bool
+    {
+        return it != s;
+    }
+
+    /**
+     * Must be awaited, resumes the producer to fetch the next value.
+     */
+    [[nodiscard]] auto operator++() noexcept -> advance_operation { return advance_operation{m_coroutine, *this}; }
+
+    auto operator*() const noexcept -> reference { return m_coroutine.promise().value(); }
+
+    auto operator->() const noexcept -> pointer { return std::addressof(operator*()); }
+
+private:
+    coroutine_handle m_coroutine{nullptr};
+};
+
+} // namespace detail
+
+/**
+ * A generator whose body may co_await between yields, e.g. to page over a socket or a database cursor
+ * without materializing the whole result set.  The producer only runs when the consumer asks for the
+ * next value, control is handed back and forth between the two with symmetric transfer so no
+ * scheduler is involved unless the producer itself awaits something that reschedules it.
+ *
+ * Values are consumed from within a coroutine:
+ *
+ *     for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it)
+ *     {
+ *         use(*it);
+ *     }
+ *
+ * A yielded value is only valid until the iterator is advanced.  Destroying the generator before it
+ * completes destroys the suspended producer, it must not be destroyed while the producer is running.
+ */
+template<typename T>
+class [[nodiscard]] async_generator
+{
+public:
+    using promise_type = detail::async_generator_promise<T>;
+    using iterator     = detail::async_generator_iterator<T>;
+    using sentinel     = detail::async_generator_sentinel;
+
+    /// Starts the producer and completes with an iterator to its first value.
+    struct begin_operation
+    {
+        auto await_ready() const noexcept -> bool { return m_coroutine == nullptr || m_coroutine.done(); }
+
+        auto await_suspend(std::coroutine_handle<> consumer) noexcept -> std::coroutine_handle<>
+        {
+            m_coroutine.promise().consumer(consumer);
+            return m_coroutine;
+        }
+
+        auto await_resume() -> iterator
+        {
+            if (m_coroutine != nullptr && m_coroutine.done())
+            {
+                m_coroutine.promise().rethrow_if_exception();
+            }
+            return iterator{m_coroutine};
+        }
+
+        std::coroutine_handle<promise_type> m_coroutine;
+    };
+
+    async_generator() noexcept : m_coroutine(nullptr) {}
+
+    async_generator(const async_generator&) = delete;
+    async_generator(async_generator&& other) noexcept : m_coroutine(std::exchange(other.m_coroutine, nullptr)) {}
+
+    auto operator=(const async_generator&) = delete;
+    auto operator=(async_generator&& other) noexcept -> async_generator&
+    {
+        if (std::addressof(other) != this)
+        {
+            if (m_coroutine != nullptr)
+            {
+                m_coroutine.destroy();
+            }
+
+            m_coroutine = std::exchange(other.m_coroutine, nullptr);
+        }
+
+        return *this;
+    }
+
+    ~async_generator()
+    {
+        if (m_coroutine != nullptr)
+        {
+            m_coroutine.destroy();
+        }
+    }
+
+    /**
+     * Must be awaited, runs the producer until it yields its first value or completes.
+     */
+    [[nodiscard]] auto begin() noexcept -> begin_operation { return begin_operation{m_coroutine}; }
+
+    auto end() noexcept -> sentinel { return sentinel{}; }
+
+private:
+    friend class detail::async_generator_promise<T>;
+
+    explicit async_generator(std::coroutine_handle<promise_type> coroutine) noexcept : m_coroutine(coroutine) {}
+
+    std::coroutine_handle<promise_type> m_coroutine{nullptr};
+};
+
+namespace detail
+{
+template<typename T>
+auto async_generator_promise<T>::get_return_object() noexcept -> async_generator<T>
+{
+    return async_generator<T>{std::coroutine_handle<async_generator_promise<T>>::from_promise(*this)};
+}
+
+} // namespace detail
+
+} // namespace coro
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <ostream>
+#include <source_location>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+/**
+ * One frame of a task's async stack.  Each coro::task carries a frame in its promise that links to the frame of
+ * the task awaiting it, walking the links from a frame gives the logical call chain of suspended tasks that the
+ * native stack loses once a task suspends and is later resumed by an executor.
+ *
+ * A task's frame is linked when it is awaited by another task, either directly or through when_all.  The tasks
+ * given to when_any can outlive it and are the roots of their own chains, as are tasks awaited through another
+ * kind of coroutine, sync_wait for example.
+ */
+class async_stack_frame
+{
+public:
+    async_stack_frame() noexcept = default;
+    async_stack_frame(const async_stack_frame&)                    = delete;
+    async_stack_frame(async_stack_frame&&)                         = delete;
+    auto operator=(const async_stack_frame&) -> async_stack_frame& = delete;
+    auto operator=(async_stack_frame&&) -> async_stack_frame&      = delete;
+    ~async_stack_frame();
+
+    /**
+     * @return The frame of the task awaiting this one, nullptr for the root of the chain.
+     */
+    auto parent() const noexcept -> const async_stack_frame* { return m_parent.load(std::memory_order::acquire); }
+
+    auto coroutine() const noexcept -> std::coroutine_handle<> { return m_coroutine; }
+
+    /**
+     * @return The coroutine's resume function, which symbolizes to the coroutine's name with addr2line or dladdr,
+     *         nullptr on compilers whose frame layout is unknown.
+     */
+    auto resume_address() const noexcept -> void*
+    {
+    #if defined(__GNUC__) || defined(__clang__)
+        // gcc and clang both start a coroutine frame with its resume function.
+        return m_coroutine ? *static_cast<void* const*>(m_coroutine.address()) : nullptr;
+    #else
+        return nullptr;
+    #endif
+    }
+
+    /**
+     * @return The location the task last passed with this_task::annotate(), line() is zero if it never has.
+     */
+    auto location() const noexcept -> std::source_location { return m_location.load(std::memory_order::relaxed); }
+
+    /**
+     * Registers the frame so async_stack::suspended() can find it, called once the task's coroutine exists.
+     */
+    auto attach(std::coroutine_handle<> coroutine) noexcept -> void;
+
+    /**
+     * Unregisters the frame and unlinks it from its parent, called when the task completes.  A completed task can
+     * outlive the task that awaited it.
+     */
+    auto detach() noexcept -> void;
+
+    auto parent(async_stack_frame* parent) noexcept -> void { m_parent.store(parent, std::memory_order::release); }
+
+    auto location(std::source_location location) noexcept -> void
+    {
+        m_location.store(location, std::memory_order::relaxed);
+    }
+
+private:
+    friend struct async_stack_registry;
+
+    std::atomic<async_stack_frame*>   m_parent{nullptr};
+    std::coroutine_handle<>           m_coroutine{nullptr};
+    std::atomic<std::source_location> m_location{std::source_location{}};
+
+    /// The registry of every attached frame, guarded by the registry's mutex.
+    bool               m_attached{false};
+    async_stack_frame* m_prev{nullptr};
+    async_stack_frame* m_next{nullptr};
+};
+
+/**
+ * A copy of one async_stack_frame taken while walking a chain.
+ */
+struct async_stack_entry
+{
+    void*                coroutine{nullptr};
+    void*                resume_address{nullptr};
+    std::source_location location{};
+};
+
+namespace async_stack
+{
+/**
+ * The hook for sampling profilers, it only reads a thread local and is safe to call from a signal handler, as
+ * is walking the returned frame's parents while the sampled thread is stopped.
+ * @return The frame of the task running on the calling thread, nullptr if no task is running.
+ */
+auto current() noexcept -> const async_stack_frame*;
+
+auto current(const async_stack_frame* frame) noexcept -> void;
+
+/**
+ * @return The chain from the frame to its root, the frame first.
+ */
+auto backtrace(const async_stack_frame* frame) -> std::vector<async_stack_entry>;
+
+/**
+ * Every live task that is not itself awaiting another task is the innermost frame of a chain, this includes
+ * tasks that are running at the time of the call.
+ * @return The backtrace of each chain.
+ */
+auto suspended() -> std::vector<std::vector<async_stack_entry>>;
+
+/**
+ * Writes every backtrace from suspended(), one frame per line.
+ */
+auto dump(std::ostream& out) -> void;
+
+} // namespace async_stack
+
+namespace detail
+{
+/**
+ * Wraps every awaiter inside a task so the thread's current frame follows the task: it is cleared when the
+ * task suspends and set again when the task resumes, on whichever thread that happens.
+ */
+template<typename awaiter_type>
+struct async_stack_awaiter
+{
+    awaiter_type       m_awaiter;
+    async_stack_frame* m_frame;
+
+    auto await_ready() -> bool { return m_awaiter.await_ready(); }
+
+    template<typename promise_type>
+    auto await_suspend(std::coroutine_handle<promise_type> awaiting_coroutine) -> decltype(auto)
+    {
+        // The task may be resumed on another thread before this returns, this thread is done with it now.
+        async_stack::current(nullptr);
+        return m_awaiter.await_suspend(awaiting_coroutine);
+    }
+
+    auto await_resume() -> decltype(auto)
+    {
+        async_stack::current(m_frame);
+        return m_awaiter.await_resume();
+    }
+};
+
+template<typename awaitable_type>
+auto make_async_stack_awaiter(awaitable_type&& awaitable, async_stack_frame& frame)
+{
+    // The operand of co_await lives until the await completes so an awaiter is referenced, an awaiter returned
+    // from operator co_await is constructed in place.
+    if constexpr (requires { std::forward<awaitable_type>(awaitable).operator co_await(); })
+    {
+        using awaiter_type = decltype(std::forward<awaitable_type>(awaitable).operator co_await());
+        return async_stack_awaiter<awaiter_type>{std::forward<awaitable_type>(awaitable).operator co_await(), &frame};
+    }
+    else if constexpr (requires { operator co_await(std::forward<awaitable_type>(awaitable)); })
+    {
+        using awaiter_type = decltype(operator co_await(std::forward<awaitable_type>(awaitable)));
+        return async_stack_awaiter<awaiter_type>{operator co_await(std::forward<awaitable_type>(awaitable)), &frame};
+    }
+    else
+    {
+        return async_stack_awaiter<std::remove_reference_t<awaitable_type>&>{awaitable, &frame};
+    }
+}
+
+} // namespace detail
+#endif // LIBCORO_FEATURE_ASYNC_STACK
+
+namespace this_task
+{
+/**
+ * Records the source location on the awaiting task's async stack frame, it shows up in async_stack backtraces
+ * until the task passes another annotation.  Completes immediately, without LIBCORO_FEATURE_ASYNC_STACK it does
+ * nothing.
+ */
+struct annotate
+{
+    explicit annotate(std::source_location location = std::source_location::current()) noexcept
+        : m_location(location)
+    {
+    }
+
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+    auto await_ready() const noexcept -> bool { return false; }
+
+    template<typename promise_type>
+    auto await_suspend(std::coroutine_handle<promise_type> awaiting_coroutine) noexcept -> bool
+    {
+        if constexpr (requires { awaiting_coroutine.promise().async_frame(); })
+        {
+            awaiting_coroutine.promise().async_frame().location(m_location);
+        }
+        return false;
+    }
+#else
+    auto await_ready() const noexcept -> bool { return true; }
+
+    auto await_suspend(std::coroutine_handle<>) noexcept -> bool { return false; }
+#endif
+
+    auto await_resume() const noexcept -> void {}
+
+    std::source_location m_location;
+};
+
+} // namespace this_task
+
+} // namespace coro
@@ -36,13 +36,13 @@ concept executor = requires(executor_type e, std::coroutine_handle<> c)
 #ifdef LIBCORO_FEATURE_NETWORKING
 #if defined(CORO_PLATFORM_UNIX)
 template<typename executor_type>
-concept io_executor = executor<executor_type> and requires(executor_type e, std::coroutine_handle<> c, fd_t fd, coro::poll_op op, std::chrono::milliseconds timeout)
+concept io_executor = executor<executor_type> and requires(executor_type e, std::coroutine_handle<> c, fd_t fd, coro::poll_op op, std::chrono::nanoseconds timeout)
 {
-    { e.poll(fd, op, timeout) } -> std::same_as<coro::task<poll_status>>;
+    { e.poll(fd, op, timeout) } -> coro::concepts::awaiter;
 };
 #elif defined(CORO_PLATFORM_WINDOWS)
 template<typename executor_type>
-concept io_executor = executor<executor_type> and requires(executor_type e, coro::detail::poll_info pi, std::chrono::milliseconds timeout)
+concept io_executor = executor<executor_type> and requires(executor_type e, coro::detail::poll_info pi, std::chrono::nanoseconds timeout)
 {
     { e.poll(pi, timeout) } -> std::same_as<coro::task<poll_status>>;
 };
@@ -1,20 +1,19 @@
 #pragma once
 
-#include "coro/detail/task_self_deleting.hpp"
-#include "coro/detail/awaiter_list.hpp"
 #include "coro/concepts/executor.hpp"
 #include "coro/task.hpp"
-#include "coro/event.hpp"
 #include "coro/mutex.hpp"
-#include "coro/when_any.hpp"
 
-#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <limits>
+#include <mutex>
 #include <optional>
 
 #ifdef LIBCORO_FEATURE_NETWORKING
+#include "coro/io_scheduler.hpp"
 #include <stop_token>
 #endif
 
@@ -31,9 +30,9 @@ private:
     {
         /// @brief The waiter is ready to be resumed, either the predicate passed or its been requested to stop.
         ready,
-        /// @brief The waiter is not ready to be resumed
+        /// @brief The waiter is not ready to be resumed, it has been re-enqueued.
         not_ready,
-        /// @brief The waiter is a hook and has timed out and is dead.
+        /// @brief The waiter timed out while being notified, the notify should go to another waiter.
         awaiter_dead,
     };
 
@@ -47,8 +46,15 @@ private:
         auto operator=(const awaiter_base&) -> awaiter_base& = delete;
         auto operator=(awaiter_base&&) -> awaiter_base& = delete;
 
-        /// @brief The next waiting awaiter.
+        /// @brief The neighbouring waiters, these and the flags below are guarded by the condition variable's m_awaiters_mutex.
+        awaiter_base* m_prev{nullptr};
         awaiter_base* m_next{nullptr};
+        /// @brief Stamped when the waiter is enqueued, notify_all() only notifies waiters enqueued before it started.
+        std::uint64_t m_epoch{0};
+        /// @brief Is the waiter currently in the condition variable's list, a notify dequeues it while notifying it.
+        bool m_queued{false};
+        /// @brief Set once a wait_[for|until]() times out, the waiter is never enqueued again.
+        bool m_expired{false};
         /// @brief The coroutine to resume the waiter.
         std::coroutine_handle<> m_awaiting_coroutine{nullptr};
         /// @brief The condition variable this waiter is waiting on.
@@ -56,9 +62,23 @@ private:
         /// @brief The lock that the wait() was called with.
         coro::scoped_lock& m_lock;
 
-        /// @brief Each awaiter type defines its own notify behavior.
+        /// @brief Re-acquires the lock on the waiter's behalf without a coroutine, see relock().
+        std::optional<detail::lock_operation<void>> m_relock{std::nullopt};
+
+        /// @brief Each awaiter type defines its own notify behavior, a waiter that is not ready re-enqueues itself
+        ///        before releasing the lock, the notifier must not touch the waiter once this completes.
         /// @return The status of if the waiter's notify result.
         virtual auto on_notify() -> coro::task<notify_status_t> = 0;
+
+        /// @brief Wait morphing for notify_all(), moves the waiter straight onto its mutex's waiter list so it is
+        ///        resumed holding the lock as the mutex is released instead of waking up only to contend for it.
+        ///        Waiters with a predicate are not morphed, their predicate has to run under the lock first.
+        /// @return False if the waiter must be notified through on_notify() instead.
+        virtual auto try_morph() -> bool { return false; }
+
+        /// @brief Queues the waiter's coroutine on its mutex.
+        /// @return True if the lock was acquired immediately, the caller resumes the waiter.
+        auto relock() -> bool;
     };
 
     struct awaiter : public awaiter_base
@@ -76,6 +96,7 @@ private:
         auto await_resume() noexcept {}
 
         auto on_notify() -> coro::task<notify_status_t> override;
+        auto try_morph() -> bool override;
     };
 
     struct awaiter_with_predicate : public awaiter_base
@@ -137,209 +158,82 @@ private:
 
 #ifdef LIBCORO_FEATURE_NETWORKING
 
-    /// @brief This structure encapsulates the data from the controller task.
-    struct controller_data
-    {
-        controller_data(
-            std::optional<std::cv_status>& status,
-            bool& predicate_result,
-            std::optional<predicate_type> predicate,
-            std::optional<const std::stop_token> stop_token
-        ) noexcept;
-        ~controller_data() = default;
-
-        controller_data(const controller_data&) = delete;
-        controller_data(controller_data&&) = delete;
-        auto operator=(const controller_data&) -> controller_data& = delete;
-        auto operator=(controller_data&&) -> controller_data& = delete;
-
-        /// @brief Mutex for notify or timeout mutual exclusion.
-        coro::mutex m_event_mutex{};
-        /// @brief Event to notify the no timeout task.
-        coro::event m_notify_callback{};
-        /// @brief Flag to notify if the awaiter has completed via no_timeout or timeout.
-        std::atomic<bool> m_awaiter_completed{false};
-        /// @brief The status of the wait() call, this is _ONLY_ valid if the m_awaiter_completed flag was obtained, otherwise its a dangling reference.
-        std::optional<std::cv_status>& m_status;
-        /// @brief The last result of the predicate call.
-        bool& m_predicate_result;
-        /// @brief The predicate, this can be no predicate, default predicate or stop token predicate.
-        std::optional<predicate_type> m_predicate{std::nullopt};
-        /// @brief The stop token.
-        std::optional<const std::stop_token> m_stop_token{std::nullopt};
-    };
-
     /**
-     * @brief This awaiter is a facade to hook in between the wait_[for|unitl]() caller and the actual awaiter object.
-     * This allows the hook to either call the no_timeout or timeout results correctly based on which one completes first.
-     *
-     * This class mimics the awaiter_base class so it can silently sit in the coro:condition_variable.m_awaiters to look
-     * like its the actual awaiter, but just proxies to the real awaiter when appropriate.
-     *
-     * If the wait_[for|until] does timeout, then this will do nothing except delete itself from the list on a notify_[one|all] call.
+     * @brief The wait_[for|until]() awaiter.  Its timer is a node embedded in the awaiter and armed directly on the
+     *        io_scheduler, a timed wait costs no coroutine frames beyond the caller's.  Whichever of a notify or the
+     *        timer claims the waiter under the condition variable's m_awaiters_mutex resumes it, on a timeout the
+     *        waiter unlinks itself from the list.
      */
-    struct awaiter_with_wait_hook : public awaiter_base
-    {
-        awaiter_with_wait_hook(
-            coro::condition_variable& cv,
-            coro::scoped_lock& l,
-            controller_data& data
-        ) noexcept;
-        ~awaiter_with_wait_hook() override = default;
-
-        auto on_notify() -> coro::task<notify_status_t> override;
-
-        controller_data& m_data;
-    };
-
-    template<concepts::io_executor io_executor_type, typename return_type>
-    struct awaiter_with_wait : public awaiter_base
+    struct awaiter_with_wait_base : public awaiter_base
     {
-        awaiter_with_wait(
-            std::shared_ptr<io_executor_type> executor,
+        awaiter_with_wait_base(
+            std::shared_ptr<io_scheduler> scheduler,
             coro::condition_variable& cv,
             coro::scoped_lock& l,
             const std::chrono::nanoseconds wait_for,
             std::optional<predicate_type> predicate = std::nullopt,
             std::optional<std::stop_token> stop_token = std::nullopt
-        ) noexcept
-            : awaiter_base(cv, l),
-              m_executor(std::move(executor)),
-              m_wait_for(wait_for),
-              m_predicate(std::move(predicate)),
-              m_stop_token(std::move(stop_token))
-        { }
-        ~awaiter_with_wait() override = default;
-
-        awaiter_with_wait(const awaiter_with_wait&) = delete;
-        awaiter_with_wait(awaiter_with_wait&&) = delete;
-        auto operator=(const awaiter_with_wait&) -> awaiter_with_wait& = delete;
-        auto operator=(awaiter_with_wait&&) -> awaiter_with_wait& = delete;
-
-        /**
-         * @brief Task to handle the no_timeout case, however it is resumed even after a timeout since it needs to exit for the controller task.
-         *
-         * @param data The controller task's data.
-         * @return coro::task<void>
-         */
-        auto make_on_notify_callback_task(controller_data& data) -> coro::task<void>
-        {
-            co_await data.m_notify_callback;
-
-            // If this is the condition and not a timeout resume from this task.
-            if (m_status.value() == std::cv_status::no_timeout)
-            {
-                // The condition coroutine is resumed from here instead of the awaiter hook task to
-                // guarantee the controller is still alive until the caller's coroutine is completed.
-                m_awaiting_coroutine.resume();
-            }
+        ) noexcept;
+        ~awaiter_with_wait_base() override = default;
 
-            // This was a timeout, do nothing but exit to let the controller task know it can safely exit now.
-            co_return;
-        }
+        awaiter_with_wait_base(const awaiter_with_wait_base&) = delete;
+        awaiter_with_wait_base(awaiter_with_wait_base&&) = delete;
+        auto operator=(const awaiter_with_wait_base&) -> awaiter_with_wait_base& = delete;
+        auto operator=(awaiter_with_wait_base&&) -> awaiter_with_wait_base& = delete;
 
-        /**
-         * @brief Task to handle the timeout case, this will always wait the duration of the timeout before exiting.
-         *
-         * @param data The controller task data.
-         * @return coro::task<void>
-         */
-        auto make_timeout_task(controller_data& data) -> coro::task<void>
-        {
-            co_await m_executor->schedule_after(m_wait_for);
-            auto lock = co_await data.m_event_mutex.scoped_lock();
-            bool expected{false};
-            if (data.m_awaiter_completed.compare_exchange_strong(expected, true, std::memory_order::release, std::memory_order::relaxed))
-            {
-                m_status = {std::cv_status::timeout};
-                lock.unlock();
-
-                // This means the timeout has occurred first. Before resuming the wait_[for|until]() caller the lock must be re-acquired.
-                co_await m_lock.m_mutex->lock();
-                m_predicate_result = data.m_predicate.has_value() ? data.m_predicate.value()() : true;
-                m_awaiting_coroutine.resume();
-                co_return;
-            }
+        auto await_ready() noexcept -> bool;
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool;
 
-            // The no_timeout has occurred first, exit so the controller task can complete.
-            co_return;
-        }
+        auto on_notify() -> coro::task<notify_status_t> override;
+        auto try_morph() -> bool override;
 
-        /**
-         * @brief Task to manage the no_timeout and timeout tasks, this holds the state for both tasks since they need to reference the actual
-         *        wait_[for|until]() awaiter, but need to do so safely while it is still alive. To access the true awaiter the awaiter_completed
-         *        atomic bool must be acquired, if it is not acquired the calling awaiter is invalid since it has already been resumed with the first
-         *        event of timeout or no_timeout.
-         *
-         * @return coro::detail::task_self_deleting This task is self deleting since it has an indeterminate lifetime.
-         */
-        auto make_controller_task() -> coro::detail::task_self_deleting
-        {
-            controller_data data{m_status, m_predicate_result, std::move(m_predicate), std::move(m_stop_token)};
-            // We enqueue the hook_task since we can make it live until the notify occurs and will properly resume the actual coroutine only once.
-            awaiter_with_wait_hook hook_task{m_condition_variable, m_lock, data};
-            detail::awaiter_list_push(m_condition_variable.m_awaiters, static_cast<awaiter_base*>(&hook_task));
-            m_lock.m_mutex->unlock(); // Unlock the actual lock now that we are setup, not the fake hook task.
-
-            co_await coro::when_all(make_on_notify_callback_task(data), make_timeout_task(data));
-            co_return;
-        }
+        /// @brief Run on the event loop thread when the timer expires, see detail::poll_info::m_on_timeout.
+        static auto on_timeout(detail::poll_info& pi) -> bool;
 
-        auto await_ready() noexcept -> bool
+        struct timer_node : public detail::poll_info
         {
-            // If there is no predicate then we are not ready.
-            if (!m_predicate.has_value())
-            {
-                return false;
-            }
+            awaiter_with_wait_base* m_awaiter{nullptr};
+        };
 
-            m_predicate_result = m_predicate.value()();
-            if (m_predicate_result && m_stop_token.has_value() && m_stop_token.value().stop_requested())
-            {
-                m_status = std::cv_status::no_timeout;
-            }
-            return m_predicate_result;
-        }
-
-        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
-        {
-            m_awaiting_coroutine = awaiting_coroutine; // This is the real coroutine to resume.
+        /// @brief The io_scheduler the timer is armed on.
+        std::shared_ptr<io_scheduler> m_scheduler{nullptr};
+        /// @brief The amount of time to wait for before timing out.
+        const std::chrono::nanoseconds m_wait_for;
+        /// @brief The predicate, this can be no predicate, default predicate or stop token predicate.
+        std::optional<predicate_type> m_predicate{std::nullopt};
+        /// @brief The stop token.
+        std::optional<const std::stop_token> m_stop_token{std::nullopt};
+        /// @brief The last m_predicate() call result.
+        bool m_predicate_result{false};
+        /// @brief Guarded by m_awaiters_mutex, set when a notify claims the waiter after the timer has expired,
+        ///        the timer's callback resumes the waiter.
+        bool m_notified{false};
+        /// @brief The timer, its callback is on_timeout().
+        timer_node m_timer{};
+    };
 
-            // Make the background controller which proxies between the notify task and the timeout task.
-            auto controller = make_controller_task();
-            controller.resume();
-            return true;
-        }
+    template<typename return_type>
+    struct awaiter_with_wait : public awaiter_with_wait_base
+    {
+        using awaiter_with_wait_base::awaiter_with_wait_base;
 
         auto await_resume() noexcept -> return_type
         {
+            // A timeout resumes with the lock re-acquired but the predicate unchecked.
+            if (m_expired && m_predicate.has_value())
+            {
+                m_predicate_result = m_predicate.value()();
+            }
+
             if constexpr (std::is_same_v<return_type, bool>)
             {
                 return m_predicate_result;
             }
             else
             {
-                return m_status.value();
+                return m_expired ? std::cv_status::timeout : std::cv_status::no_timeout;
             }
         }
-
-        auto on_notify() -> coro::task<notify_status_t> override
-        {
-            throw std::runtime_error("should never be called");
-        }
-
-        /// @brief The io_executor used to wait for the timeout.
-        std::shared_ptr<io_executor_type> m_executor{nullptr};
-        /// @brief The amount of time to wait for before timing out.
-        const std::chrono::nanoseconds m_wait_for;
-        /// @brief If the condition timed out or not.
-        std::optional<std::cv_status> m_status{std::nullopt};
-        /// @brief The last m_predicate() call result.
-        bool m_predicate_result{false};
-        /// @brief The predicate, this can be no predicate, default predicate or stop token predicate. This value is only valid until the awaiter data object takes ownership.
-        std::optional<predicate_type> m_predicate{std::nullopt};
-        /// @brief The stop token. This value is only valid until the awater data object takes onwership.
-        std::optional<const std::stop_token> m_stop_token{std::nullopt};
     };
 
 #endif
@@ -371,7 +265,10 @@ public:
     }
 
     /**
-     * @brief Notifies all waiters.
+     * @brief Notifies all waiters.  Waiters without a predicate are moved straight onto their mutex's waiter list
+     *        and resumed one at a time holding the lock as it is released, rather than all waking up to contend for
+     *        it.  Each is resumed by the unlock that hands it the lock, so a long chain of waiters nests that deep
+     *        on the stack unless the mutex was given an executor to resume them on.
      */
     auto notify_all() -> coro::task<void>;
 
@@ -388,20 +285,13 @@ public:
     template<coro::concepts::executor executor_type>
     auto notify_all(std::shared_ptr<executor_type> executor) -> void
     {
-        auto* waiter = detail::awaiter_list_pop_all(m_awaiters);
-        awaiter_base* next;
-
-        while (waiter != nullptr)
+        auto epoch = notify_epoch();
+        while (auto* waiter = dequeue(epoch))
         {
-            // Need to grab next before notifying since the notifier will self destruct after completing.
-            next = waiter->m_next;
             // This will kick off each task in parallel on the scheduler, they will fight over the lock
             // but will give the best parallelism scheduling them immediately.
             executor->spawn(make_notify_all_executor_individual_task(waiter));
-            waiter = next;
         }
-
-        return;
     }
 
 
@@ -450,9 +340,9 @@ public:
         std::shared_ptr<io_executor_type> executor,
         coro::scoped_lock& lock,
         const std::chrono::duration<rep_type, period_type> wait_for
-    ) -> awaiter_with_wait<io_executor_type, std::cv_status>
+    ) -> awaiter_with_wait<std::cv_status>
     {
-        return awaiter_with_wait<io_executor_type, std::cv_status>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for)};
+        return awaiter_with_wait<std::cv_status>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for)};
     }
 
     template<concepts::io_executor io_executor_type, class rep_type, class period_type>
@@ -461,9 +351,9 @@ public:
         coro::scoped_lock& lock,
         const std::chrono::duration<rep_type, period_type> wait_for,
         predicate_type predicate
-    ) -> awaiter_with_wait<io_executor_type, bool>
+    ) -> awaiter_with_wait<bool>
     {
-        return awaiter_with_wait<io_executor_type, bool>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for), std::move(predicate)};
+        return awaiter_with_wait<bool>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for), std::move(predicate)};
     }
 
     template<concepts::io_executor io_executor_type, class rep_type, class period_type>
@@ -473,9 +363,9 @@ public:
         std::stop_token stop_token,
         const std::chrono::duration<rep_type, period_type> wait_for,
         predicate_type predicate
-    ) -> awaiter_with_wait<io_executor_type, bool>
+    ) -> awaiter_with_wait<bool>
     {
-        return awaiter_with_wait<io_executor_type, bool>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for), std::move(predicate), std::move(stop_token)};
+        return awaiter_with_wait<bool>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for), std::move(predicate), std::move(stop_token)};
     }
 
     template<concepts::io_executor io_executor_type, class clock_type, class duration_type>
@@ -483,11 +373,11 @@ public:
         std::shared_ptr<io_executor_type> executor,
         coro::scoped_lock& lock,
         const std::chrono::time_point<clock_type, duration_type> wait_until_time
-    ) -> awaiter_with_wait<io_executor_type, std::cv_status>
+    ) -> awaiter_with_wait<std::cv_status>
     {
         auto now = std::chrono::time_point<clock_type, duration_type>::clock::now();
         auto wait_for = (now < wait_until_time) ? (wait_until_time - now) : std::chrono::nanoseconds{1};
-        return awaiter_with_wait<io_executor_type, std::cv_status>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for)};
+        return awaiter_with_wait<std::cv_status>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for)};
     }
 
     template<concepts::io_executor io_executor_type, class clock_type, class duration_type>
@@ -496,11 +386,11 @@ public:
         coro::scoped_lock& lock,
         const std::chrono::time_point<clock_type, duration_type> wait_until_time,
         predicate_type predicate
-    ) -> awaiter_with_wait<io_executor_type, bool>
+    ) -> awaiter_with_wait<bool>
     {
         auto now = std::chrono::time_point<clock_type, duration_type>::clock::now();
         auto wait_for = (now < wait_until_time) ? (wait_until_time - now) : std::chrono::nanoseconds{1};
-        return awaiter_with_wait<io_executor_type, bool>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for), std::move(predicate)};
+        return awaiter_with_wait<bool>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for), std::move(predicate)};
     }
 
     template<concepts::io_executor io_executor_type, class clock_type, class duration_type>
@@ -510,31 +400,37 @@ public:
         std::stop_token stop_token,
         const std::chrono::time_point<clock_type, duration_type> wait_until_time,
         predicate_type predicate
-    ) -> awaiter_with_wait<io_executor_type, bool>
+    ) -> awaiter_with_wait<bool>
     {
         auto now = std::chrono::time_point<clock_type, duration_type>::clock::now();
         auto wait_for = (now < wait_until_time) ? (wait_until_time - now) : std::chrono::nanoseconds{1};
-        return awaiter_with_wait<io_executor_type, bool>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for), std::move(predicate), std::move(stop_token)};
+        return awaiter_with_wait<bool>{std::move(executor), *this, lock, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_for), std::move(predicate), std::move(stop_token)};
     }
 #endif
 
 private:
-    /// @brief The list of waiters.
-    std::atomic<awaiter_base*> m_awaiters{nullptr};
+    /// @brief Guards the list of waiters and each waiter's claim state, it is never held across a resume.
+    std::mutex m_awaiters_mutex{};
+    /// @brief The list of waiters in the order they started waiting.
+    awaiter_base* m_awaiters{nullptr};
+    awaiter_base* m_awaiters_tail{nullptr};
+    /// @brief The epoch stamped on the next waiter enqueued.
+    std::uint64_t m_next_epoch{0};
+
+    /// @brief Appends the waiter, the caller holds m_awaiters_mutex.
+    auto link(awaiter_base* waiter) -> void;
+    /// @brief Removes the waiter, the caller holds m_awaiters_mutex.
+    auto unlink(awaiter_base* waiter) -> void;
+    auto enqueue(awaiter_base* waiter) -> void;
+    /// @return The oldest waiter if it was enqueued before the epoch, otherwise nullptr.
+    auto dequeue(std::uint64_t before_epoch = std::numeric_limits<std::uint64_t>::max()) -> awaiter_base*;
+    /// @return The epoch for a notify_all(), the waiters enqueued after it are left waiting.
+    auto notify_epoch() -> std::uint64_t;
 
     auto make_notify_all_executor_individual_task(awaiter_base* waiter) -> coro::task<void>
     {
-        switch (co_await waiter->on_notify())
-        {
-            case notify_status_t::not_ready:
-                // Re-enqueue since the predicate isn't ready and return since the notify has been satisfied.
-                detail::awaiter_list_push(m_awaiters, waiter);
-                break;
-            case notify_status_t::ready:
-            case notify_status_t::awaiter_dead:
-                // Don't re-enqueue any awaiters that are ready or dead.
-                break;
-        }
+        // A waiter that is not ready re-enqueues itself.
+        co_await waiter->on_notify();
     }
 };
 
@@ -27,20 +27,31 @@
     #include "coro/net/send_status.hpp"
     #include "coro/net/socket.hpp"
     #include "coro/net/udp/peer.hpp"
+    #include "coro/periodic_timer.hpp"
+    #if defined(CORO_PLATFORM_UNIX)
+        #include "coro/file.hpp"
+    #endif
 #endif
 
+#include "coro/async_generator.hpp"
+#include "coro/async_stack.hpp"
 #include "coro/condition_variable.hpp"
 #include "coro/event.hpp"
 #include "coro/default_executor.hpp"
+#include "coro/eager_task.hpp"
+#include "coro/frame_allocator.hpp"
 #include "coro/generator.hpp"
 #include "coro/latch.hpp"
 #include "coro/mutex.hpp"
+#include "coro/parallel.hpp"
 #include "coro/queue.hpp"
 #include "coro/ring_buffer.hpp"
 #include "coro/semaphore.hpp"
 #include "coro/shared_mutex.hpp"
 #include "coro/sync_wait.hpp"
 #include "coro/task.hpp"
+#include "coro/task_group.hpp"
+#include "coro/task_local.hpp"
 #include "coro/thread_pool.hpp"
 #include "coro/time.hpp"
 #include "coro/when_all.hpp"
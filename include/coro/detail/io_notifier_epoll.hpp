@@ -26,6 +26,9 @@ class io_notifier_epoll
 {
     static const constexpr std::size_t m_max_events = 16;
     fd_t                               m_fd;
+    /// Cleared if the running kernel does not implement epoll_pwait2(), waits then fall back to
+    /// the millisecond resolution epoll_wait().
+    bool m_epoll_pwait2_supported{true};
 
     friend class detail::timer_handle;
 
@@ -52,7 +55,7 @@ public:
     auto unwatch_timer(const detail::timer_handle& timer) -> bool;
 
     auto next_events(
-        std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
+        std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::nanoseconds timeout)
         -> void;
 
     static auto event_to_poll_status(const event_t& event) -> poll_status;
@@ -38,7 +38,7 @@ public:
 
     auto next_events(
         std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events,
-        std::chrono::milliseconds                                      timeout) -> void;
+        std::chrono::nanoseconds                                       timeout) -> void;
 
     // static auto event_to_poll_status(const event_t& event) -> poll_status;
 
@@ -49,7 +49,7 @@ public:
     auto unwatch_timer(const detail::timer_handle& timer) -> bool;
 
     auto next_events(
-        std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
+        std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::nanoseconds timeout)
         -> void;
 
     static auto event_to_poll_status(const event_t& event) -> poll_status;
@@ -32,7 +32,7 @@ auto perform_write_read_operation(
     SOCKET                               socket,
     operation_fn&&                       operation,
     buffer_type                          buffer,
-    std::chrono::milliseconds            timeout) -> task<std::pair<status_enum, buffer_type>>
+    std::chrono::nanoseconds             timeout) -> task<std::pair<status_enum, buffer_type>>
 {
     overlapped_io_operation ov{};
     WSABUF                  buf{};
@@ -3,6 +3,7 @@
 #include "coro/fd.hpp"
 #include "coro/time.hpp"
 #include "coro/poll.hpp"
+#include "coro/thread_pool.hpp"
 
 #include <atomic>
 #include <coroutine>
@@ -47,6 +48,7 @@ struct poll_info
         auto await_ready() const noexcept -> bool { return false; }
         auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> void
         {
+            m_pi.record_worker();
             m_pi.m_awaiting_coroutine = awaiting_coroutine;
             std::atomic_thread_fence(std::memory_order::release);
         }
@@ -57,6 +59,17 @@ struct poll_info
 
     auto operator co_await() noexcept -> poll_awaiter { return poll_awaiter{*this}; }
 
+    /**
+     * Records the executor thread the awaiting coroutine is suspending on, so the event loop can resume
+     * it on the same thread while its working set is still in that thread's cache.  This must be called
+     * before the awaiting coroutine is set.
+     */
+    auto record_worker() noexcept -> void
+    {
+        m_thread_pool = thread_pool::current();
+        m_worker      = thread_pool::current_worker();
+    }
+
 #if defined(CORO_PLATFORM_UNIX)
     /// The file descriptor being polled on.  This is needed so that if the timeout occurs first then
     /// the event loop can immediately disable the event within epoll.
@@ -75,6 +88,13 @@ struct poll_info
     /// Did the timeout and event trigger at the same time on the same epoll_wait call?
     /// Once this is set to true all future events on this poll info are null and void.
     bool m_processed{false};
+    /// The thread pool the awaiting coroutine suspended on, nullptr if it was not on a thread pool.
+    thread_pool* m_thread_pool{nullptr};
+    /// The executor thread within m_thread_pool the awaiting coroutine suspended on.
+    std::size_t m_worker{thread_pool::no_worker};
+    /// Run by the event loop in place of resuming the awaiting coroutine when a timer armed with
+    /// io_scheduler::add_timer_callback() expires, the coroutine is only resumed if this returns true.
+    bool (*m_on_timeout)(poll_info& pi){nullptr};
 };
 
 } // namespace coro::detail
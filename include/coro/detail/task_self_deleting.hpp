@@ -11,7 +11,7 @@ namespace coro::detail
 
 class task_self_deleting;
 
-class promise_self_deleting
+class promise_self_deleting : public pooled_frame
 {
 public:
     promise_self_deleting();
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "coro/frame_allocator.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace coro
+{
+template<typename return_type = void>
+class eager_task;
+
+namespace detail
+{
+struct eager_promise_base : public pooled_frame
+{
+    /// The state while the task is running and nobody has awaited it yet.
+    static constexpr void* running = nullptr;
+
+    struct final_awaitable
+    {
+        auto await_ready() const noexcept -> bool { return false; }
+
+        template<typename promise_type>
+        auto await_suspend(std::coroutine_handle<promise_type> coroutine) noexcept -> std::coroutine_handle<>
+        {
+            // Publish completion, if an awaiter attached while the task was suspended resume it.
+            eager_promise_base& promise = coroutine.promise();
+            auto*               state   = promise.m_state.exchange(promise.completed(), std::memory_order::acq_rel);
+            if (state != running)
+            {
+                return std::coroutine_handle<>::from_address(state);
+            }
+            return std::noop_coroutine();
+        }
+
+        auto await_resume() noexcept -> void {}
+    };
+
+    eager_promise_base() noexcept = default;
+    ~eager_promise_base()         = default;
+
+    /// The body runs immediately, up to its first real suspension, inside the call that created it.
+    auto initial_suspend() noexcept { return std::suspend_never{}; }
+
+    auto final_suspend() noexcept { return final_awaitable{}; }
+
+    /**
+     * Attaches the awaiting coroutine, only needed when the task suspended before completing.
+     * @return False if the task completed in the meantime and the awaiter should not suspend.
+     */
+    auto try_set_continuation(std::coroutine_handle<> continuation) noexcept -> bool
+    {
+        void* expected = running;
+        return m_state.compare_exchange_strong(
+            expected, continuation.address(), std::memory_order::acq_rel, std::memory_order::acquire);
+    }
+
+    /**
+     * @return True once the task has completed, from any thread.
+     */
+    auto is_complete() const noexcept -> bool
+    {
+        return m_state.load(std::memory_order::acquire) == completed();
+    }
+
+protected:
+    /// The state once the task has completed, the promise's own address can never be a continuation.
+    auto completed() const noexcept -> void* { return const_cast<eager_promise_base*>(this); }
+
+    /// nullptr while running, the awaiting coroutine's address once awaited, this promise once complete.
+    std::atomic<void*> m_state{running};
+};
+
+template<typename return_type>
+struct eager_promise final : public eager_promise_base
+{
+private:
+    struct unset_return_value
+    {
+    };
+
+public:
+    static constexpr bool return_type_is_reference = std::is_reference_v<return_type>;
+    using stored_type                              = std::conditional_t<
+        return_type_is_reference,
+        std::remove_reference_t<return_type>*,
+        std::remove_const_t<return_type>>;
+    using variant_type = std::variant<unset_return_value, stored_type, std::exception_ptr>;
+
+    eager_promise() noexcept = default;
+
+    auto get_return_object() noexcept -> eager_task<return_type>;
+
+    template<typename value_type>
+    requires(return_type_is_reference and std::is_constructible_v<return_type, value_type&&>) or
+        (not return_type_is_reference and
+         std::is_constructible_v<stored_type, value_type&&>) auto return_value(value_type&& value) -> void
+    {
+        if constexpr (return_type_is_reference)
+        {
+            return_type ref = static_cast<value_type&&>(value);
+            m_storage.template emplace<stored_type>(std::addressof(ref));
+        }
+        else
+        {
+            m_storage.template emplace<stored_type>(std::forward<value_type>(value));
+        }
+    }
+
+    auto unhandled_exception() noexcept -> void
+    {
+        m_storage.template emplace<std::exception_ptr>(std::current_exception());
+    }
+
+    auto result() & -> decltype(auto)
+    {
+        rethrow_if_unset_or_exception();
+        if constexpr (return_type_is_reference)
+        {
+            return static_cast<return_type>(*std::get<stored_type>(m_storage));
+        }
+        else
+        {
+            return static_cast<const return_type&>(std::get<stored_type>(m_storage));
+        }
+    }
+
+    auto result() && -> decltype(auto)
+    {
+        rethrow_if_unset_or_exception();
+        if constexpr (return_type_is_reference)
+        {
+            return static_cast<return_type>(*std::get<stored_type>(m_storage));
+        }
+        else
+        {
+            return static_cast<return_type&&>(std::get<stored_type>(m_storage));
+        }
+    }
+
+private:
+    auto rethrow_if_unset_or_exception() -> void
+    {
+        if (std::holds_alternative<std::exception_ptr>(m_storage))
+        {
+            std::rethrow_exception(std::get<std::exception_ptr>(m_storage));
+        }
+        else if (std::holds_alternative<unset_return_value>(m_storage))
+        {
+            throw std::runtime_error{"The return value was never set, did the eager_task complete?"};
+        }
+    }
+
+    variant_type m_storage{};
+};
+
+template<>
+struct eager_promise<void> final : public eager_promise_base
+{
+    eager_promise() noexcept = default;
+
+    auto get_return_object() noexcept -> eager_task<void>;
+
+    auto return_void() noexcept -> void {}
+
+    auto unhandled_exception() noexcept -> void { m_exception_ptr = std::current_exception(); }
+
+    auto result() -> void
+    {
+        if (m_exception_ptr)
+        {
+            std::rethrow_exception(m_exception_ptr);
+        }
+    }
+
+private:
+    std::exception_ptr m_exception_ptr{nullptr};
+};
+
+} // namespace detail
+
+/**
+ * A task that starts executing as soon as it is called rather than when it is awaited.  The coroutine
+ * runs synchronously up to its first real suspension point, if it never suspends (a cache hit, data that
+ * is already buffered) it has completed by the time the caller receives the eager_task and awaiting it
+ * resumes nothing and never suspends the awaiter, which makes the fast path about as cheap as a function
+ * call that returns through a pooled frame.
+ *
+ * If the coroutine does suspend, e.g. on io, it may complete on another thread concurrently with being
+ * awaited, the hand off between completion and the awaiter is a single atomic exchange.
+ *
+ * Unlike coro::task the coroutine is already running, an eager_task that suspended must be awaited, or
+ * otherwise be complete, before it is destroyed.
+ */
+template<typename return_type>
+class [[nodiscard]] eager_task
+{
+public:
+    using task_type        = eager_task<return_type>;
+    using promise_type     = detail::eager_promise<return_type>;
+    using coroutine_handle = std::coroutine_handle<promise_type>;
+
+    struct awaitable_base
+    {
+        awaitable_base(coroutine_handle coroutine) noexcept : m_coroutine(coroutine) {}
+
+        /// The synchronous fast path, a completed task is never suspended on.
+        auto await_ready() const noexcept -> bool { return !m_coroutine || m_coroutine.promise().is_complete(); }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            return m_coroutine.promise().try_set_continuation(awaiting_coroutine);
+        }
+
+        std::coroutine_handle<promise_type> m_coroutine{nullptr};
+    };
+
+    eager_task() noexcept : m_coroutine(nullptr) {}
+
+    explicit eager_task(coroutine_handle handle) : m_coroutine(handle) {}
+    eager_task(const eager_task&) = delete;
+    eager_task(eager_task&& other) noexcept : m_coroutine(std::exchange(other.m_coroutine, nullptr)) {}
+
+    ~eager_task()
+    {
+        if (m_coroutine != nullptr)
+        {
+            m_coroutine.destroy();
+        }
+    }
+
+    auto operator=(const eager_task&) -> eager_task& = delete;
+
+    auto operator=(eager_task&& other) noexcept -> eager_task&
+    {
+        if (std::addressof(other) != this)
+        {
+            if (m_coroutine != nullptr)
+            {
+                m_coroutine.destroy();
+            }
+
+            m_coroutine = std::exchange(other.m_coroutine, nullptr);
+        }
+
+        return *this;
+    }
+
+    /**
+     * @return True if the task has completed or if the task has been destroyed.
+     */
+    auto is_ready() const noexcept -> bool { return m_coroutine == nullptr || m_coroutine.promise().is_complete(); }
+
+    auto operator co_await() const& noexcept
+    {
+        struct awaitable : public awaitable_base
+        {
+            auto await_resume() -> decltype(auto) { return this->m_coroutine.promise().result(); }
+        };
+
+        return awaitable{m_coroutine};
+    }
+
+    auto operator co_await() const&& noexcept
+    {
+        struct awaitable : public awaitable_base
+        {
+            auto await_resume() -> decltype(auto) { return std::move(this->m_coroutine.promise()).result(); }
+        };
+
+        return awaitable{m_coroutine};
+    }
+
+    auto promise() & -> promise_type& { return m_coroutine.promise(); }
+    auto promise() const& -> const promise_type& { return m_coroutine.promise(); }
+    auto promise() && -> promise_type&& { return std::move(m_coroutine.promise()); }
+
+    auto handle() -> coroutine_handle { return m_coroutine; }
+
+private:
+    coroutine_handle m_coroutine{nullptr};
+};
+
+namespace detail
+{
+template<typename return_type>
+inline auto eager_promise<return_type>::get_return_object() noexcept -> eager_task<return_type>
+{
+    return eager_task<return_type>{std::coroutine_handle<eager_promise<return_type>>::from_promise(*this)};
+}
+
+inline auto eager_promise<void>::get_return_object() noexcept -> eager_task<>
+{
+    return eager_task<>{std::coroutine_handle<eager_promise<void>>::from_promise(*this)};
+}
+
+} // namespace detail
+
+} // namespace coro
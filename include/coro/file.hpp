@@ -0,0 +1,139 @@
+#pragma once
+
+#include "coro/io_scheduler.hpp"
+#include "coro/task.hpp"
+#include "coro/thread_pool.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+
+namespace coro
+{
+enum class file_status
+{
+    /// The operation completed in full.
+    ok,
+    /// A read reached the end of the file before the buffer was filled.
+    end_of_file,
+    /// The operation failed, the file's last_error() holds the errno.
+    error
+};
+
+auto to_string(file_status status) -> const std::string&;
+
+/**
+ * An open file whose reads, writes and syncs do not block the io_scheduler.  Regular files are
+ * always 'ready' to an epoll/kqueue reactor so the blocking system call is instead performed on a
+ * bounded helper thread pool, the awaiting coroutine is then resumed back on the io scheduler. The
+ * helper pool's thread count bounds how many file operations are in flight at once, it can be shared
+ * between many files.
+ *
+ * On linux reads first attempt a non-blocking preadv2(RWF_NOWAIT), if the data is already in the page
+ * cache the read completes without leaving the io scheduler.
+ *
+ * Offsets are explicit so operations on the same file do not share a cursor, multiple read_at() and
+ * write_at() calls may be in flight concurrently.
+ */
+class file
+{
+public:
+    enum class open_mode
+    {
+        /// Open an existing file for reading.
+        read,
+        /// Open for writing, the file is created if it does not exist.
+        write,
+        /// Open for writing, the file is created if it does not exist and truncated if it does.
+        write_truncate,
+        /// Open for reading and writing, the file is created if it does not exist.
+        read_write
+    };
+
+    /**
+     * Opens the file at the given path, the open itself is a blocking system call.
+     * @param scheduler The io scheduler awaiting coroutines are resumed on.
+     * @param helper The thread pool that performs the blocking file system calls.
+     * @param path The path of the file to open.
+     * @param mode How to open the file.
+     * @param permissions The permissions of the file if it is created.
+     * @throw std::runtime_error If the file cannot be opened.
+     */
+    file(
+        std::shared_ptr<io_scheduler> scheduler,
+        std::shared_ptr<thread_pool>  helper,
+        const std::filesystem::path&  path,
+        open_mode                     mode,
+        int                           permissions = 0644);
+
+    /**
+     * Takes ownership of an already opened file descriptor.
+     */
+    file(std::shared_ptr<io_scheduler> scheduler, std::shared_ptr<thread_pool> helper, fd_t fd);
+
+    file(const file&) = delete;
+    file(file&& other) noexcept;
+    auto operator=(const file&) -> file& = delete;
+    auto operator=(file&& other) noexcept -> file&;
+    ~file();
+
+    /**
+     * @return The file descriptor of the open file, -1 if closed.
+     */
+    auto native_handle() const -> fd_t { return m_fd; }
+
+    /**
+     * @return True if the file is open.
+     */
+    auto is_open() const -> bool { return m_fd != -1; }
+
+    /**
+     * @return The errno of the last failed operation on this file, zero if none have failed.
+     */
+    auto last_error() const -> int { return m_last_error.load(std::memory_order::acquire); }
+
+    /**
+     * Reads from the file at the given offset until the buffer is full or the end of the file is reached.
+     * @param buffer The buffer to read into.
+     * @param offset The offset in the file to start reading at.
+     * @return The status of the read and the span of the buffer that was filled.
+     */
+    auto read_at(std::span<char> buffer, uint64_t offset) -> coro::task<std::pair<file_status, std::span<char>>>;
+
+    /**
+     * Writes the entire buffer to the file at the given offset.
+     * @param buffer The data to write.
+     * @param offset The offset in the file to start writing at.
+     * @return The status of the write and the span of the buffer that was not written, empty on success.
+     */
+    auto write_at(std::span<const char> buffer, uint64_t offset)
+        -> coro::task<std::pair<file_status, std::span<const char>>>;
+
+    /**
+     * Flushes the file's data to the storage device.
+     * @param data_only If true only the data and the metadata required to read it back are flushed (fdatasync).
+     * @return The status of the sync.
+     */
+    auto fsync(bool data_only = false) -> coro::task<file_status>;
+
+    /**
+     * Closes the file, this happens automatically upon destruction.
+     */
+    auto close() -> void;
+
+private:
+    /// The scheduler that completed operations resume on.
+    std::shared_ptr<io_scheduler> m_io_scheduler{nullptr};
+    /// The helper threads that perform the blocking system calls.
+    std::shared_ptr<thread_pool> m_helper{nullptr};
+    /// The open file descriptor.
+    fd_t m_fd{-1};
+    /// The errno of the last failed operation.
+    std::atomic<int> m_last_error{0};
+};
+
+} // namespace coro
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "coro/attribute.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace coro
+{
+/**
+ * The frame allocator pools coroutine frame allocations in thread local caches of fixed size classes.
+ * Coroutine frames are allocated and freed at a very high rate and are almost always one of a handful
+ * of sizes, so a freed frame is kept on the freeing thread's freelist for its size class and handed
+ * straight back out to the next coroutine of a similar size without touching the global allocator.
+ *
+ * A frame freed on a different thread than it was allocated on is returned to its owning thread in
+ * batches, the owning thread reclaims them the next time its freelist for that size class is empty.
+ * Each thread caches at most max_cached_bytes, frames larger than max_pooled_size always go straight
+ * to the global allocator.
+ *
+ * The coroutine promises in libcoro (task, generator, sync_wait, when_all and the self deleting task
+ * wrappers) allocate through this when LIBCORO_FEATURE_FRAME_POOL is enabled, which is the default,
+ * unless the coroutine was given its own allocator, see detail::pooled_frame.
+ */
+class frame_allocator
+{
+public:
+    struct statistics
+    {
+        /// The number of allocations served from a thread's cache.
+        uint64_t hits{0};
+        /// The number of allocations that had to go to the global allocator.
+        uint64_t misses{0};
+        /// The number of frames freed on a different thread than they were allocated on.
+        uint64_t remote_frees{0};
+        /// The number of bytes currently sitting in the thread caches waiting to be reused.
+        uint64_t bytes_cached{0};
+    };
+
+    /// Allocations are rounded up to a multiple of this size to pick their size class.
+    static constexpr std::size_t size_class_granularity{64};
+    /// Allocations larger than this, including the allocator's bookkeeping, are not pooled.
+    static constexpr std::size_t max_pooled_size{2048};
+    /// The number of size classes.
+    static constexpr std::size_t size_class_count{max_pooled_size / size_class_granularity};
+    /// The maximum number of bytes each thread keeps cached, frees beyond this go to the global allocator.
+    static constexpr std::size_t max_cached_bytes{1024 * 1024};
+    /// The number of frames freed to another thread that are batched up before being handed over.
+    static constexpr std::size_t remote_batch_size{32};
+
+    /**
+     * @param size The number of bytes to allocate.
+     * @return The allocated memory, aligned to __STDCPP_DEFAULT_NEW_ALIGNMENT__.
+     * @throw std::bad_alloc If the global allocator fails.
+     */
+    static auto allocate(std::size_t size) -> void*;
+
+    /**
+     * @param ptr Memory returned from allocate().
+     * @param size The size given to allocate().
+     */
+    static auto deallocate(void* ptr, std::size_t size) noexcept -> void;
+
+    /**
+     * @return The counters summed over every thread that has used the frame allocator.
+     */
+    static auto stats() -> statistics;
+
+    /**
+     * Returns the calling thread's cached frames to the global allocator and hands any batched up frames
+     * that belong to other threads back to them.
+     */
+    static auto trim() noexcept -> void;
+};
+
+namespace detail
+{
+/**
+ * Promise types inherit from this to control how their coroutine frames are allocated.  By default a
+ * frame comes from the frame_allocator, or the global allocator if LIBCORO_FEATURE_FRAME_POOL is off.
+ *
+ * A coroutine whose leading parameters are std::allocator_arg_t followed by an allocator, for member
+ * functions and lambdas after the object parameter, has its frame allocated from that allocator instead.
+ * A copy of the allocator rebound to an aligned block type is stored after the frame so the frame can
+ * be returned to it, this works with any standard allocator including std::pmr::polymorphic_allocator.
+ * std::allocator is treated as the default.
+ */
+struct pooled_frame
+{
+private:
+    using deallocate_fn = void (*)(void* frame, std::size_t size) noexcept;
+
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) block
+    {
+        std::byte m_bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+    };
+
+    template<typename alloc_type>
+    using block_allocator = typename std::allocator_traits<alloc_type>::template rebind_alloc<block>;
+
+    static constexpr auto align_up(std::size_t offset, std::size_t alignment) noexcept -> std::size_t
+    {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    /// The deallocate function is stored right after the frame, nullptr for the default allocation.
+    static constexpr auto deallocate_offset(std::size_t size) noexcept -> std::size_t
+    {
+        return align_up(size, alignof(deallocate_fn));
+    }
+
+    template<typename stored_type>
+    static constexpr auto allocator_offset(std::size_t size) noexcept -> std::size_t
+    {
+        return align_up(deallocate_offset(size) + sizeof(deallocate_fn), alignof(stored_type));
+    }
+
+    template<typename stored_type>
+    static constexpr auto block_count(std::size_t size) noexcept -> std::size_t
+    {
+        return (allocator_offset<stored_type>(size) + sizeof(stored_type) + sizeof(block) - 1) / sizeof(block);
+    }
+
+    template<typename alloc_type>
+    static auto allocate_with(std::size_t size, const alloc_type& alloc) -> void*
+    {
+        using stored_type = block_allocator<alloc_type>;
+        if constexpr (std::is_same_v<stored_type, std::allocator<block>>)
+        {
+            return pooled_frame::operator new(size);
+        }
+        else
+        {
+            static_assert(alignof(stored_type) <= alignof(block), "allocator is over aligned");
+
+            stored_type stored{alloc};
+            auto*       frame = reinterpret_cast<std::byte*>(
+                std::allocator_traits<stored_type>::allocate(stored, block_count<stored_type>(size)));
+            *reinterpret_cast<deallocate_fn*>(frame + deallocate_offset(size)) = &deallocate_with<stored_type>;
+            new (frame + allocator_offset<stored_type>(size)) stored_type{std::move(stored)};
+            return frame;
+        }
+    }
+
+    template<typename stored_type>
+    static auto deallocate_with(void* ptr, std::size_t size) noexcept -> void
+    {
+        auto* frame  = static_cast<std::byte*>(ptr);
+        auto* stored = std::launder(reinterpret_cast<stored_type*>(frame + allocator_offset<stored_type>(size)));
+
+        // Move the allocator off the frame before handing the frame's memory back to it.
+        stored_type alloc{std::move(*stored)};
+        stored->~stored_type();
+        std::allocator_traits<stored_type>::deallocate(
+            alloc, reinterpret_cast<block*>(frame), block_count<stored_type>(size));
+    }
+
+public:
+    static auto operator new(std::size_t size) -> void*
+    {
+        auto total = deallocate_offset(size) + sizeof(deallocate_fn);
+#ifdef LIBCORO_FEATURE_FRAME_POOL
+        auto* frame = static_cast<std::byte*>(frame_allocator::allocate(total));
+#else
+        auto* frame = static_cast<std::byte*>(::operator new(total));
+#endif
+        *reinterpret_cast<deallocate_fn*>(frame + deallocate_offset(size)) = nullptr;
+        return frame;
+    }
+
+    // Frames from these overloads are freed by the usual operator delete below as coroutines require
+    // ([dcl.fct.def.coroutine]/12).  g++ before 13 reports any templated operator new paired with a non-template
+    // operator delete as mismatched, forcing these inline leaves only the allocator's own allocation call behind.
+
+    /// Free functions, static member functions and lambdas without captures: (std::allocator_arg, alloc, args...).
+    template<typename alloc_type, typename... args_type>
+    __ATTRIBUTE__(always_inline) static auto
+        operator new(std::size_t size, std::allocator_arg_t, const alloc_type& alloc, const args_type&...) -> void*
+    {
+        return allocate_with(size, alloc);
+    }
+
+    /// Member functions and lambdas: (object, std::allocator_arg, alloc, args...).
+    template<typename object_type, typename alloc_type, typename... args_type>
+    __ATTRIBUTE__(always_inline) static auto operator new(
+        std::size_t size, const object_type&, std::allocator_arg_t, const alloc_type& alloc, const args_type&...)
+        -> void*
+    {
+        return allocate_with(size, alloc);
+    }
+
+    static auto operator delete(void* ptr, std::size_t size) noexcept -> void
+    {
+        auto offset     = deallocate_offset(size);
+        auto deallocate = *reinterpret_cast<deallocate_fn*>(static_cast<std::byte*>(ptr) + offset);
+        if (deallocate != nullptr)
+        {
+            deallocate(ptr, size);
+            return;
+        }
+
+#ifdef LIBCORO_FEATURE_FRAME_POOL
+        frame_allocator::deallocate(ptr, offset + sizeof(deallocate_fn));
+#else
+        ::operator delete(ptr);
+#endif
+    }
+};
+
+} // namespace detail
+} // namespace coro
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "coro/frame_allocator.hpp"
+
 #include <coroutine>
 #include <exception>
 #include <iterator>
@@ -13,7 +15,7 @@ class generator;
 namespace detail
 {
 template<typename T>
-class generator_promise
+class generator_promise : public pooled_frame
 {
 public:
     using value_type     = std::remove_reference_t<T>;
@@ -5,7 +5,9 @@
 #include "coro/expected.hpp"
 #include "coro/fd.hpp"
 #include "coro/io_notifier.hpp"
+#include "coro/periodic_timer.hpp"
 #include "coro/poll.hpp"
+#include "coro/task.hpp"
 #include "coro/thread_pool.hpp"
 #include "coro/platform.hpp"
 
@@ -19,16 +21,22 @@
 
 #include "coro/signal.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stop_token>
 #include <thread>
 #include <vector>
 
 namespace coro
 {
+class condition_variable;
+
 enum timeout_status
 {
     no_timeout,
@@ -47,6 +55,8 @@ class io_scheduler : public std::enable_shared_from_this<io_scheduler>
 public:
     class schedule_operation;
     friend schedule_operation;
+    friend periodic_timer;
+    friend condition_variable;
 
     enum class thread_strategy_t
     {
@@ -86,6 +96,51 @@ public:
         /// If inline task processing is enabled then the io worker will resume tasks on its thread
         /// rather than scheduling them to be picked up by the thread pool.
         execution_strategy_t execution_strategy{execution_strategy_t::process_tasks_on_thread_pool};
+
+        /// Timers are armed this much earlier than their deadline and the event loop busy waits the
+        /// remainder, trading io thread cpu time for sub-microsecond timer precision.  Zero disables
+        /// spinning and relies entirely on the kernel timer.
+        std::chrono::nanoseconds timer_spin{0};
+    };
+
+    /**
+     * A point in time snapshot of the event loop's counters, see io_scheduler::stats().  All counters
+     * are cumulative since the io_scheduler was created, diff two snapshots to get rates.
+     */
+    struct statistics
+    {
+        /// The number of times the event loop has waited for and processed events.
+        uint64_t loop_iterations{0};
+        /// The total time the event loop has spent blocked waiting for events.
+        std::chrono::nanoseconds time_blocked{0};
+        /// The total time the event loop has spent processing events and resuming handles.
+        std::chrono::nanoseconds time_processing{0};
+        /// The total number of events returned by the io notifier.
+        uint64_t events{0};
+        /// The largest number of events returned by a single loop iteration.
+        uint64_t max_events_per_iteration{0};
+        /// The number of timed events that have expired.
+        uint64_t timers_fired{0};
+        /// The total time expired timers were resumed past their deadline.
+        std::chrono::nanoseconds timer_lateness{0};
+        /// The largest time a single timer was resumed past its deadline.
+        std::chrono::nanoseconds max_timer_lateness{0};
+        /// The number of timed events currently registered, e.g. yield_for() or polls with a timeout.
+        std::size_t timed_events{0};
+        /// The number of handles the event loop resumed on its own thread.
+        uint64_t resumed_inline{0};
+        /// The number of handles the event loop handed off to the thread pool.
+        uint64_t resumed_offloaded{0};
+        /// The number of tasks currently waiting in the schedule queue to be executed.
+        std::size_t schedule_queue_depth{0};
+
+        /**
+         * @return The average number of events processed per loop iteration.
+         */
+        auto events_per_iteration() const noexcept -> double
+        {
+            return loop_iterations == 0 ? 0.0 : static_cast<double>(events) / static_cast<double>(loop_iterations);
+        }
     };
 
     /**
@@ -109,7 +164,8 @@ public:
                      ((std::thread::hardware_concurrency() > 1) ? (std::thread::hardware_concurrency() - 1) : 1),
                  .on_thread_start_functor = nullptr,
                  .on_thread_stop_functor  = nullptr},
-            .execution_strategy = execution_strategy_t::process_tasks_on_thread_pool}) -> std::shared_ptr<io_scheduler>;
+            .execution_strategy = execution_strategy_t::process_tasks_on_thread_pool,
+            .timer_spin         = std::chrono::nanoseconds{0}}) -> std::shared_ptr<io_scheduler>;
 
     io_scheduler(const io_scheduler&)                    = delete;
     io_scheduler(io_scheduler&&)                         = delete;
@@ -128,7 +184,7 @@ public:
      *                indefinitely until an event happens.
      * @param return The number of tasks currently executing or waiting to execute.
      */
-    auto process_events(std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> std::size_t;
+    auto process_events(std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0}) -> std::size_t;
 
     class schedule_operation
     {
@@ -212,6 +268,7 @@ public:
     /**
      * Schedules a task on the io_scheduler that must complete within the given timeout.
      * NOTE: This version of schedule does *NOT* cancel the given task, it will continue executing even if it times out.
+     *       The timeout is cancelled if the task completes first.
      *       It is absolutely recommended to use the version of this schedule() function that takes an std::stop_token
      * and have the scheduled task check to see if its been cancelled due to timeout to not waste resources.
      * @tparam return_type The return value of the task.
@@ -223,24 +280,8 @@ public:
     [[nodiscard]] auto schedule(coro::task<return_type> task, std::chrono::duration<rep, period> timeout)
         -> coro::task<coro::expected<return_type, timeout_status>>
     {
-        using namespace std::chrono_literals;
-
-        // If negative or 0 timeout, just schedule the task as normal.
-        auto timeout_ms = std::max(std::chrono::duration_cast<std::chrono::milliseconds>(timeout), 0ms);
-        if (timeout_ms == 0ms)
-        {
-            co_return coro::expected<return_type, timeout_status>(co_await schedule(std::move(task)));
-        }
-
-        auto result = co_await when_any(std::move(task), make_timeout_task(timeout_ms));
-        if (!std::holds_alternative<timeout_status>(result))
-        {
-            co_return coro::expected<return_type, timeout_status>(std::move(std::get<0>(result)));
-        }
-        else
-        {
-            co_return coro::unexpected<timeout_status>(std::move(std::get<1>(result)));
-        }
+        return schedule_with_timeout(
+            std::move(task), std::chrono::duration_cast<std::chrono::nanoseconds>(timeout), std::nullopt);
     }
 
 #ifndef EMSCRIPTEN
@@ -259,24 +300,8 @@ public:
         schedule(std::stop_source stop_source, coro::task<return_type> task, std::chrono::duration<rep, period> timeout)
             -> coro::task<coro::expected<return_type, timeout_status>>
     {
-        using namespace std::chrono_literals;
-
-        // If negative or 0 timeout, just schedule the task as normal.
-        auto timeout_ms = std::max(std::chrono::duration_cast<std::chrono::milliseconds>(timeout), 0ms);
-        if (timeout_ms == 0ms)
-        {
-            co_return coro::expected<return_type, timeout_status>(co_await schedule(std::move(task)));
-        }
-
-        auto result = co_await when_any(std::move(stop_source), std::move(task), make_timeout_task(timeout_ms));
-        if (!std::holds_alternative<timeout_status>(result))
-        {
-            co_return coro::expected<return_type, timeout_status>(std::move(std::get<0>(result)));
-        }
-        else
-        {
-            co_return coro::unexpected<timeout_status>(std::move(std::get<1>(result)));
-        }
+        return schedule_with_timeout(
+            std::move(task), std::chrono::duration_cast<std::chrono::nanoseconds>(timeout), std::move(stop_source));
     }
 #endif
 
@@ -321,17 +346,149 @@ public:
      */
     [[nodiscard]] auto yield_until(time_point time) -> coro::task<void>;
 
+    /**
+     * Creates a timer that ticks every period on this scheduler, the first tick is one period from now.
+     * The tick deadlines are fixed to the schedule so they do not drift, each co_await of the timer
+     * re-arms the same timer node without allocating.
+     * @param period The amount of time between ticks.
+     * @param policy What to do with ticks that are missed because the awaiting coroutine fell behind.
+     * @return The periodic timer to co_await for each tick.
+     */
+    [[nodiscard]] auto schedule_every(
+        std::chrono::nanoseconds period, missed_tick_policy policy = missed_tick_policy::skip) -> periodic_timer
+    {
+        return periodic_timer{shared_from_this(), period, policy};
+    }
+
 #if defined(CORO_PLATFORM_UNIX)
+    class poll_operation
+    {
+        friend class io_scheduler;
+        poll_operation(
+            io_scheduler&            scheduler,
+            fd_t                     fd,
+            coro::poll_op            op,
+            std::chrono::nanoseconds timeout,
+            std::stop_token          stop_token) noexcept
+            : m_scheduler(scheduler),
+              m_timeout(timeout),
+              m_stop_token(std::move(stop_token)),
+              m_pi(fd, op)
+        {
+        }
+
+        /// Invoked upon a stop request, hands the poll info to the event loop to be cancelled.
+        struct cancel_callback
+        {
+            poll_operation& m_operation;
+            auto            operator()() noexcept -> void;
+        };
+
+    public:
+        /**
+         * A poll operation can be moved up until it is co_await'ed, the embedded poll info is
+         * registered with the event loop upon suspending and must not move after that point.
+         */
+        poll_operation(poll_operation&& other) noexcept
+            : m_scheduler(other.m_scheduler),
+              m_timeout(other.m_timeout),
+              m_stop_token(std::move(other.m_stop_token)),
+              m_pi(other.m_pi.m_fd, other.m_pi.m_op)
+        {
+        }
+        poll_operation(const poll_operation&)                    = delete;
+        auto operator=(const poll_operation&) -> poll_operation& = delete;
+        auto operator=(poll_operation&&) -> poll_operation&      = delete;
+        ~poll_operation()                                        = default;
+
+        /**
+         * Poll operations always suspend to register the file descriptor with the event loop.
+         */
+        auto await_ready() const noexcept -> bool { return false; }
+
+        /**
+         * Registers the file descriptor and its optional timeout with the event loop, whichever
+         * triggers first will resume the awaiting coroutine.
+         * @return False if a stop was already requested, the poll is not registered and completes
+         *         immediately as cancelled.
+         */
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool;
+
+        /**
+         * @return The result of the poll operation.
+         */
+        auto await_resume() noexcept -> poll_status;
+
+    private:
+        /// The io scheduler driving this poll operation.
+        io_scheduler& m_scheduler;
+        /// The amount of time to wait for the event, zero waits indefinitely.
+        std::chrono::nanoseconds m_timeout;
+        /// A stop request on this token cancels the poll.
+        std::stop_token m_stop_token;
+        /// Registered while suspended if the stop token can be stopped.
+        std::optional<std::stop_callback<cancel_callback>> m_stop_callback{std::nullopt};
+        /// Set once the cancel callback has queued this poll with the event loop.
+        std::atomic<bool> m_cancel_queued{false};
+        /// The event and its paired timeout, embedded so polling does not allocate a coroutine frame.
+        detail::poll_info m_pi;
+    };
+
     /**
      * Polls the given file descriptor for the given operations.
      * @param fd The file descriptor to poll for events.
      * @param op The operations to poll for.
      * @param timeout The amount of time to wait for the events to trigger.  A timeout of zero will
      *                block indefinitely until the event triggers.
-     * @return The result of the poll operation.
+     * @param stop_token Requesting a stop immediately removes the poll and its timeout from the event
+     *                   loop and resumes with poll_status::cancelled.
+     * @return The poll operation to co_await, its result is the status of the poll.
      */
-    [[nodiscard]] auto poll(fd_t fd, coro::poll_op op, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> coro::task<poll_status>;
+    [[nodiscard]] auto poll(
+        fd_t                     fd,
+        coro::poll_op            op,
+        std::chrono::nanoseconds timeout    = std::chrono::nanoseconds{0},
+        std::stop_token          stop_token = {}) -> poll_operation
+    {
+        return poll_operation{*this, fd, op, timeout, std::move(stop_token)};
+    }
+
+    /**
+     * Yields the current task until the given time point, or until a stop is requested.  A stop
+     * request immediately removes the timer from the event loop, this is how a losing timeout in a
+     * when_any race is cleaned up rather than left to expire.
+     * @param time The time point to resume execution of this task.
+     * @param stop_token Requesting a stop resumes the task early.
+     * @return poll_status::timeout once the time point is reached, poll_status::cancelled if stopped.
+     */
+    [[nodiscard]] auto yield_until(time_point time, std::stop_token stop_token) -> coro::task<poll_status>;
+
+    /**
+     * Yields the current task for the given amount of time, or until a stop is requested.
+     * @param amount The amount of time to yield for.
+     * @param stop_token Requesting a stop resumes the task early.
+     * @return poll_status::timeout once the time elapsed, poll_status::cancelled if stopped.
+     */
+    template<class rep_type, class period_type>
+    [[nodiscard]] auto yield_for(std::chrono::duration<rep_type, period_type> amount, std::stop_token stop_token)
+        -> coro::task<poll_status>
+    {
+        return yield_until(
+            clock::now() + std::chrono::duration_cast<std::chrono::nanoseconds>(amount), std::move(stop_token));
+    }
+
+    /**
+     * Schedules the current task to run after the given amount of time, or as soon as a stop is requested.
+     * @param amount The amount of time to wait before resuming execution of this task.
+     * @param stop_token Requesting a stop resumes the task early.
+     * @return poll_status::timeout once the time elapsed, poll_status::cancelled if stopped.
+     */
+    template<class rep_type, class period_type>
+    [[nodiscard]] auto schedule_after(std::chrono::duration<rep_type, period_type> amount, std::stop_token stop_token)
+        -> coro::task<poll_status>
+    {
+        return yield_for(amount, std::move(stop_token));
+    }
 
     #ifdef LIBCORO_FEATURE_NETWORKING
     /**
@@ -340,17 +497,21 @@ public:
      * @param op The operations to poll for.
      * @param timeout The amount of time to wait for the events to trigger.  A timeout of zero will
      *                block indefinitely until the event triggers.
-     * @return THe result of the poll operation.
+     * @param stop_token Requesting a stop immediately removes the poll and its timeout from the event
+     *                   loop and resumes with poll_status::cancelled.
+     * @return The poll operation to co_await, its result is the status of the poll.
      */
     [[nodiscard]] auto poll(
-        const net::socket& sock, coro::poll_op op, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> coro::task<poll_status>
+        const net::socket&       sock,
+        coro::poll_op            op,
+        std::chrono::nanoseconds timeout    = std::chrono::nanoseconds{0},
+        std::stop_token          stop_token = {}) -> poll_operation
     {
-        return poll(sock.native_handle(), op, timeout);
+        return poll(sock.native_handle(), op, timeout, std::move(stop_token));
     }
     #endif
 #elif defined(CORO_PLATFORM_WINDOWS) && defined(LIBCORO_FEATURE_NETWORKING)
-    auto poll(detail::poll_info& pi, std::chrono::milliseconds timeout) -> coro::task<poll_status>;
+    auto poll(detail::poll_info& pi, std::chrono::nanoseconds timeout) -> coro::task<poll_status>;
     auto bind_socket(const net::socket& sock) -> void;
 #endif
 
@@ -419,6 +580,13 @@ public:
      */
     auto shutdown() noexcept -> void;
 
+    /**
+     * The event loop only bumps relaxed counters that it alone writes, the cost of gathering the
+     * snapshot is paid by the caller.
+     * @return A snapshot of the event loop's metrics.
+     */
+    auto stats() const -> statistics;
+
 private:
     /// The configuration options.
     options m_opts;
@@ -441,7 +609,7 @@ private:
     /// Thread pool for executing tasks when not in inline mode.
     std::shared_ptr<thread_pool> m_thread_pool{nullptr};
 
-    std::mutex m_timed_events_mutex{};
+    mutable std::mutex m_timed_events_mutex{};
     /// The map of time point's to poll infos for tasks that are yielding for a period of time
     /// or for tasks that are polling with timeouts.
     timed_events m_timed_events{};
@@ -452,13 +620,13 @@ private:
     auto yield_for_internal(std::chrono::nanoseconds amount) -> coro::task<void>;
 
     std::atomic<bool> m_io_processing{false};
-    auto              process_events_manual(std::chrono::milliseconds timeout) -> void;
+    auto              process_events_manual(std::chrono::nanoseconds timeout) -> void;
     auto              process_events_dedicated_thread() -> void;
-    auto              process_events_execute(std::chrono::milliseconds timeout) -> void;
+    auto              process_events_execute(std::chrono::nanoseconds timeout) -> void;
     static auto       event_to_poll_status(uint32_t events) -> poll_status;
 
     auto                                 process_scheduled_execute_inline() -> void;
-    std::mutex                           m_scheduled_tasks_mutex{};
+    mutable std::mutex                   m_scheduled_tasks_mutex{};
     std::vector<std::coroutine_handle<>> m_scheduled_tasks{};
 
     static constexpr const int   m_shutdown_object{0};
@@ -470,24 +638,186 @@ private:
     static constexpr const int   m_schedule_object{0};
     static constexpr const void* m_schedule_ptr = &m_schedule_object;
 
+#if defined(CORO_PLATFORM_UNIX)
+    /// Polls whose stop token was triggered, the event loop removes them and resumes them as cancelled.
+    signal                          m_cancel_signal;
+    std::mutex                      m_cancelled_polls_mutex{};
+    std::vector<detail::poll_info*> m_cancelled_polls{};
+
+    static constexpr const int   m_cancel_object{0};
+    static constexpr const void* m_cancel_ptr = &m_cancel_object;
+
+    auto process_cancelled_execute() -> void;
+#endif
+
     static const constexpr std::chrono::milliseconds              m_default_timeout{1000};
     static const constexpr std::chrono::milliseconds              m_no_timeout{0};
     static const constexpr std::size_t                            m_max_events = 16;
     std::vector<std::pair<detail::poll_info*, coro::poll_status>> m_recent_events{};
-    std::vector<std::coroutine_handle<>>                          m_handles_to_resume{};
+    /// Handles ready to resume paired with the executor thread they prefer to resume on.
+    std::vector<std::pair<std::coroutine_handle<>, std::size_t>> m_handles_to_resume{};
+
+    /// Event loop metrics, these are only written by the thread processing events.
+    std::atomic<uint64_t> m_stats_loop_iterations{0};
+    std::atomic<uint64_t> m_stats_time_blocked{0};
+    std::atomic<uint64_t> m_stats_time_processing{0};
+    std::atomic<uint64_t> m_stats_events{0};
+    std::atomic<uint64_t> m_stats_max_events_per_iteration{0};
+    std::atomic<uint64_t> m_stats_timers_fired{0};
+    std::atomic<uint64_t> m_stats_timer_lateness{0};
+    std::atomic<uint64_t> m_stats_max_timer_lateness{0};
+    std::atomic<uint64_t> m_stats_resumed_inline{0};
+    std::atomic<uint64_t> m_stats_resumed_offloaded{0};
+
+    /// Single writer counter update, avoids a locked read-modify-write on the event loop's hot path.
+    static auto stats_add(std::atomic<uint64_t>& counter, uint64_t amount) noexcept -> void
+    {
+        counter.store(counter.load(std::memory_order::relaxed) + amount, std::memory_order::relaxed);
+    }
+    static auto stats_max(std::atomic<uint64_t>& counter, uint64_t value) noexcept -> void
+    {
+        if (value > counter.load(std::memory_order::relaxed))
+        {
+            counter.store(value, std::memory_order::relaxed);
+        }
+    }
+
+    /**
+     * Queues the poll info's awaiting coroutine to be resumed, on the executor thread it suspended on if
+     * that thread belongs to this scheduler's thread pool.
+     */
+    auto queue_resume(detail::poll_info& pi) -> void
+    {
+        auto worker = (pi.m_thread_pool != nullptr && pi.m_thread_pool == m_thread_pool.get()) ? pi.m_worker
+                                                                                                 : thread_pool::no_worker;
+        m_handles_to_resume.emplace_back(pi.m_awaiting_coroutine, worker);
+    }
 
     auto process_event_execute(detail::poll_info* pi, poll_status status) -> void;
     auto process_timeout_execute() -> void;
 
     auto add_timer_token(time_point tp, detail::poll_info& pi) -> timed_events::iterator;
     auto remove_timer_token(timed_events::iterator pos) -> void;
+    /**
+     * Arms a timer whose expiry runs pi.m_on_timeout on the event loop thread, the scheduler counts it as
+     * outstanding work until it expires or is cancelled.
+     */
+    auto add_timer_callback(time_point tp, detail::poll_info& pi) -> void;
+    /**
+     * @return True if the timer was disarmed, false if the event loop has already taken it and its callback is
+     *         running or has run.
+     */
+    auto cancel_timer_callback(detail::poll_info& pi) -> bool;
     auto update_timeout(time_point now) -> void;
 
-    auto make_timeout_task(std::chrono::milliseconds timeout) -> coro::task<timeout_status>
+#if defined(CORO_PLATFORM_UNIX)
+    /**
+     * A task racing a timeout, attached through its completion hook so no coroutine is created to watch it.
+     * When the task completes it cancels the timer, which removes it from the event loop and resumes the
+     * waiting coroutine right away.  If the timeout wins the task keeps running, whichever of the two lets
+     * go last frees the state along with the task's frame.
+     */
+    template<typename return_type>
+    class timed_task final : public detail::completion_hook, public detail::pooled_frame
+    {
+    public:
+        /// Gives up a reference to the state when the owner goes out of scope.
+        struct releaser
+        {
+            auto operator()(timed_task* timed) const noexcept -> void { timed->release(); }
+        };
+
+        explicit timed_task(coro::task<return_type> task) noexcept
+            : detail::completion_hook{&notify_task_completed},
+              m_task(std::move(task))
+        {
+        }
+
+        auto start() noexcept -> void
+        {
+            m_task.promise().completion(*this);
+            m_task.handle().resume();
+        }
+
+        auto timer_token() const noexcept -> std::stop_token { return m_timer_stop.get_token(); }
+
+        auto is_complete() const noexcept -> bool { return m_completed.load(std::memory_order::acquire); }
+
+        auto result() -> decltype(auto) { return std::move(m_task).promise().result(); }
+
+    private:
+        static auto notify_task_completed(detail::completion_hook& hook, std::coroutine_handle<>) noexcept
+            -> std::coroutine_handle<>
+        {
+            auto& timed = static_cast<timed_task&>(hook);
+            timed.m_completed.store(true, std::memory_order::release);
+            timed.m_timer_stop.request_stop();
+            // If the timeout already won this destroys the completed task, nothing may touch it afterwards.
+            timed.release();
+            return std::noop_coroutine();
+        }
+
+        auto release() noexcept -> void
+        {
+            if (m_references.fetch_sub(1, std::memory_order::acq_rel) == 1)
+            {
+                delete this;
+            }
+        }
+
+        coro::task<return_type> m_task;
+        std::stop_source        m_timer_stop{};
+        std::atomic<bool>       m_completed{false};
+        /// Held by the task until it completes and by the coroutine waiting on the timeout.
+        std::atomic<uint32_t> m_references{2};
+    };
+#else
+    auto make_timeout_task(std::chrono::nanoseconds timeout) -> coro::task<timeout_status>
     {
         co_await schedule_after(timeout);
         co_return timeout_status::timeout;
     }
+#endif
+
+    template<typename return_type>
+    auto schedule_with_timeout(
+        coro::task<return_type>         task,
+        std::chrono::nanoseconds        timeout,
+        std::optional<std::stop_source> stop_source) -> coro::task<coro::expected<return_type, timeout_status>>
+    {
+        using namespace std::chrono_literals;
+
+        // If negative or 0 timeout, just schedule the task as normal.
+        if (timeout <= 0ns)
+        {
+            co_return coro::expected<return_type, timeout_status>(co_await schedule(std::move(task)));
+        }
+
+#if defined(CORO_PLATFORM_UNIX)
+        // The timer is a poll without a file descriptor embedded in this frame, the task cancels it on completion.
+        std::unique_ptr<timed_task<return_type>, typename timed_task<return_type>::releaser> timed{
+            new timed_task<return_type>{std::move(task)}};
+        timed->start();
+        co_await poll_operation{*this, -1, poll_op::read, timeout, timed->timer_token()};
+
+        if (timed->is_complete())
+        {
+            co_return coro::expected<return_type, timeout_status>(timed->result());
+        }
+#else
+        auto result = co_await when_any(std::move(task), make_timeout_task(timeout));
+        if (!std::holds_alternative<timeout_status>(result))
+        {
+            co_return coro::expected<return_type, timeout_status>(std::move(std::get<0>(result)));
+        }
+#endif
+
+        if (stop_source.has_value())
+        {
+            stop_source->request_stop();
+        }
+        co_return coro::unexpected<timeout_status>(timeout_status::timeout);
+    }
 };
 
 } // namespace coro
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "coro/concepts/executor.hpp"
 #include "coro/task.hpp"
 
 #include <atomic>
 #include <coroutine>
+#include <cstddef>
+#include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <utility>
 
 namespace coro
@@ -117,6 +121,37 @@ class mutex
 {
 public:
     explicit mutex() noexcept : m_state(const_cast<void*>(unlocked_value())) {}
+
+    /**
+     * @param spin_count The number of times a contended lock re-checks the mutex before suspending, spinning only
+     *                   pays off for short critical sections whose owner is running on another thread.  Spinners
+     *                   never take the lock ahead of coroutines already waiting for it.
+     */
+    explicit mutex(std::size_t spin_count) noexcept
+        : m_state(const_cast<void*>(unlocked_value())),
+          m_spin_count(spin_count)
+    {
+    }
+
+    /**
+     * @param executor unlock() hands the next waiter to this executor instead of resuming it inline on the unlocking
+     *                 thread, the unlocking coroutine carries on immediately and a chain of unlocks cannot grow the
+     *                 stack.  The waiter is resumed inline if the executor has been shut down.
+     * @param spin_count See mutex(spin_count).
+     */
+    template<concepts::executor executor_type>
+    explicit mutex(std::shared_ptr<executor_type> executor, std::size_t spin_count = 0)
+        : m_state(const_cast<void*>(unlocked_value())),
+          m_spin_count(spin_count),
+          m_executor(std::move(executor)),
+          m_resume_on_executor(&resume_on<executor_type>)
+    {
+        if (m_executor == nullptr)
+        {
+            throw std::runtime_error{"mutex cannot have a nullptr executor"};
+        }
+    }
+
     ~mutex() = default;
 
     mutex(const mutex&)                    = delete;
@@ -152,10 +187,21 @@ public:
 private:
     friend struct detail::lock_operation_base;
 
+    template<typename executor_type>
+    static auto resume_on(void* executor, std::coroutine_handle<> handle) -> bool
+    {
+        return static_cast<executor_type*>(executor)->resume(handle);
+    }
+
     /// unlocked -> state == unlocked_value()
     /// locked but empty waiter list == nullptr
     /// locked with waiters == lock_operation_base*
     std::atomic<void*> m_state;
+    /// The number of times a contended lock re-checks the mutex before suspending.
+    std::size_t m_spin_count{0};
+    /// When set the next waiter is resumed on this executor by unlock().
+    std::shared_ptr<void> m_executor{nullptr};
+    auto (*m_resume_on_executor)(void* executor, std::coroutine_handle<> handle) -> bool {nullptr};
 
     /// Inactive value, this cannot be nullptr since we want nullptr to signify that the mutex
     /// is locked but there are zero waiters, this makes it easy to CAS new waiters into the
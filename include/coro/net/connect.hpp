@@ -13,7 +13,9 @@ enum class connect_status
     /// The connection operation timed out.
     timeout,
     /// There was an error, use errno to get more information on the specific error.
-    error
+    error,
+    /// The connection operation was cancelled by a stop request.
+    cancelled
 };
 
 /**
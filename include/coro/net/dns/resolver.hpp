@@ -237,6 +237,8 @@ private:
             case poll_status::error:
                 // might need to do something like call with two ARES_SOCKET_BAD?
                 break;
+            case poll_status::cancelled:
+                break;
         }
 
         // Remove from the list of actively polling sockets.
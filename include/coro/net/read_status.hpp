@@ -8,6 +8,7 @@ enum class read_status
     closed,
     timeout,
     error,
+    cancelled,
 
     udp_not_bound
 };
@@ -14,8 +14,10 @@
 #include "coro/task.hpp"
 
 #include <chrono>
+#include <limits>
 #include <memory>
 #include <optional>
+#include <stop_token>
 
 namespace coro::net::tcp
 {
@@ -69,9 +71,11 @@ public:
      * Connects to the address+port with the given timeout.  Once connected calling this function
      * only returns the connected status, it will not reconnect.
      * @param timeout How long to wait for the connection to establish? Timeout of zero is indefinite.
+     * @param stop_token Requesting a stop abandons the connection attempt with connect_status::cancelled.
      * @return The result status of trying to connect.
      */
-    auto connect(std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> coro::task<net::connect_status>;
+    auto connect(std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0}, std::stop_token stop_token = {})
+        -> coro::task<net::connect_status>;
 
 #if defined(CORO_PLATFORM_UNIX)
     /**
@@ -80,11 +84,17 @@ public:
      * @warning Unix only
      * @param op The poll operation to perform, use read for incoming data and write for outgoing.
      * @param timeout The amount of time to wait for the poll event to be ready.  Use zero for infinte timeout.
+     * @param stop_token Requesting a stop resumes the poll immediately with poll_status::cancelled.
      * @return The status result of th poll operation.  When poll_status::event is returned then the
      *         event operation is ready.
      */
-    auto poll(coro::poll_op op, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> coro::task<poll_status>;
+    auto poll(
+        coro::poll_op            op,
+        std::chrono::nanoseconds timeout    = std::chrono::nanoseconds{0},
+        std::stop_token          stop_token = {}) -> io_scheduler::poll_operation
+    {
+        return m_io_scheduler->poll(m_socket, op, timeout, std::move(stop_token));
+    }
 
     /**
      * Receives incoming data into the given buffer.  By default since all tcp client sockets are set
@@ -112,6 +122,66 @@ public:
 
 #endif
 
+#if defined(CORO_PLATFORM_UNIX)
+    /**
+     * Awaitable for write(), polls the socket for writability and then sends the buffer upon resuming.
+     * The poll operation is embedded directly so writing does not allocate a coroutine frame.
+     */
+    class write_operation
+    {
+        friend client;
+        write_operation(
+            client& c, std::span<const char> buffer, std::chrono::nanoseconds timeout, std::stop_token stop_token) noexcept
+            : m_client(c),
+              m_buffer(buffer),
+              m_poll_operation(c.poll(poll_op::write, timeout, std::move(stop_token)))
+        {
+        }
+
+    public:
+        auto await_ready() const noexcept -> bool { return m_poll_operation.await_ready(); }
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            return m_poll_operation.await_suspend(awaiting_coroutine);
+        }
+        auto await_resume() -> std::pair<write_status, std::span<const char>>;
+
+    private:
+        client&                       m_client;
+        std::span<const char>         m_buffer;
+        io_scheduler::poll_operation m_poll_operation;
+    };
+
+    /**
+     * Awaitable for read(), polls the socket for readability and then receives into the buffer upon
+     * resuming.  The poll operation is embedded directly so reading does not allocate a coroutine frame.
+     */
+    class read_operation
+    {
+        friend client;
+        read_operation(
+            client& c, std::span<char> buffer, std::chrono::nanoseconds timeout, std::stop_token stop_token) noexcept
+            : m_client(c),
+              m_buffer(buffer),
+              m_poll_operation(c.poll(poll_op::read, timeout, std::move(stop_token)))
+        {
+        }
+
+    public:
+        auto await_ready() const noexcept -> bool { return m_poll_operation.await_ready(); }
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            return m_poll_operation.await_suspend(awaiting_coroutine);
+        }
+        auto await_resume() -> std::pair<read_status, std::span<char>>;
+
+    private:
+        client&                       m_client;
+        std::span<char>               m_buffer;
+        io_scheduler::poll_operation m_poll_operation;
+    };
+#endif
+
     /**
      * Attempts to send the given data to the connected peer.
      *
@@ -120,10 +190,23 @@ public:
      *
      * @param buffer The data to send.
      * @param timeout Maximum time to wait for the operation to complete. Zero means no timeout.
+     * @param stop_token Requesting a stop abandons the write with write_status::cancelled, unix only.
      * @return A pair containing the status and a span of any unsent data. If successful, the span will be empty.
      */
-    auto write(std::span<const char> buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> task<std::pair<write_status, std::span<const char>>>;
+#if defined(CORO_PLATFORM_UNIX)
+    auto write(
+        std::span<const char>    buffer,
+        std::chrono::nanoseconds timeout    = std::chrono::nanoseconds{0},
+        std::stop_token          stop_token = {}) -> write_operation
+    {
+        return write_operation{*this, buffer, timeout, std::move(stop_token)};
+    }
+#elif defined(CORO_PLATFORM_WINDOWS)
+    auto write(
+        std::span<const char>    buffer,
+        std::chrono::nanoseconds timeout    = std::chrono::nanoseconds{0},
+        std::stop_token          stop_token = {}) -> task<std::pair<write_status, std::span<const char>>>;
+#endif
 
     /**
      * Attempts to receive data from the connected peer into the provided buffer.
@@ -132,10 +215,66 @@ public:
      *
      * @param buffer The buffer to fill with incoming data.
      * @param timeout Maximum time to wait for the operation to complete. Zero means no timeout.
+     * @param stop_token Requesting a stop abandons the read with read_status::cancelled, unix only.
      * @return A pair containing the status and a span of received bytes. The span may be empty.
      */
-    auto read(std::span<char> buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> task<std::pair<read_status, std::span<char>>>;
+#if defined(CORO_PLATFORM_UNIX)
+    auto read(
+        std::span<char>          buffer,
+        std::chrono::nanoseconds timeout    = std::chrono::nanoseconds{0},
+        std::stop_token          stop_token = {}) -> read_operation
+    {
+        return read_operation{*this, buffer, timeout, std::move(stop_token)};
+    }
+#elif defined(CORO_PLATFORM_WINDOWS)
+    auto read(
+        std::span<char>          buffer,
+        std::chrono::nanoseconds timeout    = std::chrono::nanoseconds{0},
+        std::stop_token          stop_token = {}) -> task<std::pair<read_status, std::span<char>>>;
+#endif
+
+#if defined(CORO_PLATFORM_LINUX)
+    /**
+     * Sends a range of a file directly from the kernel's page cache to the connected peer with sendfile(),
+     * the file's bytes are never copied into user space.  The socket is polled for writability whenever
+     * its send buffer is full.
+     * @warning Linux only
+     * @param fd The file descriptor of the file to send, it must support mmap-like operations (a regular file).
+     * @param offset The offset in the file to start sending from.
+     * @param length The number of bytes to send.
+     * @param timeout The amount of time to wait for each poll for writability.  Zero waits indefinitely.
+     * @param stop_token Requesting a stop abandons the transfer with write_status::cancelled.
+     * @return The status of the transfer and the number of bytes that were sent.  If the file ends before
+     *         length bytes the status is ok and the count is the bytes that were available.  On any other
+     *         status the count is the partial progress made before the failure.
+     */
+    auto send_file(
+        fd_t                     fd,
+        uint64_t                 offset,
+        std::size_t              length,
+        std::chrono::nanoseconds timeout    = std::chrono::nanoseconds{0},
+        std::stop_token          stop_token = {}) -> coro::task<std::pair<write_status, std::size_t>>;
+
+    /**
+     * Moves bytes received on this client to the destination client with splice() through a pipe, the
+     * bytes are never copied into user space.  This client is polled for readability and the destination
+     * for writability as needed.
+     * @warning Linux only
+     * @param destination The client to forward the received bytes to.
+     * @param length The maximum number of bytes to move, by default everything until this client's peer
+     *               closes the connection.
+     * @param timeout The amount of time to wait for each poll.  Zero waits indefinitely.
+     * @param stop_token Requesting a stop abandons the transfer with write_status::cancelled.
+     * @return The status of the transfer and the number of bytes delivered to the destination.  The status
+     *         is closed if this client's peer closed the connection before length bytes were moved.  If the
+     *         transfer fails bytes already read from this client but not yet delivered are lost.
+     */
+    auto splice_to(
+        client&                  destination,
+        std::size_t              length     = std::numeric_limits<std::size_t>::max(),
+        std::chrono::nanoseconds timeout    = std::chrono::nanoseconds{0},
+        std::stop_token          stop_token = {}) -> coro::task<std::pair<write_status, std::size_t>>;
+#endif
 
 private:
     /// The tcp::server creates already connected clients and provides a tcp socket pre-built.
@@ -202,58 +341,61 @@ auto client::send(const buffer_type& buffer) -> std::pair<send_status, std::span
     }
 }
 
-inline auto client::write(std::span<const char> buffer, std::chrono::milliseconds timeout)
-    -> task<std::pair<write_status, std::span<const char>>>
+inline auto client::write_operation::await_resume() -> std::pair<write_status, std::span<const char>>
 {
-    if (auto status = co_await poll(poll_op::write, timeout); status != poll_status::event)
+    if (auto status = m_poll_operation.await_resume(); status != poll_status::event)
     {
         switch (status)
         {
             case poll_status::closed:
-                co_return {write_status::closed, std::span<const char>{buffer.data(), buffer.size()}};
+                return {write_status::closed, std::span<const char>{m_buffer.data(), m_buffer.size()}};
             case poll_status::error:
-                co_return {write_status::error, std::span<const char>{buffer.data(), buffer.size()}};
+                return {write_status::error, std::span<const char>{m_buffer.data(), m_buffer.size()}};
             case poll_status::timeout:
-                co_return {write_status::timeout, std::span<const char>{buffer.data(), buffer.size()}};
+                return {write_status::timeout, std::span<const char>{m_buffer.data(), m_buffer.size()}};
+            case poll_status::cancelled:
+                return {write_status::cancelled, std::span<const char>{m_buffer.data(), m_buffer.size()}};
             default:
                 throw std::runtime_error("Unknown poll_status value.");
         }
     }
-    switch (auto &&[status, span] = send(std::move(buffer)); status)
+    switch (auto&& [status, span] = m_client.send(m_buffer); status)
     {
         case send_status::ok:
-            co_return {write_status::ok, span};
+            return {write_status::ok, span};
         case send_status::closed:
-            co_return {write_status::closed, span};
+            return {write_status::closed, span};
         default:
-            co_return {write_status::error, span};
+            return {write_status::error, span};
     }
 }
 
-inline auto client::read(std::span<char> buffer, std::chrono::milliseconds timeout) -> task<std::pair<read_status, std::span<char>>>
+inline auto client::read_operation::await_resume() -> std::pair<read_status, std::span<char>>
 {
-    if (auto status = co_await poll(poll_op::read, timeout); status != poll_status::event)
+    if (auto status = m_poll_operation.await_resume(); status != poll_status::event)
     {
         switch (status)
         {
             case poll_status::closed:
-                co_return {read_status::closed, std::span<char>{}};
+                return {read_status::closed, std::span<char>{}};
             case poll_status::error:
-                co_return {read_status::error, std::span<char>{}};
+                return {read_status::error, std::span<char>{}};
             case poll_status::timeout:
-                co_return {read_status::timeout, std::span<char>{}};
+                return {read_status::timeout, std::span<char>{}};
+            case poll_status::cancelled:
+                return {read_status::cancelled, std::span<char>{}};
             default:
                 throw std::runtime_error("Unknown poll_status value.");
         }
     }
-    switch (auto&& [status, span] = recv(std::move(buffer)); status)
+    switch (auto&& [status, span] = m_client.recv(m_buffer); status)
     {
         case recv_status::ok:
-            co_return {read_status::ok, span};
+            return {read_status::ok, span};
         case recv_status::closed:
-            co_return {read_status::closed, span};
+            return {read_status::closed, span};
         default:
-            co_return {read_status::error, span};
+            return {read_status::error, span};
     }
 }
 #endif
@@ -50,13 +50,15 @@ public:
     /**
      * Polls for new incoming tcp connections.
      * @param timeout How long to wait for a new connection before timing out, zero waits indefinitely.
+     * @param stop_token Requesting a stop resumes the poll immediately with poll_status::cancelled.
      * @return The result of the poll, 'event' means the poll was successful and there is at least 1
      *         connection ready to be accepted.
      * @note Unix only
      */
-    auto poll(std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> coro::task<coro::poll_status>
+    auto poll(std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0}, std::stop_token stop_token = {})
+        -> io_scheduler::poll_operation
     {
-        return m_io_scheduler->poll(m_accept_socket, coro::poll_op::read, timeout);
+        return m_io_scheduler->poll(m_accept_socket, coro::poll_op::read, timeout, std::move(stop_token));
     }
 
     /**
@@ -72,10 +74,13 @@ public:
      * Asynchronously accepts an incoming TCP client connection.
      * If no connection is received before the internal timeout or cancellation, the result will be std::nullopt.
      *
+     * @param timeout How long to wait for a new connection before timing out, zero waits indefinitely.
+     * @param stop_token Requesting a stop abandons the accept, unix only.
      * @return A task resolving to an optional TCP client connection. The value will be set if a client was
      *         successfully accepted, or std::nullopt if the operation timed out or was cancelled.
      */
-    auto accept_client(std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> coro::task<std::optional<coro::net::tcp::client>>;
+    auto accept_client(std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0}, std::stop_token stop_token = {})
+        -> coro::task<std::optional<coro::net::tcp::client>>;
 
 private:
     friend client;
@@ -121,6 +121,7 @@ public:
                 case poll_status::timeout:
                     co_return {recv_status::timeout, std::span<char>{}};
                 case poll_status::error:
+                case poll_status::cancelled:
                     co_return {recv_status::error, std::span<char>{}};
                 case poll_status::closed:
                     co_return {recv_status::closed, std::span<char>{}};
@@ -211,6 +212,7 @@ public:
                 case poll_status::timeout:
                     co_return {send_status::timeout, std::span<char>{}};
                 case poll_status::error:
+                case poll_status::cancelled:
                     co_return {send_status::error, std::span<char>{}};
                 case poll_status::closed:
                     co_return {send_status::closed, std::span<char>{}};
@@ -266,7 +268,7 @@ private:
      *         event operation is ready.
      */
     auto poll(coro::poll_op op, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> coro::task<poll_status>
+        -> io_scheduler::poll_operation
     {
         return m_io_scheduler->poll(m_socket, op, timeout);
     }
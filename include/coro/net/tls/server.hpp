@@ -53,7 +53,7 @@ public:
      * @return The result of the poll, 'event' means the poll was successful and there is at least 1
      *         connection ready to be accepted.
      */
-    auto poll(std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> coro::task<coro::poll_status>
+    auto poll(std::chrono::milliseconds timeout = std::chrono::milliseconds{0}) -> io_scheduler::poll_operation
     {
         return m_io_scheduler->poll(m_accept_socket, coro::poll_op::read, timeout);
     }
@@ -59,10 +59,10 @@ public:
      * @return The result status of the poll operation.
      * @note Unix only
      */
-    auto poll(poll_op op, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
-        -> coro::task<coro::poll_status>
+    auto poll(poll_op op, std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0})
+        -> io_scheduler::poll_operation
     {
-        co_return co_await m_io_scheduler->poll(m_socket, op, timeout);
+        return m_io_scheduler->poll(m_socket, op, timeout);
     }
 
     /**
@@ -87,6 +87,70 @@ public:
     auto recvfrom(buffer_type&& buffer) -> std::tuple<recv_status, peer::info, std::span<char>>;
 #endif
 
+#if defined(CORO_PLATFORM_UNIX)
+    /**
+     * Awaitable for write_to(), polls the socket for writability and then sends the buffer to the
+     * peer upon resuming.  The poll operation is embedded so this does not allocate a coroutine frame.
+     */
+    class write_to_operation
+    {
+        friend peer;
+        write_to_operation(
+            peer& p, const info& peer_info, std::span<const char> buffer, std::chrono::nanoseconds timeout) noexcept
+            : m_peer(p),
+              m_peer_info(peer_info),
+              m_buffer(buffer),
+              m_poll_operation(p.poll(poll_op::write, timeout))
+        {
+        }
+
+    public:
+        auto await_ready() const noexcept -> bool { return m_poll_operation.await_ready(); }
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            return m_poll_operation.await_suspend(awaiting_coroutine);
+        }
+        auto await_resume() -> std::pair<write_status, std::span<const char>>;
+
+    private:
+        peer&                         m_peer;
+        info                          m_peer_info;
+        std::span<const char>         m_buffer;
+        io_scheduler::poll_operation m_poll_operation;
+    };
+
+    /**
+     * Awaitable for read_from(), polls the socket for readability and then receives into the buffer
+     * upon resuming.  The poll operation is embedded so this does not allocate a coroutine frame.
+     */
+    class read_from_operation
+    {
+        friend peer;
+        read_from_operation(peer& p, std::span<char> buffer, std::chrono::nanoseconds timeout) noexcept
+            : m_peer(p),
+              m_buffer(buffer),
+              m_poll_operation(p.poll(poll_op::read, timeout))
+        {
+        }
+
+    public:
+        /**
+         * An unbound peer cannot receive packets, complete immediately without polling.
+         */
+        auto await_ready() const noexcept -> bool { return !m_peer.m_bound; }
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            return m_poll_operation.await_suspend(awaiting_coroutine);
+        }
+        auto await_resume() -> std::tuple<read_status, peer::info, std::span<char>>;
+
+    private:
+        peer&                         m_peer;
+        std::span<char>               m_buffer;
+        io_scheduler::poll_operation m_poll_operation;
+    };
+#endif
+
     /**
      * @param peer_info The peer to send the data to.
      * @param buffer The data to send.
@@ -94,11 +158,21 @@ public:
      * @return The status of write call and a span view of any data that wasn't sent. This data if
      *         un-sent will correspond to bytes at the end of the given buffer.
      */
+#if defined(CORO_PLATFORM_UNIX)
+    auto write_to(
+        const info&               peer_info,
+        std::span<const char>     buffer,
+        std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0}) -> write_to_operation
+    {
+        return write_to_operation{*this, peer_info, buffer, timeout};
+    }
+#elif defined(CORO_PLATFORM_WINDOWS)
     auto write_to(
         const info&               peer_info,
         std::span<const char>     buffer,
-        std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
+        std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0})
         -> coro::task<std::pair<write_status, std::span<const char>>>;
+#endif
 
     /**
      * @param buffer The buffer to receive data into.
@@ -108,8 +182,16 @@ public:
      *         always start at the beginning of the buffer but depending on how large the data was
      *         it might not fill the entire buffer.
      */
-    auto read_from(std::span<char> buffer, std::chrono::milliseconds timeout = std::chrono::milliseconds{0})
+#if defined(CORO_PLATFORM_UNIX)
+    auto read_from(std::span<char> buffer, std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0})
+        -> read_from_operation
+    {
+        return read_from_operation{*this, buffer, timeout};
+    }
+#elif defined(CORO_PLATFORM_WINDOWS)
+    auto read_from(std::span<char> buffer, std::chrono::nanoseconds timeout = std::chrono::nanoseconds{0})
         -> coro::task<std::tuple<read_status, peer::info, std::span<char>>>;
+#endif
 
 private:
     /// The scheduler that will drive this udp client.
@@ -175,65 +257,66 @@ auto peer::recvfrom(buffer_type&& buffer) -> std::tuple<recv_status, peer::info,
         peer::info{.address = std::move(address), .port = port},
         std::span<char>{buffer.data(), static_cast<size_t>(bytes_read)}};
 }
-inline auto peer::write_to(const info& peer_info, std::span<const char> buffer, std::chrono::milliseconds timeout)
-    -> coro::task<std::pair<write_status, std::span<const char>>>
+inline auto peer::write_to_operation::await_resume() -> std::pair<write_status, std::span<const char>>
 {
-    if (auto status = co_await poll(poll_op::write, timeout); status != poll_status::event)
+    if (auto status = m_poll_operation.await_resume(); status != poll_status::event)
     {
         switch (status)
         {
             case poll_status::closed:
-                co_return {write_status::closed, std::span<const char>{buffer.data(), buffer.size()}};
-                ;
+                return {write_status::closed, std::span<const char>{m_buffer.data(), m_buffer.size()}};
             case poll_status::error:
-                co_return {write_status::error, std::span<const char>{buffer.data(), buffer.size()}};
+                return {write_status::error, std::span<const char>{m_buffer.data(), m_buffer.size()}};
             case poll_status::timeout:
-                co_return {write_status::timeout, std::span<const char>{buffer.data(), buffer.size()}};
+                return {write_status::timeout, std::span<const char>{m_buffer.data(), m_buffer.size()}};
+            case poll_status::cancelled:
+                return {write_status::cancelled, std::span<const char>{m_buffer.data(), m_buffer.size()}};
             default:
                 throw std::runtime_error("Unknown poll_status value.");
         }
     }
-    switch (auto&& [status, span] = sendto(peer_info, buffer); status)
+    switch (auto&& [status, span] = m_peer.sendto(m_peer_info, m_buffer); status)
     {
         case send_status::ok:
-            co_return {write_status::ok, span};
+            return {write_status::ok, span};
         case send_status::closed:
-            co_return {write_status::closed, span};
+            return {write_status::closed, span};
         default:
-            co_return {write_status::error, span};
+            return {write_status::error, span};
     }
 }
 
-inline auto peer::read_from(std::span<char> buffer, std::chrono::milliseconds timeout)
-    -> coro::task<std::tuple<read_status, peer::info, std::span<char>>>
+inline auto peer::read_from_operation::await_resume() -> std::tuple<read_status, peer::info, std::span<char>>
 {
-    if (!m_bound)
+    if (!m_peer.m_bound)
     {
-        co_return {read_status::udp_not_bound, peer::info{}, std::span<char>{}};
+        return {read_status::udp_not_bound, peer::info{}, std::span<char>{}};
     }
 
-    if (auto status = co_await poll(poll_op::read, timeout); status != poll_status::event)
+    if (auto status = m_poll_operation.await_resume(); status != poll_status::event)
     {
         switch (status)
         {
             case poll_status::closed:
-                co_return {read_status::closed, peer::info{}, std::span<char>{}};
+                return {read_status::closed, peer::info{}, std::span<char>{}};
             case poll_status::error:
-                co_return {read_status::error, peer::info{}, std::span<char>{}};
+                return {read_status::error, peer::info{}, std::span<char>{}};
             case poll_status::timeout:
-                co_return {read_status::timeout, peer::info{}, std::span<char>{}};
+                return {read_status::timeout, peer::info{}, std::span<char>{}};
+            case poll_status::cancelled:
+                return {read_status::cancelled, peer::info{}, std::span<char>{}};
             default:
                 throw std::runtime_error("Unknown poll_status value.");
         }
     }
-    switch (auto&& [status, info, span] = recvfrom(buffer); status)
+    switch (auto&& [status, info, span] = m_peer.recvfrom(m_buffer); status)
     {
         case recv_status::ok:
-            co_return {read_status::ok, std::move(info), span};
+            return {read_status::ok, std::move(info), span};
         case recv_status::closed:
-            co_return {read_status::closed, std::move(info), span};
+            return {read_status::closed, std::move(info), span};
         default:
-            co_return {read_status::error, std::move(info), span};
+            return {read_status::error, std::move(info), span};
     }
 }
 #endif
@@ -7,6 +7,7 @@ enum class write_status
     ok,
     closed,
     timeout,
-    error
+    error,
+    cancelled
 };
 }
\ No newline at end of file
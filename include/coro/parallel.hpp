@@ -0,0 +1,253 @@
+#pragma once
+
+#include "coro/task.hpp"
+#include "coro/thread_pool.hpp"
+#include "coro/when_all.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+namespace coro
+{
+namespace detail
+{
+/// Each worker gets this many chunks on average so stealing can even out uneven chunks.
+inline constexpr std::size_t parallel_chunks_per_thread{8};
+
+inline auto parallel_grain_size(const thread_pool& tp, std::size_t size, std::size_t grain) noexcept -> std::size_t
+{
+    if (grain != 0)
+    {
+        return grain;
+    }
+    return std::max<std::size_t>(1, size / (std::max<std::size_t>(1, tp.thread_count()) * parallel_chunks_per_thread));
+}
+
+/**
+ * Halves [first, last) until a half is no larger than the grain, the two halves of each split run
+ * concurrently through when_all.  A coroutine frame is created per split, never per element, and each leaf
+ * is scheduled onto the pool separately so idle workers can steal it.
+ */
+template<std::random_access_iterator iterator_type, typename func_type>
+auto parallel_for_split(thread_pool& tp, iterator_type first, iterator_type last, std::size_t grain, func_type& f)
+    -> coro::task<void>
+{
+    auto size = static_cast<std::size_t>(std::distance(first, last));
+    if (size <= grain)
+    {
+        co_await tp.schedule();
+        for (; first != last; ++first)
+        {
+            std::invoke(f, *first);
+        }
+        co_return;
+    }
+
+    auto middle = first + static_cast<std::iter_difference_t<iterator_type>>(size / 2);
+    auto [left, right] = co_await when_all(
+        parallel_for_split(tp, first, middle, grain, f), parallel_for_split(tp, middle, last, grain, f));
+    left.return_value();
+    right.return_value();
+}
+
+template<
+    std::random_access_iterator iterator_type,
+    typename value_type,
+    typename reduce_type,
+    typename transform_type>
+auto parallel_transform_reduce_split(
+    thread_pool&    tp,
+    iterator_type   first,
+    iterator_type   last,
+    std::size_t     grain,
+    reduce_type&    reduce,
+    transform_type& transform) -> coro::task<value_type>
+{
+    // Ranges are never split empty, each half has at least one element to seed its partial result.
+    auto size = static_cast<std::size_t>(std::distance(first, last));
+    if (size <= grain)
+    {
+        co_await tp.schedule();
+        value_type partial = std::invoke(transform, *first);
+        for (++first; first != last; ++first)
+        {
+            partial = std::invoke(reduce, std::move(partial), std::invoke(transform, *first));
+        }
+        co_return partial;
+    }
+
+    auto middle        = first + static_cast<std::iter_difference_t<iterator_type>>(size / 2);
+    auto [left, right] = co_await when_all(
+        parallel_transform_reduce_split<iterator_type, value_type>(tp, first, middle, grain, reduce, transform),
+        parallel_transform_reduce_split<iterator_type, value_type>(tp, middle, last, grain, reduce, transform));
+    co_return std::invoke(reduce, std::move(left.return_value()), std::move(right.return_value()));
+}
+
+template<std::random_access_iterator iterator_type, typename compare_type>
+auto parallel_sort_split(
+    thread_pool& tp, iterator_type first, iterator_type last, std::size_t grain, compare_type& compare)
+    -> coro::task<void>
+{
+    auto size = static_cast<std::size_t>(std::distance(first, last));
+    if (size <= grain)
+    {
+        co_await tp.schedule();
+        std::sort(first, last, compare);
+        co_return;
+    }
+
+    auto middle = first + static_cast<std::iter_difference_t<iterator_type>>(size / 2);
+    auto [left, right] = co_await when_all(
+        parallel_sort_split(tp, first, middle, grain, compare), parallel_sort_split(tp, middle, last, grain, compare));
+    left.return_value();
+    right.return_value();
+
+    // Both halves are sorted, the merge runs on whichever worker finished the second half.
+    std::inplace_merge(first, middle, last, compare);
+}
+
+/// The range is held by value in the coroutine frame, an rvalue container is moved into an owning view.
+template<std::ranges::random_access_range view_type, typename func_type>
+auto parallel_for_view(std::shared_ptr<thread_pool> tp, view_type range, func_type f, std::size_t grain)
+    -> coro::task<void>
+{
+    if (tp == nullptr)
+    {
+        throw std::runtime_error{"parallel_for cannot have a nullptr thread pool"};
+    }
+
+    auto first = std::ranges::begin(range);
+    auto last  = std::ranges::end(range);
+    auto size  = static_cast<std::size_t>(std::ranges::distance(range));
+    if (size == 0)
+    {
+        co_return;
+    }
+
+    co_await parallel_for_split(*tp, first, last, parallel_grain_size(*tp, size, grain), f);
+}
+
+template<std::ranges::random_access_range view_type, typename value_type, typename reduce_type, typename transform_type>
+auto parallel_transform_reduce_view(
+    std::shared_ptr<thread_pool> tp,
+    view_type                    range,
+    value_type                   init,
+    reduce_type                  reduce,
+    transform_type               transform,
+    std::size_t                  grain) -> coro::task<value_type>
+{
+    if (tp == nullptr)
+    {
+        throw std::runtime_error{"parallel_transform_reduce cannot have a nullptr thread pool"};
+    }
+
+    auto first = std::ranges::begin(range);
+    auto last  = std::ranges::end(range);
+    auto size  = static_cast<std::size_t>(std::ranges::distance(range));
+    if (size == 0)
+    {
+        co_return init;
+    }
+
+    auto result = co_await parallel_transform_reduce_split<decltype(first), value_type>(
+        *tp, first, last, parallel_grain_size(*tp, size, grain), reduce, transform);
+    co_return std::invoke(reduce, std::move(init), std::move(result));
+}
+
+template<std::ranges::random_access_range view_type, typename compare_type>
+auto parallel_sort_view(std::shared_ptr<thread_pool> tp, view_type range, compare_type compare, std::size_t grain)
+    -> coro::task<void>
+{
+    if (tp == nullptr)
+    {
+        throw std::runtime_error{"parallel_sort cannot have a nullptr thread pool"};
+    }
+
+    auto first = std::ranges::begin(range);
+    auto last  = std::ranges::end(range);
+    auto size  = static_cast<std::size_t>(std::ranges::distance(range));
+    if (size < 2)
+    {
+        co_return;
+    }
+
+    co_await parallel_sort_split(*tp, first, last, parallel_grain_size(*tp, size, grain), compare);
+}
+
+} // namespace detail
+
+/**
+ * Invokes f on every element of the range, split across the thread pool.  The range is halved
+ * recursively until a chunk is no larger than the grain, chunks run concurrently and the returned task
+ * completes once all of them have.  The range is taken through std::views::all, an lvalue range must
+ * outlive the returned task and an rvalue range is moved into it.
+ * @param tp The thread pool to run the chunks on.
+ * @param range The elements to visit, it must be random access to be split.
+ * @param f Invoked with each element, possibly from several threads at once.
+ * @param grain The largest chunk run on a single worker, zero picks one based on the pool's thread count.
+ * @throw The first exception f throws, once every chunk has completed.
+ */
+template<std::ranges::random_access_range range_type, typename func_type>
+    requires std::ranges::viewable_range<range_type>
+[[nodiscard]] auto parallel_for(std::shared_ptr<thread_pool> tp, range_type&& range, func_type f, std::size_t grain = 0)
+    -> coro::task<void>
+{
+    return detail::parallel_for_view(
+        std::move(tp), std::views::all(std::forward<range_type>(range)), std::move(f), grain);
+}
+
+/**
+ * Transforms every element of the range and reduces the results, split across the thread pool like
+ * parallel_for.  The reduction is applied in an unspecified grouping so it must be associative.
+ * @param tp The thread pool to run the chunks on.
+ * @param range The elements to reduce, it must be random access to be split.
+ * @param init The initial value, reduced with the result of the whole range.
+ * @param reduce Combines two partial results, possibly from several threads at once.
+ * @param transform Maps an element into the reduced value type.
+ * @param grain The largest chunk run on a single worker, zero picks one based on the pool's thread count.
+ * @return The reduction of init and every transformed element.
+ */
+template<std::ranges::random_access_range range_type, typename value_type, typename reduce_type, typename transform_type>
+    requires std::ranges::viewable_range<range_type>
+[[nodiscard]] auto parallel_transform_reduce(
+    std::shared_ptr<thread_pool> tp,
+    range_type&&                 range,
+    value_type                   init,
+    reduce_type                  reduce,
+    transform_type               transform,
+    std::size_t                  grain = 0) -> coro::task<value_type>
+{
+    return detail::parallel_transform_reduce_view(
+        std::move(tp),
+        std::views::all(std::forward<range_type>(range)),
+        std::move(init),
+        std::move(reduce),
+        std::move(transform),
+        grain);
+}
+
+/**
+ * Sorts the range across the thread pool, the chunks are sorted concurrently and merged pairwise as
+ * both halves of each split complete.  Like std::sort the sort is not stable.
+ * @param tp The thread pool to run the chunks on.
+ * @param range The elements to sort, it must be random access.
+ * @param compare The strict weak ordering to sort by.
+ * @param grain The largest chunk sorted on a single worker, zero picks one based on the pool's thread count.
+ */
+template<std::ranges::random_access_range range_type, typename compare_type = std::ranges::less>
+    requires std::ranges::viewable_range<range_type>
+[[nodiscard]] auto parallel_sort(
+    std::shared_ptr<thread_pool> tp, range_type&& range, compare_type compare = {}, std::size_t grain = 0)
+    -> coro::task<void>
+{
+    return detail::parallel_sort_view(
+        std::move(tp), std::views::all(std::forward<range_type>(range)), std::move(compare), grain);
+}
+
+} // namespace coro
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "coro/detail/poll_info.hpp"
+#include "coro/time.hpp"
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+
+namespace coro
+{
+class io_scheduler;
+
+enum class missed_tick_policy
+{
+    /// Every missed tick is delivered, back to back without suspending, until the timer has caught
+    /// up with its schedule.
+    burst,
+    /// A late tick is delivered once immediately and any other missed ticks are dropped, the next
+    /// tick is the next one on the original schedule.
+    skip,
+    /// Like skip, but the late tick reports how many ticks elapsed so the caller can account for
+    /// the ones that were folded into it.
+    coalesce
+};
+
+/**
+ * A periodic timer resumes the awaiting coroutine on a fixed schedule driven by an io_scheduler.
+ * Deadlines are computed from the time the timer was created, start + n * period, rather than
+ * from when the previous tick resumed so the ticks do not drift as the work between them varies.
+ *
+ * The timer embeds the node that is registered with the scheduler's timer list and reuses it for
+ * every tick, waiting on a tick does not allocate.  Only a single coroutine may await the timer at
+ * a time and the timer must not be destroyed while a tick is being awaited.
+ * \code
+auto timer = scheduler->schedule_every(std::chrono::milliseconds{10});
+while (running)
+{
+    auto ticks = co_await timer;
+    ...
+}
+ * \endcode
+ */
+class periodic_timer
+{
+public:
+    struct tick_operation
+    {
+        explicit tick_operation(periodic_timer& timer) noexcept : m_timer(timer) {}
+
+        /**
+         * @return True if the next deadline has already passed, the tick is delivered without suspending.
+         */
+        auto await_ready() noexcept -> bool;
+
+        /**
+         * Registers the timer's node with the scheduler to resume at the next deadline.
+         */
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> void;
+
+        /**
+         * @return The number of ticks this resumption accounts for, this is always 1 unless the
+         *         missed tick policy is coalesce and ticks were missed.
+         */
+        auto await_resume() noexcept -> uint64_t;
+
+        periodic_timer& m_timer;
+        /// Set when the tick is delivered without suspending.
+        uint64_t m_ready_ticks{0};
+    };
+
+    /**
+     * @param scheduler The io scheduler that drives the timer.
+     * @param period The amount of time between ticks, the first tick is one period from now.
+     * @param policy What to do when the awaiting coroutine falls behind by one or more ticks.
+     */
+    periodic_timer(
+        std::shared_ptr<io_scheduler> scheduler,
+        std::chrono::nanoseconds      period,
+        missed_tick_policy            policy = missed_tick_policy::skip);
+    periodic_timer(const periodic_timer&)                    = delete;
+    periodic_timer(periodic_timer&&)                         = delete;
+    auto operator=(const periodic_timer&) -> periodic_timer& = delete;
+    auto operator=(periodic_timer&&) -> periodic_timer&      = delete;
+    ~periodic_timer()                                        = default;
+
+    /**
+     * Waits for the next tick.
+     */
+    auto operator co_await() noexcept -> tick_operation { return tick_operation{*this}; }
+
+    /**
+     * @return The amount of time between ticks.
+     */
+    auto period() const noexcept -> std::chrono::nanoseconds { return m_period; }
+
+    /**
+     * @return The deadline of the next tick.
+     */
+    auto next_tick() const noexcept -> time_point { return m_next; }
+
+    /**
+     * @return The missed tick policy of this timer.
+     */
+    auto policy() const noexcept -> missed_tick_policy { return m_policy; }
+
+    /**
+     * Restarts the schedule, the next tick is one period from now.
+     */
+    auto reset() noexcept -> void;
+
+private:
+    /// The scheduler driving this timer.
+    std::shared_ptr<io_scheduler> m_scheduler;
+    /// The amount of time between ticks.
+    std::chrono::nanoseconds m_period;
+    /// How missed ticks are delivered.
+    missed_tick_policy m_policy;
+    /// The deadline of the next tick.
+    time_point m_next;
+    /// The timer node, re-armed for every tick.
+    detail::poll_info m_pi{};
+};
+
+} // namespace coro
@@ -63,7 +63,9 @@ enum class poll_status
     /// The file descriptor had an error while polling.
     error,
     /// The file descriptor has been closed by the remote or an internal error/close.
-    closed
+    closed,
+    /// The poll operation was cancelled by a stop request before the event or timeout occurred.
+    cancelled
 };
 
 auto to_string(poll_status status) -> const std::string&;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "coro/detail/awaiter_list.hpp"
 #include "coro/expected.hpp"
 #include "coro/mutex.hpp"
 #include "coro/task.hpp"
@@ -1,12 +1,16 @@
 #pragma once
 
-#include "coro/detail/awaiter_list.hpp"
+#include "coro/concepts/executor.hpp"
 #include "coro/expected.hpp"
 #include "coro/export.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <coroutine>
+#include <cstddef>
+#include <memory>
 #include <mutex>
+#include <stdexcept>
 #include <string>
 
 namespace coro
@@ -36,7 +40,7 @@ template<std::ptrdiff_t max_value>
 class acquire_operation
 {
 public:
-    explicit acquire_operation(semaphore<max_value>& s) : m_semaphore(s) { }
+    acquire_operation(semaphore<max_value>& s, std::ptrdiff_t count) : m_semaphore(s), m_count(count) { }
 
     auto await_ready() const noexcept -> bool
     {
@@ -44,19 +48,31 @@ public:
         {
             return true;
         }
-        return m_semaphore.try_acquire();
+        return m_semaphore.try_acquire(m_count);
     }
 
     auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
     {
-        // Check again now that we've setup the coroutine frame, the state could have changed.
-        if (await_ready())
+        std::scoped_lock lk{m_semaphore.m_mutex};
+        // Check again now that we've setup the coroutine frame, the state could have changed.  Either the
+        // resources are acquired or the semaphore is marked as having waiters in the same step, so a release
+        // is guaranteed to see this waiter.
+        if (m_semaphore.m_shutdown.load(std::memory_order::acquire) ||
+            m_semaphore.try_acquire_or_mark_waiting(m_count))
         {
             return false;
         }
 
         m_awaiting_coroutine = awaiting_coroutine;
-        detail::awaiter_list_push(m_semaphore.m_acquire_waiters, this);
+        if (m_semaphore.m_tail_waiter == nullptr)
+        {
+            m_semaphore.m_head_waiter = this;
+        }
+        else
+        {
+            m_semaphore.m_tail_waiter->m_next = this;
+        }
+        m_semaphore.m_tail_waiter = this;
         return true;
     }
 
@@ -71,6 +87,7 @@ public:
 
     acquire_operation<max_value>*      m_next{nullptr};
     semaphore<max_value>&              m_semaphore;
+    std::ptrdiff_t                     m_count{1};
     std::coroutine_handle<> m_awaiting_coroutine;
 };
 
@@ -84,6 +101,22 @@ public:
         : m_counter(starting_value)
     { }
 
+    /**
+     * @param executor release() hands the waiters it satisfies to this executor instead of resuming them inline on
+     *                 the releasing thread.  A waiter is resumed inline if the executor has been shut down.
+     */
+    template<concepts::executor executor_type>
+    semaphore(std::ptrdiff_t starting_value, std::shared_ptr<executor_type> executor)
+        : m_counter(starting_value),
+          m_executor(std::move(executor)),
+          m_resume_on_executor(&resume_on<executor_type>)
+    {
+        if (m_executor == nullptr)
+        {
+            throw std::runtime_error{"semaphore cannot have a nullptr executor"};
+        }
+    }
+
     ~semaphore() { shutdown(); }
 
     semaphore(const semaphore&) = delete;
@@ -92,48 +125,65 @@ public:
     auto operator=(const semaphore&) noexcept -> semaphore& = delete;
     auto operator=(semaphore&&) noexcept -> semaphore&      = delete;
 
-    auto release() -> void
+    /**
+     * Releases count resources, the semaphore never holds more than max_value.  Waiters acquire in the order they
+     * arrived, every waiter at the front of the queue whose count can now be satisfied is resumed in this call.
+     * @param count The number of resources to release, at most max_value.
+     * @throw std::runtime_error If the count is outside of [0, max_value].
+     */
+    auto release(std::ptrdiff_t count = 1) -> void
     {
-        // If there are any waiters just transfer ownership to the waiter.
-        auto* waiter = detail::awaiter_list_pop(m_acquire_waiters);
-        if (waiter != nullptr)
+        if (count < 0 || count > max_value)
         {
-            waiter->m_awaiting_coroutine.resume();
+            throw std::runtime_error{"semaphore cannot release a count outside of [0, max_value]"};
         }
-        else
+
+        // Attempt to increment the counter only up to max_value.
+        auto current = m_counter.load(std::memory_order::acquire);
+        std::ptrdiff_t desired;
+        do
         {
-            // Attempt to increment the counter only up to max_value.
-            auto current = m_counter.load(std::memory_order::acquire);
-            do
-            {
-                if (current >= max_value)
-                {
-                    return;
-                }
-            } while (m_counter.compare_exchange_weak(current, current + 1, std::memory_order::acq_rel, std::memory_order::acquire));
+            desired = std::min(current & ~waiting_bit, max_value - count) + count;
+            desired |= current & waiting_bit;
+        } while (!m_counter.compare_exchange_weak(current, desired, std::memory_order::acq_rel, std::memory_order::acquire));
+
+        // If there are any waiters transfer ownership to as many of them as can be satisfied.
+        if ((current & waiting_bit) != 0)
+        {
+            wake_waiters();
         }
     }
 
     /**
-     * Acquires a resource from the semaphore, if the semaphore has no resources available then
-     * this will wait until a resource becomes available.
+     * Acquires count resources from the semaphore, if the semaphore does not have that many available or other
+     * waiters are queued ahead then this will wait until the resources become available.  Waiters are served
+     * first in first out so a large request is not starved by smaller ones.
+     * @param count The number of resources to acquire, at most max_value.
+     * @throw std::runtime_error If the count could never be satisfied.
      */
-    [[nodiscard]] auto acquire() -> detail::acquire_operation<max_value> { return detail::acquire_operation<max_value>{*this}; }
+    [[nodiscard]] auto acquire(std::ptrdiff_t count = 1) -> detail::acquire_operation<max_value>
+    {
+        if (count < 0 || count > max_value)
+        {
+            throw std::runtime_error{"semaphore cannot acquire a count outside of [0, max_value]"};
+        }
+        return detail::acquire_operation<max_value>{*this, count};
+    }
 
     /**
-     * Attemtps to acquire a resource if there is any resources available.
-     * @return True if the acquire operation was able to acquire a resource.
+     * Attemtps to acquire count resources if they are available and nobody is waiting for resources.
+     * @return True if the acquire operation was able to acquire the resources.
      */
-    auto try_acquire() -> bool
+    auto try_acquire(std::ptrdiff_t count = 1) -> bool
     {
         auto expected = m_counter.load(std::memory_order::acquire);
         do
         {
-            if (expected <= 0)
+            if ((expected & waiting_bit) != 0 || expected < count)
             {
                 return false;
             }
-        } while (!m_counter.compare_exchange_weak(expected, expected - 1, std::memory_order::acq_rel, std::memory_order::acquire));
+        } while (!m_counter.compare_exchange_weak(expected, expected - count, std::memory_order::acq_rel, std::memory_order::acquire));
 
         return true;
     }
@@ -146,7 +196,7 @@ public:
     /**
      * The current number of resources available in this semaphore.
      */
-    auto value() const noexcept -> std::ptrdiff_t { return m_counter.load(std::memory_order::acquire); }
+    auto value() const noexcept -> std::ptrdiff_t { return m_counter.load(std::memory_order::acquire) & ~waiting_bit; }
 
     /**
      * Stops the semaphore and will notify all release/acquire waiters to wake up in a failed state.
@@ -157,7 +207,14 @@ public:
         bool expected{false};
         if (m_shutdown.compare_exchange_strong(expected, true, std::memory_order::release, std::memory_order::relaxed))
         {
-            auto* waiter = detail::awaiter_list_pop_all(m_acquire_waiters);
+            detail::acquire_operation<max_value>* waiter{nullptr};
+            {
+                std::scoped_lock lk{m_mutex};
+                waiter        = std::exchange(m_head_waiter, nullptr);
+                m_tail_waiter = nullptr;
+                m_counter.fetch_and(~waiting_bit, std::memory_order::acq_rel);
+            }
+
             while (waiter != nullptr)
             {
                 auto* next = waiter->m_next;
@@ -170,11 +227,96 @@ public:
 private:
     friend class detail::acquire_operation<max_value>;
 
+    /// Set in the counter while the waiter list is not empty, only ever set or cleared while holding m_mutex.
+    static constexpr std::ptrdiff_t waiting_bit{std::ptrdiff_t{1} << (sizeof(std::ptrdiff_t) * 8 - 2)};
+    static_assert(max_value < waiting_bit, "semaphore max_value is too large");
+
+    template<typename executor_type>
+    static auto resume_on(void* executor, std::coroutine_handle<> handle) -> bool
+    {
+        return static_cast<executor_type*>(executor)->resume(handle);
+    }
+
+    /**
+     * Must hold m_mutex.
+     * @return True if the resources were acquired, otherwise the waiting bit is set and the caller must append
+     *         itself to the waiter list before releasing m_mutex.
+     */
+    auto try_acquire_or_mark_waiting(std::ptrdiff_t count) noexcept -> bool
+    {
+        auto current = m_counter.load(std::memory_order::acquire);
+        while (true)
+        {
+            bool acquired = (current & waiting_bit) == 0 && current >= count;
+            auto desired  = acquired ? current - count : current | waiting_bit;
+            if (m_counter.compare_exchange_weak(current, desired, std::memory_order::acq_rel, std::memory_order::acquire))
+            {
+                return acquired;
+            }
+        }
+    }
+
+    auto wake_waiters() -> void
+    {
+        // Collect every waiter that can be satisfied under a single acquisition of the waiter list's lock, each
+        // waiter's resources are taken before it is unlinked.
+        detail::acquire_operation<max_value>* to_resume{nullptr};
+        detail::acquire_operation<max_value>* to_resume_tail{nullptr};
+        {
+            std::scoped_lock lk{m_mutex};
+            auto current = m_counter.load(std::memory_order::acquire);
+            while (m_head_waiter != nullptr && (current & ~waiting_bit) >= m_head_waiter->m_count)
+            {
+                auto desired = current - m_head_waiter->m_count;
+                if (m_head_waiter->m_next == nullptr)
+                {
+                    desired &= ~waiting_bit;
+                }
+                if (!m_counter.compare_exchange_weak(current, desired, std::memory_order::acq_rel, std::memory_order::acquire))
+                {
+                    continue;
+                }
+
+                auto* waiter  = m_head_waiter;
+                m_head_waiter = waiter->m_next;
+                if (m_head_waiter == nullptr)
+                {
+                    m_tail_waiter = nullptr;
+                }
+
+                waiter->m_next = nullptr;
+                (to_resume_tail == nullptr ? to_resume : to_resume_tail->m_next) = waiter;
+                to_resume_tail = waiter;
+                current        = desired;
+            }
+        }
+
+        // A waiter lives in its coroutine's frame and a resumed waiter may destroy the semaphore, step past the
+        // waiter and off of the semaphore before resuming.
+        auto  resume_on_executor = m_resume_on_executor;
+        auto* executor           = m_executor.get();
+        while (to_resume != nullptr)
+        {
+            auto* next = to_resume->m_next;
+            if (resume_on_executor == nullptr || !resume_on_executor(executor, to_resume->m_awaiting_coroutine))
+            {
+                to_resume->m_awaiting_coroutine.resume();
+            }
+            to_resume = next;
+        }
+    }
+
     std::atomic<std::ptrdiff_t> m_counter;
-    /// @brief The current list of awaiters attempting to acquire the semaphore.
-    std::atomic<detail::acquire_operation<max_value>*> m_acquire_waiters{nullptr};
+    /// @brief Guards the list of waiters, only taken when an acquire has to wait or a release has waiters to wake.
+    std::mutex m_mutex;
+    /// @brief The current list of awaiters attempting to acquire the semaphore, in the order they arrived.
+    detail::acquire_operation<max_value>* m_head_waiter{nullptr};
+    detail::acquire_operation<max_value>* m_tail_waiter{nullptr};
     /// @brief Flag to denote that all waiters should be woken up with the shutdown result.
     std::atomic<bool> m_shutdown{false};
+    /// @brief When set the waiters satisfied by a release are resumed on this executor.
+    std::shared_ptr<void> m_executor{nullptr};
+    auto (*m_resume_on_executor)(void* executor, std::coroutine_handle<> handle) -> bool {nullptr};
 };
 
 } // namespace coro
@@ -2,15 +2,31 @@
 
 #include "coro/concepts/executor.hpp"
 
+#include <array>
 #include <atomic>
 #include <coroutine>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <span>
+#include <stdexcept>
 
 namespace coro
 {
 template<concepts::executor executor_type>
 class shared_mutex;
 
+enum class shared_mutex_policy
+{
+    /// Once a waiter has queued new shared lockers queue behind it, waiters acquire the lock in the order
+    /// they arrived so an exclusive waiter is never starved by a steady stream of shared users.
+    prefer_writers,
+    /// Shared lockers acquire the lock whenever it is not held exclusively, even past queued exclusive
+    /// waiters.  This gives read mostly users the most throughput but a steady stream of shared users can
+    /// starve the exclusive waiters.
+    prefer_readers
+};
+
 /**
  * A scoped RAII lock holder for a coro::shared_mutex.  It will call the appropriate unlock() or
  * unlock_shared() based on how the coro::shared_mutex was originally acquired, either shared or
@@ -78,8 +94,12 @@ public:
      * @param e The executor for when multiple shared waiters can be woken up at the same time,
      *          each shared waiter will be scheduled to immediately run on this executor in
      *          parallel.
+     * @param policy Whether queued exclusive waiters hold back new shared lockers.
      */
-    explicit shared_mutex(std::shared_ptr<executor_type> e) : m_executor(std::move(e))
+    explicit shared_mutex(
+        std::shared_ptr<executor_type> e, shared_mutex_policy policy = shared_mutex_policy::prefer_writers)
+        : m_executor(std::move(e)),
+          m_policy(policy)
     {
         if (m_executor == nullptr)
         {
@@ -112,21 +132,12 @@ public:
         auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
         {
             std::unique_lock lk{m_shared_mutex.m_mutex};
-            // Its possible the lock has been released between await_ready() and await_suspend(), double
-            // check and make sure we are not going to suspend when nobody holds the lock.
-            if (m_exclusive)
+            // Its possible the lock has been released between await_ready() and await_suspend(), either
+            // acquire it now or mark the mutex as having waiters in the same step so the releasing thread is
+            // guaranteed to see this waiter.
+            if (m_shared_mutex.try_lock_or_mark_waiting(m_exclusive))
             {
-                if (m_shared_mutex.try_lock_locked(lk))
-                {
-                    return false;
-                }
-            }
-            else
-            {
-                if (m_shared_mutex.try_lock_shared_locked(lk))
-                {
-                    return false;
-                }
+                return false;
             }
 
             // For sure the lock is currently held in a manner that it cannot be acquired, suspend ourself
@@ -143,12 +154,14 @@ public:
                 m_shared_mutex.m_tail_waiter         = this;
             }
 
-            // If this is an exclusive lock acquire then mark it as so so that shared locks after this
-            // exclusive one will also suspend so this exclusive lock doens't get starved.
             if (m_exclusive)
             {
                 ++m_shared_mutex.m_exclusive_waiters;
             }
+            else
+            {
+                ++m_shared_mutex.m_shared_waiters;
+            }
 
             m_awaiting_coroutine = awaiting_coroutine;
             return true;
@@ -168,8 +181,8 @@ public:
     };
 
     /**
-     * Locks the mutex in a shared state.  If there are any exclusive waiters then the shared waiters
-     * will also wait so the exclusive waiters are not starved.
+     * Locks the mutex in a shared state.  With shared_mutex_policy::prefer_writers if there are any
+     * waiters then the shared waiters will also wait so the exclusive waiters are not starved.
      */
     [[nodiscard]] auto lock_shared() -> lock_operation { return lock_operation{*this, false}; }
 
@@ -179,28 +192,33 @@ public:
     [[nodiscard]] auto lock() -> lock_operation { return lock_operation{*this, true}; }
 
     /**
+     * Lock free unless the mutex is held exclusively or, with shared_mutex_policy::prefer_writers, has
+     * waiters, shared users only contend on the mutex's state word.
      * @return True if the lock could immediately be acquired in a shared state.
      */
-    auto try_lock_shared() -> bool
+    auto try_lock_shared() noexcept -> bool
     {
-        // To acquire the shared lock the state must be one of two states:
-        //   1) unlocked
-        //   2) shared locked with zero exclusive waiters
-        //          Zero exclusive waiters prevents exclusive starvation if shared locks are
-        //          always continuously happening.
-
-        std::unique_lock lk{m_mutex};
-        return try_lock_shared_locked(lk);
+        auto state = m_state.load(std::memory_order::relaxed);
+        while (can_lock_shared(state))
+        {
+            if (m_state.compare_exchange_weak(
+                    state, state + 1, std::memory_order::acquire, std::memory_order::relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
     }
 
     /**
      * @return True if the lock could immediately be acquired in an exclusive state.
      */
-    auto try_lock() -> bool
+    auto try_lock() noexcept -> bool
     {
-        // To acquire the exclusive lock the state must be unlocked.
-        std::unique_lock lk{m_mutex};
-        return try_lock_locked(lk);
+        // To acquire the exclusive lock the state must be unlocked with no waiters.
+        std::uint64_t expected{0};
+        return m_state.compare_exchange_strong(
+            expected, exclusive_bit, std::memory_order::acquire, std::memory_order::relaxed);
     }
 
     /**
@@ -213,20 +231,11 @@ public:
      */
     auto unlock_shared() -> void
     {
-        std::unique_lock lk{m_mutex};
-        --m_shared_users;
-
-        // Only wake waiters from shared state if all shared users have completed.
-        if (m_shared_users == 0)
+        // Only the last shared user wakes waiters, the rest never touch the waiter list.
+        if (m_state.fetch_sub(1, std::memory_order::acq_rel) == (waiting_bit | 1))
         {
-            if (m_head_waiter != nullptr)
-            {
-                wake_waiters(lk);
-            }
-            else
-            {
-                m_state = state::unlocked;
-            }
+            std::unique_lock lk{m_mutex};
+            wake_waiters(lk);
         }
     }
 
@@ -238,88 +247,99 @@ public:
      */
     auto unlock() -> void
     {
-        std::unique_lock lk{m_mutex};
-        if (m_head_waiter != nullptr)
+        std::uint64_t expected{exclusive_bit};
+        if (!m_state.compare_exchange_strong(expected, 0, std::memory_order::release, std::memory_order::relaxed))
         {
+            // The waiting bit is only cleared under m_mutex so there are still waiters to wake.
+            std::unique_lock lk{m_mutex};
+            m_state.fetch_and(~exclusive_bit, std::memory_order::acq_rel);
             wake_waiters(lk);
         }
-        else
-        {
-            m_state = state::unlocked;
-        }
     }
 
 private:
     friend struct lock_operation;
 
-    enum class state
-    {
-        unlocked,
-        locked_shared,
-        locked_exclusive
-    };
+    /// The state word holds the number of shared users in its low bits.
+    static constexpr std::uint64_t exclusive_bit{std::uint64_t{1} << 63};
+    /// Set while the waiter list is not empty, only ever changed while holding m_mutex.
+    static constexpr std::uint64_t waiting_bit{std::uint64_t{1} << 62};
+
+    /// Shared waiters are handed to the executor in batches of this size.
+    static constexpr std::size_t resume_batch_size{32};
 
     /// This executor is for resuming multiple shared waiters.
     std::shared_ptr<executor_type> m_executor{nullptr};
+    shared_mutex_policy            m_policy{shared_mutex_policy::prefer_writers};
 
-    std::mutex m_mutex;
+    std::atomic<std::uint64_t> m_state{0};
 
-    state m_state{state::unlocked};
+    /// Guards the waiter list, lock and unlock only take it when the lock must wait or has waiters.
+    std::mutex m_mutex;
 
-    /// The current number of shared users that have acquired the lock.
-    uint64_t m_shared_users{0};
-    /// The current number of exclusive waiters waiting to acquire the lock.  This is used to block
-    /// new incoming shared lock attempts so the exclusive waiter is not starved.
+    /// The current number of exclusive waiters waiting to acquire the lock.
     uint64_t m_exclusive_waiters{0};
+    /// The current number of shared waiters waiting to acquire the lock.
+    uint64_t m_shared_waiters{0};
 
     lock_operation* m_head_waiter{nullptr};
     lock_operation* m_tail_waiter{nullptr};
 
-    auto try_lock_shared_locked(std::unique_lock<std::mutex>& lk) -> bool
+    auto can_lock_shared(std::uint64_t state) const noexcept -> bool
     {
-        if (m_state == state::unlocked)
-        {
-            // If the shared mutex is unlocked put it into shared mode and add ourself as using the lock.
-            m_state = state::locked_shared;
-            ++m_shared_users;
-            lk.unlock();
-            return true;
-        }
-        else if (m_state == state::locked_shared && m_exclusive_waiters == 0)
+        if (m_policy == shared_mutex_policy::prefer_readers)
         {
-            // If the shared mutex is in a shared locked state and there are no exclusive waiters
-            // the add ourself as using the lock.
-            ++m_shared_users;
-            lk.unlock();
-            return true;
+            return (state & exclusive_bit) == 0;
         }
-
-        // If the lock is in shared mode but there are exclusive waiters then we will also wait so
-        // the writers are not starved.
-
-        // If the lock is in exclusive mode already then we need to wait.
-
-        return false;
+        return (state & (exclusive_bit | waiting_bit)) == 0;
     }
 
-    auto try_lock_locked(std::unique_lock<std::mutex>& lk) -> bool
+    /**
+     * Must hold m_mutex.
+     * @return True if the lock was acquired, otherwise the waiting bit is set and the caller must append
+     *         itself to the waiter list before releasing m_mutex.
+     */
+    auto try_lock_or_mark_waiting(bool exclusive) noexcept -> bool
     {
-        if (m_state == state::unlocked)
+        auto state = m_state.load(std::memory_order::relaxed);
+        while (true)
         {
-            m_state = state::locked_exclusive;
-            lk.unlock();
-            return true;
+            bool acquire = exclusive ? state == 0 : can_lock_shared(state);
+            auto desired = acquire ? (exclusive ? exclusive_bit : state + 1) : (state | waiting_bit);
+            if (m_state.compare_exchange_weak(state, desired, std::memory_order::acq_rel, std::memory_order::relaxed))
+            {
+                return acquire;
+            }
         }
-        return false;
     }
 
+    /**
+     * Hands the lock to the next waiters, called by the last user to release it while the waiting bit is set.
+     * With shared_mutex_policy::prefer_readers shared users can acquire the lock again before m_mutex is
+     * taken, the waiters are then left for the last of them to wake.
+     */
     auto wake_waiters(std::unique_lock<std::mutex>& lk) -> void
     {
-        // First determine what the next lock state will be based on the first waiter.
-        if (m_head_waiter->m_exclusive)
+        if (m_head_waiter == nullptr)
+        {
+            return;
+        }
+
+        // First determine what the next lock state will be based on the first waiter, with prefer_readers
+        // every shared waiter is woken ahead of the exclusive waiters.
+        bool wake_shared = m_policy == shared_mutex_policy::prefer_readers ? m_shared_waiters > 0
+                                                                           : !m_head_waiter->m_exclusive;
+        if (!wake_shared)
         {
-            // If its exclusive then only this waiter can be woken up.
-            m_state                   = state::locked_exclusive;
+            // If its exclusive then only this waiter can be woken up, and only if nobody holds the lock.
+            std::uint64_t expected{waiting_bit};
+            std::uint64_t desired = exclusive_bit | (m_head_waiter->m_next != nullptr ? waiting_bit : 0);
+            if (!m_state.compare_exchange_strong(
+                    expected, desired, std::memory_order::acq_rel, std::memory_order::relaxed))
+            {
+                return;
+            }
+
             lock_operation* to_resume = m_head_waiter;
             m_head_waiter             = m_head_waiter->m_next;
             --m_exclusive_waiters;
@@ -331,29 +351,84 @@ private:
             // Since this is an exclusive lock waiting we can resume it directly.
             lk.unlock();
             to_resume->m_awaiting_coroutine.resume();
+            return;
         }
-        else
+
+        // Count the shared waiters to wake so they acquire the lock in one step before any is unlinked.
+        // With prefer_writers that is the run of shared waiters at the head of the list.
+        uint64_t to_wake{m_shared_waiters};
+        if (m_policy == shared_mutex_policy::prefer_writers)
         {
-            // If its shared then we will scan forward and awake all shared waiters onto the given
-            // thread pool so they can run in parallel.
-            m_state = state::locked_shared;
-            do
+            to_wake = 0;
+            for (auto* waiter = m_head_waiter; waiter != nullptr && !waiter->m_exclusive; waiter = waiter->m_next)
             {
-                lock_operation* to_resume = m_head_waiter;
-                m_head_waiter             = m_head_waiter->m_next;
-                if (m_head_waiter == nullptr)
+                ++to_wake;
+            }
+        }
+        bool remaining = m_shared_waiters + m_exclusive_waiters > to_wake;
+
+        auto state = m_state.load(std::memory_order::relaxed);
+        do
+        {
+            if ((state & exclusive_bit) != 0)
+            {
+                return;
+            }
+        } while (!m_state.compare_exchange_weak(
+            state,
+            ((state & ~waiting_bit) + to_wake) | (remaining ? waiting_bit : 0),
+            std::memory_order::acq_rel,
+            std::memory_order::relaxed));
+        m_shared_waiters -= to_wake;
+
+        // Unlink the shared waiters and hand them to the executor in batches so they run in parallel, a
+        // waiter lives in its coroutine's frame so it is unlinked before it is handed off.
+        std::array<std::coroutine_handle<>, resume_batch_size> handles{};
+        std::size_t                                            count{0};
+        lock_operation*                                        prev{nullptr};
+        auto*                                                  waiter = m_head_waiter;
+        while (to_wake > 0)
+        {
+            auto* next = waiter->m_next;
+            if (waiter->m_exclusive)
+            {
+                prev = waiter;
+            }
+            else
+            {
+                (prev == nullptr ? m_head_waiter : prev->m_next) = next;
+                if (next == nullptr)
                 {
-                    m_tail_waiter = nullptr;
+                    m_tail_waiter = prev;
                 }
-                ++m_shared_users;
+                --to_wake;
 
-                m_executor->resume(to_resume->m_awaiting_coroutine);
-            } while (m_head_waiter != nullptr && !m_head_waiter->m_exclusive);
+                handles[count++] = waiter->m_awaiting_coroutine;
+                if (count == handles.size() || to_wake == 0)
+                {
+                    resume_shared_waiters(std::span{handles.data(), count});
+                    count = 0;
+                }
+            }
+            waiter = next;
+        }
 
-            // Cannot unlock until the entire set of shared waiters has been traversed.  I think this
-            // makes more sense than allocating space for all the shared waiters, unlocking, and then
-            // resuming in a batch?
-            lk.unlock();
+        // The waiter list must stay consistent until every shared waiter has been handed off.
+        lk.unlock();
+    }
+
+    auto resume_shared_waiters(std::span<std::coroutine_handle<>> handles) -> void
+    {
+        if constexpr (requires { m_executor->resume(handles); })
+        {
+            m_executor->resume(handles);
+        }
+        else
+        {
+            for (auto handle : handles)
+            {
+                m_executor->resume(handle);
+            }
         }
     }
 };
@@ -2,11 +2,14 @@
 
 #include "coro/attribute.hpp"
 #include "coro/concepts/awaitable.hpp"
+#include "coro/frame_allocator.hpp"
 
 #include <atomic>
-#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <exception>
-#include <mutex>
+#include <memory>
+#include <new>
 #include <stdexcept>
 #include <variant>
 
@@ -24,6 +27,10 @@ struct unset_return_value
     auto operator=(const unset_return_value&)     = delete;
 };
 
+/**
+ * Blocks the thread calling sync_wait until its awaitable completes.  The waiter spins briefly and then
+ * sleeps on the state with std::atomic::wait, the setter only issues the wake when the waiter is asleep.
+ */
 class sync_wait_event
 {
 public:
@@ -39,16 +46,50 @@ public:
     auto wait() noexcept -> void;
 
 private:
-    std::mutex              m_mutex;
-    std::condition_variable m_cv;
-    std::atomic<bool>       m_set{false};
+    enum class state : uint32_t
+    {
+        unset,
+        set,
+        /// The waiter is asleep, or about to be, and must be notified.
+        waiting
+    };
+
+    /// The number of times wait() checks the state before going to sleep.
+    static constexpr std::size_t spin_count{128};
+
+    std::atomic<state> m_state{state::unset};
 };
 
-class sync_wait_task_promise_base
+/**
+ * The storage sync_wait reserves on the calling thread's stack for its wrapper coroutine frame, the frame
+ * has to outlive the awaitable it drives and that is exactly the duration of the sync_wait call.
+ */
+struct sync_wait_frame_buffer
+{
+    /// Large enough for the wrapper frame around a task or when_all, larger frames use the frame allocator.
+    static constexpr std::size_t size{512};
+
+    alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) std::byte m_bytes[size];
+};
+
+class sync_wait_task_promise_base : public pooled_frame
 {
 public:
     sync_wait_task_promise_base() noexcept = default;
 
+    /**
+     * Places the next wrapper frame created on the calling thread in the given buffer, if it fits.  The
+     * buffer is consumed by that frame's allocation so a nested sync_wait never reuses it.
+     */
+    static auto frame_buffer(sync_wait_frame_buffer& buffer) noexcept -> void;
+
+    /**
+     * A coroutine frame cannot be placed on the stack directly, instead the frame takes the buffer set by
+     * frame_buffer() and falls back to pooled_frame when there is none or the frame does not fit.
+     */
+    static auto operator new(std::size_t size) -> void*;
+    static auto operator delete(void* ptr, std::size_t size) noexcept -> void;
+
     auto initial_suspend() noexcept -> std::suspend_always { return {}; }
 
 protected:
@@ -317,8 +358,11 @@ template<
     typename return_type = typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>
 auto sync_wait(awaitable_type&& a) -> decltype(auto)
 {
-    detail::sync_wait_event e{};
-    auto                    task = detail::make_sync_wait_task(std::forward<awaitable_type>(a));
+    // The buffer must be declared before the task, the task destroys its frame into it.
+    detail::sync_wait_frame_buffer buffer;
+    detail::sync_wait_event        e{};
+    detail::sync_wait_task_promise_base::frame_buffer(buffer);
+    auto task = detail::make_sync_wait_task(std::forward<awaitable_type>(a));
     task.promise().start(e);
     e.wait();
 
@@ -1,8 +1,15 @@
 #pragma once
 
+#include "coro/frame_allocator.hpp"
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+    #include "coro/async_stack.hpp"
+#endif
+
 #include <coroutine>
+#include <cstdint>
 #include <exception>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <variant>
 
@@ -13,7 +20,30 @@ class task;
 
 namespace detail
 {
-struct promise_base
+class task_local_storage;
+
+/// Task local storage is reference counted by the tasks sharing it, see coro/task_local.hpp.
+auto retain_task_locals(const task_local_storage* storage) noexcept -> void;
+auto release_task_locals(const task_local_storage* storage) noexcept -> void;
+
+/**
+ * Notified in place of a continuation when a task completes.  Combinators such as when_all and when_any
+ * attach to the tasks they were given through this rather than wrapping each one in another coroutine.
+ */
+struct completion_hook
+{
+    /**
+     * @param hook The hook that was attached to the task.
+     * @param completed The task's coroutine, suspended at its final suspend point.
+     * @return The coroutine to transfer to, std::noop_coroutine() for none.
+     */
+    using notify_fn = auto (*)(completion_hook& hook, std::coroutine_handle<> completed) noexcept
+        -> std::coroutine_handle<>;
+
+    notify_fn m_notify{nullptr};
+};
+
+struct promise_base : public pooled_frame
 {
     friend struct final_awaitable;
     struct final_awaitable
@@ -25,9 +55,18 @@ struct promise_base
         {
             // If there is a continuation call it, otherwise this is the end of the line.
             auto& promise = coroutine.promise();
-            if (promise.m_continuation != nullptr)
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+            promise.async_frame().detach();
+            async_stack::current(nullptr);
+#endif
+            if (auto* hook = promise.hook(); hook != nullptr)
             {
-                return promise.m_continuation;
+                // The hook may destroy this coroutine, nothing can touch the promise afterwards.
+                return hook->m_notify(*hook, coroutine);
+            }
+            else if (promise.m_continuation != nullptr)
+            {
+                return std::coroutine_handle<>::from_address(promise.m_continuation);
             }
             else
             {
@@ -42,18 +81,137 @@ struct promise_base
     };
 
     promise_base() noexcept = default;
-    ~promise_base()         = default;
+    ~promise_base()
+    {
+        if (m_locals != nullptr)
+        {
+            release_task_locals(m_locals);
+        }
+    }
+
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+    struct initial_awaitable
+    {
+        auto await_ready() const noexcept -> bool { return false; }
 
+        auto await_suspend(std::coroutine_handle<>) noexcept -> void {}
+
+        auto await_resume() noexcept -> void { async_stack::current(m_frame); }
+
+        async_stack_frame* m_frame;
+    };
+
+    auto initial_suspend() noexcept { return initial_awaitable{&m_async_frame}; }
+
+    template<typename awaitable_type>
+    auto await_transform(awaitable_type&& awaitable)
+    {
+        return detail::make_async_stack_awaiter(std::forward<awaitable_type>(awaitable), m_async_frame);
+    }
+
+    auto async_frame() noexcept -> async_stack_frame& { return m_async_frame; }
+#else
     auto initial_suspend() noexcept { return std::suspend_always{}; }
+#endif
 
     auto final_suspend() noexcept { return final_awaitable{}; }
 
-    auto continuation(std::coroutine_handle<> continuation) noexcept -> void { m_continuation = continuation; }
+    auto continuation(std::coroutine_handle<> continuation) noexcept -> void
+    {
+        m_continuation = continuation.address();
+    }
+
+    /**
+     * @return The coroutine resumed when this task completes, nullptr if there is none or a completion hook is
+     *         attached instead.
+     */
+    auto continuation() const noexcept -> std::coroutine_handle<>
+    {
+        return hook() == nullptr ? std::coroutine_handle<>::from_address(m_continuation) : nullptr;
+    }
+
+    /**
+     * Attaches a completion hook in place of a continuation, the hook is notified when the task completes.
+     */
+    auto completion(completion_hook& hook) noexcept -> void
+    {
+        m_continuation = reinterpret_cast<void*>(reinterpret_cast<std::uintptr_t>(&hook) | hook_tag);
+    }
 
 protected:
-    std::coroutine_handle<> m_continuation{nullptr};
+    /// Coroutine frames and hooks are always at least pointer aligned, the low bit marks a hook.
+    static constexpr std::uintptr_t hook_tag{1};
+
+    auto hook() const noexcept -> completion_hook*
+    {
+        auto value = reinterpret_cast<std::uintptr_t>(m_continuation);
+        return (value & hook_tag) ? reinterpret_cast<completion_hook*>(value & ~hook_tag) : nullptr;
+    }
+
+    /// The awaiting coroutine's address, or a completion_hook tagged with hook_tag.
+    void* m_continuation{nullptr};
+
+public:
+    /**
+     * @return The task locals visible to this task, nullptr if none were ever set, see coro::task_local.
+     */
+    auto task_locals() const noexcept -> const task_local_storage* { return m_locals; }
+
+    /**
+     * Replaces this task's locals, the task takes its own reference to the storage.
+     */
+    auto task_locals(const task_local_storage* locals) noexcept -> void
+    {
+        if (locals != nullptr)
+        {
+            retain_task_locals(locals);
+        }
+        if (m_locals != nullptr)
+        {
+            release_task_locals(m_locals);
+        }
+        m_locals = locals;
+    }
+
+    /**
+     * Shares the parent's task locals with this task unless it was already given its own.
+     */
+    auto inherit_task_locals(const promise_base& parent) noexcept -> void
+    {
+        if (parent.m_locals != nullptr && m_locals == nullptr)
+        {
+            retain_task_locals(parent.m_locals);
+            m_locals = parent.m_locals;
+        }
+    }
+
+private:
+    /// Immutable once shared, setting a task local replaces it with a modified copy.
+    const task_local_storage* m_locals{nullptr};
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+    /// Linked to the awaiting task's frame whenever this task is awaited.
+    async_stack_frame m_async_frame{};
+#endif
 };
 
+/**
+ * Called by anything that starts a task on behalf of an awaiting coroutine.  If that coroutine is itself a task
+ * the started task inherits its task locals and, with LIBCORO_FEATURE_ASYNC_STACK, links its async stack frame
+ * to the awaiting task's.
+ */
+template<typename awaiting_promise_type>
+auto link_awaiting_task(promise_base& child, std::coroutine_handle<awaiting_promise_type> awaiting_coroutine) noexcept
+    -> void
+{
+    if constexpr (std::is_base_of_v<promise_base, awaiting_promise_type>)
+    {
+        child.inherit_task_locals(awaiting_coroutine.promise());
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+        child.async_frame().parent(&awaiting_coroutine.promise().async_frame());
+#endif
+    }
+}
+
 template<typename return_type>
 struct promise final : public promise_base
 {
@@ -240,8 +398,11 @@ public:
 
         auto await_ready() const noexcept -> bool { return !m_coroutine || m_coroutine.done(); }
 
-        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> std::coroutine_handle<>
+        template<typename awaiting_promise_type>
+        auto await_suspend(std::coroutine_handle<awaiting_promise_type> awaiting_coroutine) noexcept
+            -> std::coroutine_handle<>
         {
+            detail::link_awaiting_task(m_coroutine.promise(), awaiting_coroutine);
             m_coroutine.promise().continuation(awaiting_coroutine);
             return m_coroutine;
         }
@@ -332,6 +493,11 @@ public:
 
     auto handle() -> coroutine_handle { return m_coroutine; }
 
+    /**
+     * Gives up ownership of the coroutine, the caller becomes responsible for destroying it.
+     */
+    [[nodiscard]] auto release() noexcept -> coroutine_handle { return std::exchange(m_coroutine, nullptr); }
+
 private:
     coroutine_handle m_coroutine{nullptr};
 };
@@ -341,11 +507,17 @@ namespace detail
 template<typename return_type>
 inline auto promise<return_type>::get_return_object() noexcept -> task<return_type>
 {
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+    async_frame().attach(coroutine_handle::from_promise(*this));
+#endif
     return task<return_type>{coroutine_handle::from_promise(*this)};
 }
 
 inline auto promise<void>::get_return_object() noexcept -> task<>
 {
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+    async_frame().attach(coroutine_handle::from_promise(*this));
+#endif
     return task<>{coroutine_handle::from_promise(*this)};
 }
 
@@ -0,0 +1,308 @@
+#pragma once
+
+// EMSCRIPTEN does not currently support std::jthread or std::stop_source|token.
+#ifndef EMSCRIPTEN
+
+    #include "coro/concepts/executor.hpp"
+    #include "coro/task.hpp"
+
+    #include <atomic>
+    #include <coroutine>
+    #include <cstdint>
+    #include <exception>
+    #include <memory>
+    #include <mutex>
+    #include <stdexcept>
+    #include <stop_token>
+    #include <utility>
+
+namespace coro
+{
+/**
+ * A task_group owns a set of child tasks running concurrently on an executor and lets the spawning
+ * coroutine wait for all of them, which io_scheduler::spawn cannot since it forgets about the task as soon
+ * as it is started.
+ *
+ *     coro::task_group group{scheduler};
+ *     group.spawn(handle_connection(client, group.get_stop_token()));
+ *     co_await group.join();
+ *
+ * The first exception thrown by a child is kept and rethrown by join(), it also requests a stop on the
+ * group's stop source so the other children can observe it and finish early.  Children that are still
+ * waiting for a concurrency slot when a stop is requested are destroyed without ever running.
+ *
+ * Bookkeeping is intrusive, each child is attached to the group through a completion hook so it costs
+ * nothing beyond its own frame, a child waiting for a concurrency slot is linked to the next one through
+ * its unused continuation.  The group must be joined before it is destroyed.
+ */
+template<concepts::executor executor_type>
+class task_group : private detail::completion_hook
+{
+public:
+    struct join_operation
+    {
+        explicit join_operation(task_group& group) noexcept : m_group(group) {}
+
+        auto await_ready() const noexcept -> bool { return m_group.empty(); }
+
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+        {
+            // Give up the group's own reference, the child that drops the count to zero resumes the joiner.
+            m_group.m_joiner = awaiting_coroutine;
+            if (m_group.m_size.fetch_sub(1, std::memory_order::acq_rel) == 1)
+            {
+                m_group.m_size.fetch_add(1, std::memory_order::relaxed);
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * @throw The first exception thrown by any child since the group was last joined.
+         */
+        auto await_resume() -> void
+        {
+            std::exception_ptr exception{nullptr};
+            {
+                std::scoped_lock lk{m_group.m_mutex};
+                exception = std::exchange(m_group.m_exception, nullptr);
+            }
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        task_group& m_group;
+    };
+
+    /**
+     * @param executor The executor the children are scheduled on.
+     * @param max_concurrency The maximum number of children running at once, zero is unlimited.
+     */
+    explicit task_group(std::shared_ptr<executor_type> executor, std::size_t max_concurrency = 0)
+        : completion_hook{&notify_child_completed},
+          m_executor(std::move(executor)),
+          m_max_concurrency(max_concurrency)
+    {
+        if (m_executor == nullptr)
+        {
+            throw std::runtime_error{"task_group cannot have a nullptr executor"};
+        }
+    }
+
+    task_group(const task_group&)                    = delete;
+    task_group(task_group&&)                         = delete;
+    auto operator=(const task_group&) -> task_group& = delete;
+    auto operator=(task_group&&) -> task_group&      = delete;
+    ~task_group()                                    = default;
+
+    /**
+     * Schedules the task on the group's executor, or parks it until a concurrency slot frees up.  If the
+     * executor refuses the task, for example because it is shut down, the task is destroyed without running
+     * and join() rethrows a std::runtime_error.
+     * @param task The child task, it is owned by the group until it completes.
+     * @return False if a stop was already requested, the task is destroyed without running.
+     */
+    auto spawn(coro::task<void>&& task) -> bool
+    {
+        if (m_stop_source.stop_requested())
+        {
+            return false;
+        }
+
+        auto child = task.release();
+        m_size.fetch_add(1, std::memory_order::release);
+        if (m_max_concurrency != 0)
+        {
+            std::scoped_lock lk{m_mutex};
+            if (m_running == m_max_concurrency)
+            {
+                if (m_parked_tail == nullptr)
+                {
+                    m_parked_head = child;
+                }
+                else
+                {
+                    m_parked_tail.promise().continuation(child);
+                }
+                m_parked_tail = child;
+                return true;
+            }
+            ++m_running;
+        }
+
+        start(child);
+        return true;
+    }
+
+    /**
+     * Must be awaited, completes once every child spawned so far has completed.  Children may spawn more
+     * children while the group is being joined, spawning from elsewhere must not race the join completing.
+     */
+    [[nodiscard]] auto join() noexcept -> join_operation { return join_operation{*this}; }
+
+    /**
+     * Requests a stop on the group's stop source, children waiting for a concurrency slot are destroyed
+     * without running and running children that observe the token can return early.
+     */
+    auto request_stop() noexcept -> bool
+    {
+        auto requested = m_stop_source.request_stop();
+
+        child_handle parked{nullptr};
+        {
+            std::scoped_lock lk{m_mutex};
+            parked        = std::exchange(m_parked_head, nullptr);
+            m_parked_tail = nullptr;
+        }
+
+        while (parked != nullptr)
+        {
+            auto next = child_handle::from_address(parked.promise().continuation().address());
+            parked.destroy();
+            parked = next;
+            if (drop_child())
+            {
+                m_joiner.resume();
+            }
+        }
+        return requested;
+    }
+
+    auto get_stop_token() const noexcept -> std::stop_token { return m_stop_source.get_token(); }
+
+    /**
+     * @return The number of children that have been spawned and not yet completed.
+     */
+    auto size() const noexcept -> std::size_t { return m_size.load(std::memory_order::acquire) - 1; }
+
+    auto empty() const noexcept -> bool { return size() == 0; }
+
+private:
+    using child_handle = std::coroutine_handle<coro::task<void>::promise_type>;
+
+    static auto notify_child_completed(completion_hook& hook, std::coroutine_handle<> completed) noexcept
+        -> std::coroutine_handle<>
+    {
+        auto& group = static_cast<task_group&>(hook);
+        auto  child = child_handle::from_address(completed.address());
+        try
+        {
+            child.promise().result();
+        }
+        catch (...)
+        {
+            group.set_exception(std::current_exception());
+        }
+        child.destroy();
+
+        // The completed child still holds its reference, the group is alive until drop_child() below.
+        group.start(group.release_slot());
+        return group.drop_child() ? group.m_joiner : std::noop_coroutine();
+    }
+
+    /**
+     * Attaches the child to the group and schedules it on the executor.  A child the executor refuses, or
+     * that is given a slot after a stop was requested, is destroyed without running and its slot is passed on.
+     */
+    auto start(child_handle child) noexcept -> void
+    {
+        while (child != nullptr)
+        {
+            child.promise().completion(*this);
+            if (!m_stop_source.stop_requested() && m_executor->resume(child))
+            {
+                return;
+            }
+
+            if (!m_stop_source.stop_requested())
+            {
+                set_exception(
+                    std::make_exception_ptr(std::runtime_error{"task_group executor refused to schedule a child"}));
+            }
+            child.destroy();
+            child = release_slot();
+            if (drop_child())
+            {
+                m_joiner.resume();
+            }
+        }
+    }
+
+    /**
+     * Frees the finished child's concurrency slot.
+     * @return The oldest parked child, the slot is handed to it, or nullptr if none are parked.
+     */
+    auto release_slot() noexcept -> child_handle
+    {
+        if (m_max_concurrency == 0)
+        {
+            return nullptr;
+        }
+
+        std::scoped_lock lk{m_mutex};
+        auto             next = m_parked_head;
+        if (next == nullptr)
+        {
+            --m_running;
+            return nullptr;
+        }
+
+        m_parked_head = child_handle::from_address(next.promise().continuation().address());
+        if (m_parked_head == nullptr)
+        {
+            m_parked_tail = nullptr;
+        }
+        return next;
+    }
+
+    /**
+     * @return True if this was the last child and the joiner must be resumed.
+     */
+    auto drop_child() noexcept -> bool
+    {
+        if (m_size.fetch_sub(1, std::memory_order::acq_rel) == 1)
+        {
+            // The joiner is suspended until this resumes it, so the group is still alive here.
+            m_size.fetch_add(1, std::memory_order::relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    auto set_exception(std::exception_ptr exception) noexcept -> void
+    {
+        {
+            std::scoped_lock lk{m_mutex};
+            if (m_exception != nullptr)
+            {
+                return;
+            }
+            m_exception = std::move(exception);
+        }
+        request_stop();
+    }
+
+    /// The executor the children run on.
+    std::shared_ptr<executor_type> m_executor;
+    /// The maximum number of concurrently running children, zero is unlimited.
+    std::size_t m_max_concurrency;
+    /// The number of spawned children that have not completed, plus one held by the group until joined.
+    std::atomic<std::size_t> m_size{1};
+    /// The coroutine waiting in join(), only read by the child that completes the join.
+    std::coroutine_handle<> m_joiner{nullptr};
+    /// Requested on the first exception or by request_stop().
+    std::stop_source m_stop_source{};
+
+    /// Guards the parked children, the running count and the first exception.
+    std::mutex         m_mutex{};
+    std::size_t        m_running{0};
+    child_handle       m_parked_head{nullptr};
+    child_handle       m_parked_tail{nullptr};
+    std::exception_ptr m_exception{nullptr};
+};
+
+} // namespace coro
+
+#endif // EMSCRIPTEN
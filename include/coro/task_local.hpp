@@ -0,0 +1,171 @@
+#pragma once
+
+#include "coro/task.hpp"
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace coro
+{
+template<typename value_type>
+class task_local;
+
+namespace detail
+{
+/**
+ * The values of every task_local set along a chain of tasks, indexed by each task_local's slot.  The storage
+ * is shared by a task and the tasks it awaits and is never modified once shared, setting a value in a task
+ * replaces its storage with a modified copy so the change is only seen by that task and its later children.
+ */
+class task_local_storage
+{
+public:
+    /// Each task_local claims a slot when it is constructed, slots are never reused.
+    static auto next_slot() noexcept -> std::size_t;
+
+    auto get(std::size_t slot) const noexcept -> const void*
+    {
+        return slot < m_values.size() ? m_values[slot].get() : nullptr;
+    }
+
+    /**
+     * @return A copy of the storage, or of empty storage, with the slot's value replaced.  The caller owns the
+     *         only reference to it.
+     */
+    static auto with(const task_local_storage* storage, std::size_t slot, std::shared_ptr<const void> value)
+        -> const task_local_storage*;
+
+private:
+    friend auto retain_task_locals(const task_local_storage* storage) noexcept -> void;
+    friend auto release_task_locals(const task_local_storage* storage) noexcept -> void;
+
+    std::vector<std::shared_ptr<const void>> m_values{};
+    mutable std::atomic<std::size_t>         m_references{1};
+};
+
+} // namespace detail
+
+/**
+ * A view of the awaiting task's task locals, see this_task::locals().  It refers to the task's promise and
+ * must only be used from within that task.
+ */
+class task_locals
+{
+public:
+    explicit task_locals(detail::promise_base& promise) noexcept : m_promise(&promise) {}
+
+    /**
+     * @return The value the key was last set to in this task or the task that started it, nullptr if it was never
+     *         set.  The pointer is valid until the key is next set in this task.
+     */
+    template<typename value_type>
+    auto get(const task_local<value_type>& key) const noexcept -> const value_type*
+    {
+        const auto* storage = m_promise->task_locals();
+        return storage != nullptr ? static_cast<const value_type*>(storage->get(key.m_slot)) : nullptr;
+    }
+
+    /**
+     * Sets the key for this task and every task it starts from now on, tasks already started keep the value
+     * they inherited and a value set by a child task is never seen by its parent.
+     */
+    template<typename value_type, typename arg_type>
+    auto set(const task_local<value_type>& key, arg_type&& value) -> void
+    {
+        const auto* storage = detail::task_local_storage::with(
+            m_promise->task_locals(), key.m_slot, std::make_shared<const value_type>(std::forward<arg_type>(value)));
+        m_promise->task_locals(storage);
+        detail::release_task_locals(storage);
+    }
+
+private:
+    template<typename return_type>
+    friend auto with_task_locals(const task_locals& locals, task<return_type> t) noexcept -> task<return_type>;
+
+    detail::promise_base* m_promise;
+};
+
+/**
+ * A key for a value that is visible to a task and every task it awaits, for per request data such as trace
+ * ids or deadlines that would otherwise be passed through every signature.  Unlike a thread_local the value
+ * follows the task when it resumes on another thread.  Keys are usually declared at namespace scope:
+ *
+ *     inline coro::task_local<std::string> trace_id{};
+ *
+ *     auto locals = co_await coro::this_task::locals();
+ *     locals.set(trace_id, "abc");
+ *     co_await handle_request();  // locals.get(trace_id) in here returns "abc"
+ *
+ * A lookup is an index into the task's storage, a task that never sets a task local carries a nullptr and
+ * pays nothing beyond that.  Tasks spawned onto an executor are not awaited by their creator, they inherit
+ * through with_task_locals().
+ */
+template<typename value_type>
+class task_local
+{
+public:
+    task_local() noexcept : m_slot(detail::task_local_storage::next_slot()) {}
+    task_local(const task_local&)                    = delete;
+    task_local(task_local&&)                         = delete;
+    auto operator=(const task_local&) -> task_local& = delete;
+    auto operator=(task_local&&) -> task_local&      = delete;
+    ~task_local()                                    = default;
+
+private:
+    friend class task_locals;
+
+    std::size_t m_slot;
+};
+
+namespace this_task
+{
+struct locals_operation
+{
+    auto await_ready() const noexcept -> bool { return false; }
+
+    template<typename promise_type>
+        requires std::is_base_of_v<detail::promise_base, promise_type>
+    auto await_suspend(std::coroutine_handle<promise_type> awaiting_coroutine) noexcept -> bool
+    {
+        m_promise = &awaiting_coroutine.promise();
+        return false;
+    }
+
+    auto await_resume() const noexcept -> task_locals { return task_locals{*m_promise}; }
+
+    detail::promise_base* m_promise{nullptr};
+};
+
+/**
+ * Must be awaited from a coro::task, completes immediately with a view of the awaiting task's locals.
+ */
+[[nodiscard]] inline auto locals() noexcept -> locals_operation
+{
+    return locals_operation{};
+}
+
+} // namespace this_task
+
+/**
+ * Gives a task that is about to be spawned the locals of the task spawning it, a task that is awaited
+ * inherits them without this.
+ *
+ *     tp->spawn(coro::with_task_locals(locals, child()));
+ *
+ * @param locals The spawning task's locals, the spawned task sees them as they are at this call.
+ * @param t The task to spawn, it must not have been started.
+ * @return The same task.
+ */
+template<typename return_type>
+[[nodiscard]] auto with_task_locals(const task_locals& locals, task<return_type> t) noexcept -> task<return_type>
+{
+    t.promise().task_locals(locals.m_promise->task_locals());
+    return t;
+}
+
+} // namespace coro
@@ -8,6 +8,8 @@
 #include <coroutine>
 #include <deque>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <ranges>
@@ -21,6 +23,12 @@ namespace coro
  * Creates a thread pool that executes arbitrary coroutine tasks in a FIFO scheduler policy.
  * The thread pool by default will create an execution thread per available core on the system.
  *
+ * Besides the shared FIFO queue each executor thread has a local queue for coroutines that prefer to
+ * resume on that specific thread, see resume(handle, worker).  An executor drains its local queue
+ * first, then the shared queue and finally steals from the other executors' local queues before going
+ * to sleep.  The next queued coroutine of an executor that is between tasks is never stolen, anything
+ * queued behind an executor that is busy running a coroutine can be taken by an idle one.
+ *
  * When shutting down, either by the thread pool destructing or by manually calling shutdown()
  * the thread pool will stop accepting new tasks but will complete all tasks that were scheduled
  * prior to the shutdown request.
@@ -78,8 +86,14 @@ public:
         /// Functor to call on each executor thread upon stopping execution.  The parameter is the
         /// thread's ID assigned to it by the thread pool.
         std::function<void(std::size_t)> on_thread_stop_functor = nullptr;
+        /// The maximum number of coroutines waiting in an executor's local queue, once reached coroutines
+        /// that prefer that executor are placed on the shared queue instead.  Zero disables worker affinity.
+        std::size_t max_local_queue_size = 16;
     };
 
+    /// The worker index of threads that are not executors of a thread pool.
+    static constexpr std::size_t no_worker = std::numeric_limits<std::size_t>::max();
+
     /**
      * @see thread_pool::make_shared
      */
@@ -95,7 +109,8 @@ public:
         options opts = options{
             .thread_count            = std::thread::hardware_concurrency(),
             .on_thread_start_functor = nullptr,
-            .on_thread_stop_functor  = nullptr}) -> std::shared_ptr<thread_pool>;
+            .on_thread_stop_functor  = nullptr,
+            .max_local_queue_size    = 16}) -> std::shared_ptr<thread_pool>;
 
     thread_pool(const thread_pool&)                    = delete;
     thread_pool(thread_pool&&)                         = delete;
@@ -146,6 +161,16 @@ public:
      */
     auto resume(std::coroutine_handle<> handle) noexcept -> bool;
 
+    /**
+     * Schedules any coroutine handle that is ready to be resumed on a preferred executor thread, this keeps
+     * the coroutine's working set in that thread's cache.  The handle is placed on the executor's local
+     * queue unless the queue is full, in which case it goes on the shared queue.
+     * @param handle The coroutine handle to schedule.
+     * @param worker The preferred executor thread, see current_worker().  no_worker uses the shared queue.
+     * @return True if the coroutine is resumed, false if its a nullptr or the coroutine is already done.
+     */
+    auto resume(std::coroutine_handle<> handle, std::size_t worker) noexcept -> bool;
+
     /**
      * Schedules the set of coroutine handles that are ready to be resumed.
      * @param handles The coroutine handles to schedule.
@@ -164,7 +189,7 @@ public:
             {
                 if (handle != nullptr) [[likely]]
                 {
-                    m_queue.emplace_back(handle);
+                    enqueue_locked(handle, no_worker);
                 }
                 else
                 {
@@ -178,20 +203,43 @@ public:
             m_size.fetch_sub(null_handles, std::memory_order::release);
         }
 
-        uint64_t total = std::size(handles) - null_handles;
-        if (total >= m_threads.size())
-        {
-            m_wait_cv.notify_all();
-        }
-        else
+        return std::size(handles) - null_handles;
+    }
+
+    /**
+     * Schedules the set of coroutine handles that are ready to be resumed, each on its preferred executor
+     * thread.  @see resume(handle, worker)
+     * @param handles The coroutine handles and their preferred executor threads to schedule.
+     * @param uint64_t The number of tasks resumed, if any where null they are discarded.
+     */
+    template<coro::concepts::range_of<std::pair<std::coroutine_handle<>, std::size_t>> range_type>
+    auto resume(const range_type& handles) noexcept -> uint64_t
+    {
+        m_size.fetch_add(std::size(handles), std::memory_order::release);
+
+        size_t null_handles{0};
+
         {
-            for (uint64_t i = 0; i < total; ++i)
+            std::scoped_lock lk{m_wait_mutex};
+            for (const auto& [handle, worker] : handles)
             {
-                m_wait_cv.notify_one();
+                if (handle != nullptr) [[likely]]
+                {
+                    enqueue_locked(handle, worker);
+                }
+                else
+                {
+                    ++null_handles;
+                }
             }
         }
 
-        return total;
+        if (null_handles > 0)
+        {
+            m_size.fetch_sub(null_handles, std::memory_order::release);
+        }
+
+        return std::size(handles) - null_handles;
     }
 
     /**
@@ -220,13 +268,20 @@ public:
     auto empty() const noexcept -> bool { return size() == 0; }
 
     /**
-     * @return The number of tasks waiting in the task queue to be executed.
+     * @return The number of tasks waiting in the shared and local task queues to be executed.
      */
-    auto queue_size() const noexcept -> std::size_t
-    {
-        std::atomic_thread_fence(std::memory_order::acquire);
-        return m_queue.size();
-    }
+    auto queue_size() const noexcept -> std::size_t { return m_queue_size.load(std::memory_order::acquire); }
+
+    /**
+     * @return The thread pool the calling thread is an executor of, nullptr if it is not an executor thread.
+     */
+    static auto current() noexcept -> thread_pool*;
+
+    /**
+     * @return The index of the calling executor thread within current(), no_worker if it is not an
+     *         executor thread.
+     */
+    static auto current_worker() noexcept -> std::size_t;
 
     /**
      * @return True if the task queue is currently empty.
@@ -238,13 +293,27 @@ private:
     options m_opts;
     /// The background executor threads.
     std::vector<std::thread> m_threads;
-    /// Mutex for executor threads to sleep on the condition variable.
+    /// Mutex protecting all of the task queues, executor threads sleep on their condition variable with it.
     std::mutex m_wait_mutex;
-    /// Condition variable for each executor thread to wait on when no tasks are available.
-    std::condition_variable_any m_wait_cv;
     /// FIFO queue of tasks waiting to be executed.
     std::deque<std::coroutine_handle<>> m_queue;
 
+    struct worker
+    {
+        /// FIFO queue of tasks that prefer this executor thread.
+        std::deque<std::coroutine_handle<>> m_queue{};
+        /// Condition variable this executor thread waits on when no tasks are available.
+        std::condition_variable m_wait_cv{};
+        /// Is this executor thread waiting for tasks?
+        bool m_idle{false};
+        /// Is this executor thread running a coroutine?  Its local queue is then open to stealing.
+        bool m_running{false};
+    };
+    /// Per executor thread state, indexed by the executor's idx.
+    std::vector<std::unique_ptr<worker>> m_workers;
+    /// The executor threads that are currently waiting for tasks, the most recently idle is woken first.
+    std::vector<std::size_t> m_idle_workers;
+
     /**
      * Each background thread runs from this function.
      * @param idx The executor's idx for internal data structure accesses.
@@ -254,9 +323,24 @@ private:
      * @param handle Schedules the given coroutine to be executed upon the first available thread.
      */
     auto schedule_impl(std::coroutine_handle<> handle) noexcept -> void;
+    /**
+     * Places the handle on the preferred executor's local queue or the shared queue and wakes an executor
+     * thread to run it if needed.  m_wait_mutex must be held.
+     */
+    auto enqueue_locked(std::coroutine_handle<> handle, std::size_t worker) noexcept -> void;
+    /**
+     * @return The next task for the given executor thread, nullptr if there are none.  m_wait_mutex must be held.
+     */
+    auto dequeue_locked(std::size_t idx) noexcept -> std::coroutine_handle<>;
+    /**
+     * Wakes an idle executor thread if there are any.  m_wait_mutex must be held.
+     */
+    auto wake_idle_worker_locked() noexcept -> void;
 
     /// The number of tasks in the queue + currently executing.
     std::atomic<std::size_t> m_size{0};
+    /// The number of tasks in the shared and local queues, updated under m_wait_mutex so it can be read without it.
+    std::atomic<std::size_t> m_queue_size{0};
     /// Has the thread pool been requested to shut down?
     std::atomic<bool> m_shutdown_requested{false};
 };
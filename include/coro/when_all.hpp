@@ -3,9 +3,12 @@
 #include "coro/attribute.hpp"
 #include "coro/concepts/awaitable.hpp"
 #include "coro/detail/void_value.hpp"
+#include "coro/frame_allocator.hpp"
+#include "coro/task.hpp"
 
 #include <atomic>
 #include <cassert>
+#include <concepts>
 #include <coroutine>
 #include <ranges>
 #include <tuple>
@@ -15,14 +18,15 @@ namespace coro
 {
 namespace detail
 {
-class when_all_latch
+class when_all_latch : public completion_hook
 {
 public:
-    when_all_latch(std::size_t count) noexcept : m_count(count + 1) {}
+    when_all_latch(std::size_t count) noexcept : completion_hook{&notify_task_completed}, m_count(count + 1) {}
 
     when_all_latch(const when_all_latch&) = delete;
     when_all_latch(when_all_latch&& other)
-        : m_count(other.m_count.load(std::memory_order::acquire)),
+        : completion_hook{&notify_task_completed},
+          m_count(other.m_count.load(std::memory_order::acquire)),
           m_awaiting_coroutine(std::exchange(other.m_awaiting_coroutine, nullptr))
     {
     }
@@ -56,6 +60,18 @@ public:
     }
 
 private:
+    /// Attached directly to coro::task children, the last to complete transfers to the awaiting coroutine.
+    static auto notify_task_completed(completion_hook& hook, std::coroutine_handle<>) noexcept
+        -> std::coroutine_handle<>
+    {
+        auto& latch = static_cast<when_all_latch&>(hook);
+        if (latch.m_count.fetch_sub(1, std::memory_order::acq_rel) == 1)
+        {
+            return latch.m_awaiting_coroutine;
+        }
+        return std::noop_coroutine();
+    }
+
     /// The number of tasks that are being waited on.
     std::atomic<std::size_t> m_count;
     /// The when_all_task awaiting to be resumed upon all task completions.
@@ -109,56 +125,49 @@ public:
     auto operator=(const when_all_ready_awaitable&) -> when_all_ready_awaitable& = delete;
     auto operator=(when_all_ready_awaitable&&) -> when_all_ready_awaitable&      = delete;
 
-    auto operator co_await() & noexcept
+    /// The awaiting coroutine is passed through so adopted tasks can inherit its task locals.
+    struct awaiter_base
     {
-        struct awaiter
-        {
-            explicit awaiter(when_all_ready_awaitable& awaitable) noexcept : m_awaitable(awaitable) {}
+        explicit awaiter_base(when_all_ready_awaitable& awaitable) noexcept : m_awaitable(awaitable) {}
 
-            auto await_ready() const noexcept -> bool { return m_awaitable.is_ready(); }
+        auto await_ready() const noexcept -> bool { return m_awaitable.is_ready(); }
 
-            auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
-            {
-                return m_awaitable.try_await(awaiting_coroutine);
-            }
+        template<typename awaiting_promise_type>
+        auto await_suspend(std::coroutine_handle<awaiting_promise_type> awaiting_coroutine) noexcept -> bool
+        {
+            return m_awaitable.try_await(awaiting_coroutine);
+        }
 
-            auto await_resume() noexcept -> std::tuple<task_types...>& { return m_awaitable.m_tasks; }
+        when_all_ready_awaitable& m_awaitable;
+    };
 
-        private:
-            when_all_ready_awaitable& m_awaitable;
+    auto operator co_await() & noexcept
+    {
+        struct awaiter : public awaiter_base
+        {
+            auto await_resume() noexcept -> std::tuple<task_types...>& { return this->m_awaitable.m_tasks; }
         };
 
-        return awaiter{*this};
+        return awaiter{awaiter_base{*this}};
     }
 
     auto operator co_await() && noexcept
     {
-        struct awaiter
+        struct awaiter : public awaiter_base
         {
-            explicit awaiter(when_all_ready_awaitable& awaitable) noexcept : m_awaitable(awaitable) {}
-
-            auto await_ready() const noexcept -> bool { return m_awaitable.is_ready(); }
-
-            auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
-            {
-                return m_awaitable.try_await(awaiting_coroutine);
-            }
-
-            auto await_resume() noexcept -> std::tuple<task_types...>&& { return std::move(m_awaitable.m_tasks); }
-
-        private:
-            when_all_ready_awaitable& m_awaitable;
+            auto await_resume() noexcept -> std::tuple<task_types...>&& { return std::move(this->m_awaitable.m_tasks); }
         };
 
-        return awaiter{*this};
+        return awaiter{awaiter_base{*this}};
     }
 
 private:
     auto is_ready() const noexcept -> bool { return m_latch.is_ready(); }
 
-    auto try_await(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+    template<typename awaiting_promise_type>
+    auto try_await(std::coroutine_handle<awaiting_promise_type> awaiting_coroutine) noexcept -> bool
     {
-        std::apply([this](auto&&... tasks) { ((tasks.start(m_latch)), ...); }, m_tasks);
+        std::apply([&](auto&&... tasks) { ((tasks.start(m_latch, awaiting_coroutine)), ...); }, m_tasks);
         return m_latch.try_await(awaiting_coroutine);
     }
 
@@ -187,58 +196,51 @@ public:
     auto operator=(const when_all_ready_awaitable&) -> when_all_ready_awaitable& = delete;
     auto operator=(when_all_ready_awaitable&&) -> when_all_ready_awaitable&       = delete;
 
-    auto operator co_await() & noexcept
+    /// The awaiting coroutine is passed through so adopted tasks can inherit its task locals.
+    struct awaiter_base
     {
-        struct awaiter
-        {
-            awaiter(when_all_ready_awaitable& awaitable) : m_awaitable(awaitable) {}
+        explicit awaiter_base(when_all_ready_awaitable& awaitable) noexcept : m_awaitable(awaitable) {}
 
-            auto await_ready() const noexcept -> bool { return m_awaitable.is_ready(); }
+        auto await_ready() const noexcept -> bool { return m_awaitable.is_ready(); }
 
-            auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
-            {
-                return m_awaitable.try_await(awaiting_coroutine);
-            }
+        template<typename awaiting_promise_type>
+        auto await_suspend(std::coroutine_handle<awaiting_promise_type> awaiting_coroutine) noexcept -> bool
+        {
+            return m_awaitable.try_await(awaiting_coroutine);
+        }
 
-            auto await_resume() noexcept -> task_container_type& { return m_awaitable.m_tasks; }
+        when_all_ready_awaitable& m_awaitable;
+    };
 
-        private:
-            when_all_ready_awaitable& m_awaitable;
+    auto operator co_await() & noexcept
+    {
+        struct awaiter : public awaiter_base
+        {
+            auto await_resume() noexcept -> task_container_type& { return this->m_awaitable.m_tasks; }
         };
 
-        return awaiter{*this};
+        return awaiter{awaiter_base{*this}};
     }
 
     auto operator co_await() && noexcept
     {
-        struct awaiter
+        struct awaiter : public awaiter_base
         {
-            awaiter(when_all_ready_awaitable& awaitable) : m_awaitable(awaitable) {}
-
-            auto await_ready() const noexcept -> bool { return m_awaitable.is_ready(); }
-
-            auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
-            {
-                return m_awaitable.try_await(awaiting_coroutine);
-            }
-
-            auto await_resume() noexcept -> task_container_type&& { return std::move(m_awaitable.m_tasks); }
-
-        private:
-            when_all_ready_awaitable& m_awaitable;
+            auto await_resume() noexcept -> task_container_type&& { return std::move(this->m_awaitable.m_tasks); }
         };
 
-        return awaiter{*this};
+        return awaiter{awaiter_base{*this}};
     }
 
 private:
     auto is_ready() const noexcept -> bool { return m_latch.is_ready(); }
 
-    auto try_await(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
+    template<typename awaiting_promise_type>
+    auto try_await(std::coroutine_handle<awaiting_promise_type> awaiting_coroutine) noexcept -> bool
     {
         for (auto& task : m_tasks)
         {
-            task.start(m_latch);
+            task.start(m_latch, awaiting_coroutine);
         }
 
         return m_latch.try_await(awaiting_coroutine);
@@ -249,7 +251,7 @@ private:
 };
 
 template<typename return_type>
-class when_all_task_promise
+class when_all_task_promise : public pooled_frame
 {
 public:
     using coroutine_handle_type = std::coroutine_handle<when_all_task_promise<return_type>>;
@@ -322,7 +324,7 @@ private:
 };
 
 template<>
-class when_all_task_promise<void>
+class when_all_task_promise<void> : public pooled_frame
 {
 public:
     using coroutine_handle_type = std::coroutine_handle<when_all_task_promise<void>>;
@@ -381,12 +383,20 @@ public:
 
     using promise_type          = when_all_task_promise<return_type>;
     using coroutine_handle_type = typename promise_type::coroutine_handle_type;
+    /// The coro::task whose co_await yields return_type, adopted directly without a wrapping coroutine.
+    using task_type = coro::task<std::conditional_t<
+        std::is_rvalue_reference_v<return_type>,
+        std::remove_reference_t<return_type>,
+        return_type>>;
 
     when_all_task(coroutine_handle_type coroutine) noexcept : m_coroutine(coroutine) {}
 
+    explicit when_all_task(task_type&& task) noexcept : m_task(std::move(task)) {}
+
     when_all_task(const when_all_task&) = delete;
     when_all_task(when_all_task&& other) noexcept
-        : m_coroutine(std::exchange(other.m_coroutine, coroutine_handle_type{}))
+        : m_coroutine(std::exchange(other.m_coroutine, coroutine_handle_type{})),
+          m_task(std::move(other.m_task))
     {
     }
 
@@ -401,58 +411,71 @@ public:
         }
     }
 
-    auto return_value() & -> decltype(auto)
-    {
-        if constexpr (std::is_void_v<return_type>)
-        {
-            m_coroutine.promise().result();
-            return void_value{};
-        }
-        else
-        {
-            return m_coroutine.promise().result();
-        }
-    }
+    auto return_value() & -> decltype(auto) { return result(); }
 
-    auto return_value() const& -> decltype(auto)
+    auto return_value() const& -> decltype(auto) { return result(); }
+
+    auto return_value() && -> decltype(auto) { return result(); }
+
+private:
+    /// Adopted tasks inherit the awaiting task's locals, wrapped awaitables run without any.
+    template<typename awaiting_promise_type>
+    auto start(when_all_latch& latch, std::coroutine_handle<awaiting_promise_type> awaiting_coroutine) noexcept
+        -> void
     {
-        if constexpr (std::is_void_v<return_type>)
+        if (m_coroutine != nullptr)
         {
-            m_coroutine.promise().result();
-            return void_value{};
+            m_coroutine.promise().start(latch);
         }
         else
         {
-            return m_coroutine.promise().result();
+            detail::link_awaiting_task(m_task.promise(), awaiting_coroutine);
+            m_task.promise().completion(latch);
+            m_task.handle().resume();
         }
     }
 
-    auto return_value() && -> decltype(auto)
+    auto result() const -> decltype(auto)
     {
+        // The adopted task's result is read through its rvalue overloads, exactly what the wrapping
+        // coroutine's co_await would have produced.
+        auto& task = const_cast<task_type&>(m_task);
         if constexpr (std::is_void_v<return_type>)
         {
-            m_coroutine.promise().result();
+            if (m_coroutine != nullptr)
+            {
+                m_coroutine.promise().result();
+            }
+            else
+            {
+                task.promise().result();
+            }
             return void_value{};
         }
         else
         {
-            return m_coroutine.promise().result();
+            if (m_coroutine != nullptr)
+            {
+                return m_coroutine.promise().result();
+            }
+            auto&& value = std::move(task).promise().result();
+            return static_cast<std::add_lvalue_reference_t<return_type>>(value);
         }
     }
 
-private:
-    auto start(when_all_latch& latch) noexcept -> void { m_coroutine.promise().start(latch); }
-
-    coroutine_handle_type m_coroutine;
+    coroutine_handle_type m_coroutine{nullptr};
+    task_type             m_task{};
 };
 
 template<
     concepts::awaitable awaitable,
+    typename alloc_type,
     typename return_type = typename concepts::awaitable_traits<awaitable&&>::awaiter_return_type>
-static auto make_when_all_task(awaitable a) -> when_all_task<return_type> __ATTRIBUTE__(used);
+static auto make_when_all_task(std::allocator_arg_t, alloc_type alloc, awaitable a)
+    -> when_all_task<return_type> __ATTRIBUTE__(used);
 
-template<concepts::awaitable awaitable, typename return_type>
-static auto make_when_all_task(awaitable a) -> when_all_task<return_type>
+template<concepts::awaitable awaitable, typename alloc_type, typename return_type>
+static auto make_when_all_task(std::allocator_arg_t, alloc_type /*alloc*/, awaitable a) -> when_all_task<return_type>
 {
     if constexpr (std::is_void_v<return_type>)
     {
@@ -465,21 +488,52 @@ static auto make_when_all_task(awaitable a) -> when_all_task<return_type>
     }
 }
 
+/// coro::task children are adopted as they are, their completion is hooked directly into the latch.
+template<
+    typename alloc_type,
+    typename value_type,
+    typename return_type = typename concepts::awaitable_traits<coro::task<value_type>&&>::awaiter_return_type>
+requires std::same_as<typename when_all_task<return_type>::task_type, coro::task<value_type>>
+static auto make_when_all_task(std::allocator_arg_t, alloc_type /*alloc*/, coro::task<value_type> t)
+    -> when_all_task<return_type>
+{
+    return when_all_task<return_type>{std::move(t)};
+}
+
 } // namespace detail
 
-template<concepts::awaitable... awaitables_type>
-[[nodiscard]] auto when_all(awaitables_type... awaitables)
+/**
+ * Awaits all of the given awaitables concurrently, the internal task wrapping each awaitable has its
+ * frame allocated from the given allocator.
+ * @param alloc The allocator for the internal coroutine frames, e.g. a std::pmr::polymorphic_allocator.
+ * @param awaitables The awaitables to await.
+ */
+template<typename alloc_type, concepts::awaitable... awaitables_type>
+[[nodiscard]] auto when_all(std::allocator_arg_t, const alloc_type& alloc, awaitables_type... awaitables)
 {
     return detail::when_all_ready_awaitable<std::tuple<
         detail::when_all_task<typename concepts::awaitable_traits<awaitables_type>::awaiter_return_type>...>>(
-        std::make_tuple(detail::make_when_all_task(std::move(awaitables))...));
+        std::make_tuple(detail::make_when_all_task(std::allocator_arg, alloc, std::move(awaitables))...));
+}
+
+template<concepts::awaitable... awaitables_type>
+[[nodiscard]] auto when_all(awaitables_type... awaitables)
+{
+    return when_all(std::allocator_arg, std::allocator<void>{}, std::move(awaitables)...);
 }
 
+/**
+ * Awaits all of the awaitables in the range concurrently, the internal task wrapping each awaitable has
+ * its frame allocated from the given allocator.
+ * @param alloc The allocator for the internal coroutine frames, e.g. a std::pmr::polymorphic_allocator.
+ * @param awaitables The range of awaitables to await.
+ */
 template<
+    typename alloc_type,
     std::ranges::range  range_type,
     concepts::awaitable awaitable_type = std::ranges::range_value_t<range_type>,
     typename return_type               = typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>
-[[nodiscard]] auto when_all(range_type awaitables)
+[[nodiscard]] auto when_all(std::allocator_arg_t, const alloc_type& alloc, range_type awaitables)
     -> detail::when_all_ready_awaitable<std::vector<detail::when_all_task<return_type>>>
 {
     std::vector<detail::when_all_task<return_type>> output_tasks;
@@ -493,11 +547,21 @@ template<
     // Wrap each task into a when_all_task.
     for (auto&& a : awaitables)
     {
-        output_tasks.emplace_back(detail::make_when_all_task(std::move(a)));
+        output_tasks.emplace_back(detail::make_when_all_task(std::allocator_arg, alloc, std::move(a)));
     }
 
     // Return the single awaitable that drives all the user's tasks.
     return detail::when_all_ready_awaitable(std::move(output_tasks));
 }
 
+template<
+    std::ranges::range  range_type,
+    concepts::awaitable awaitable_type = std::ranges::range_value_t<range_type>,
+    typename return_type               = typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>
+[[nodiscard]] auto when_all(range_type awaitables)
+    -> detail::when_all_ready_awaitable<std::vector<detail::when_all_task<return_type>>>
+{
+    return when_all(std::allocator_arg, std::allocator<void>{}, std::move(awaitables));
+}
+
 } // namespace coro
@@ -13,9 +13,15 @@
 
     #include <atomic>
     #include <cassert>
+    #include <cstdint>
     #include <coroutine>
+    #include <exception>
+    #include <memory>
     #include <stop_token>
     #include <optional>
+    #include <tuple>
+    #include <ranges>
+    #include <type_traits>
     #include <utility>
     #include <vector>
 
@@ -25,10 +31,14 @@ namespace coro
 namespace detail
 {
 
-template<typename return_type, concepts::awaitable awaitable>
+template<typename return_type, typename alloc_type, concepts::awaitable awaitable>
 auto make_when_any_tuple_task(
-    std::atomic<bool>& first_completed, coro::event& notify, std::optional<return_type>& return_value, awaitable a)
-    -> coro::task<void>
+    std::allocator_arg_t,
+    alloc_type /*alloc*/,
+    std::atomic<bool>&          first_completed,
+    coro::event&                notify,
+    std::optional<return_type>& return_value,
+    awaitable                   a) -> coro::task<void>
 {
     auto expected = false;
     auto result   = co_await static_cast<awaitable&&>(a);
@@ -41,18 +51,27 @@ auto make_when_any_tuple_task(
     co_return;
 }
 
-template<typename return_type, concepts::awaitable... awaitable_type>
+template<typename return_type, typename alloc_type, concepts::awaitable... awaitable_type>
 [[nodiscard]] auto make_when_any_tuple_controller_task(
-    coro::event& notify, std::optional<return_type>& return_value, awaitable_type... awaitables)
-    -> coro::detail::task_self_deleting
+    std::allocator_arg_t,
+    alloc_type                  alloc,
+    coro::event&                notify,
+    std::optional<return_type>& return_value,
+    awaitable_type... awaitables) -> coro::detail::task_self_deleting
 {
     std::atomic<bool> first_completed{false};
-    co_await coro::when_all(make_when_any_tuple_task(first_completed, notify, return_value, std::move(awaitables))...);
+    co_await coro::when_all(
+        std::allocator_arg,
+        alloc,
+        make_when_any_tuple_task(
+            std::allocator_arg, alloc, first_completed, notify, return_value, std::move(awaitables))...);
     co_return;
 }
 
-template<concepts::awaitable awaitable>
-static auto make_when_any_task_return_void(awaitable a, std::atomic<bool>& first_completed, coro::event& notify) -> coro::task<void>
+template<concepts::awaitable awaitable, typename alloc_type>
+static auto make_when_any_task_return_void(
+    std::allocator_arg_t, alloc_type /*alloc*/, awaitable a, std::atomic<bool>& first_completed, coro::event& notify)
+    -> coro::task<void>
 {
     co_await static_cast<awaitable&&>(a);
     auto expected = false;
@@ -63,10 +82,14 @@ static auto make_when_any_task_return_void(awaitable a, std::atomic<bool>& first
     co_return;
 }
 
-template<concepts::awaitable awaitable, typename return_type>
+template<concepts::awaitable awaitable, typename return_type, typename alloc_type>
 static auto make_when_any_task(
-    awaitable a, std::atomic<bool>& first_completed, coro::event& notify, std::optional<return_type>& return_value)
-    -> coro::task<void>
+    std::allocator_arg_t,
+    alloc_type /*alloc*/,
+    awaitable                   a,
+    std::atomic<bool>&          first_completed,
+    coro::event&                notify,
+    std::optional<return_type>& return_value) -> coro::task<void>
 {
     auto expected = false;
     auto result   = co_await static_cast<awaitable&&>(a);
@@ -81,8 +104,12 @@ static auto make_when_any_task(
     co_return;
 }
 
-template<std::ranges::range range_type, concepts::awaitable awaitable_type = std::ranges::range_value_t<range_type>>
-static auto make_when_any_controller_task_return_void(range_type awaitables, coro::event& notify)
+template<
+    typename alloc_type,
+    std::ranges::range  range_type,
+    concepts::awaitable awaitable_type = std::ranges::range_value_t<range_type>>
+static auto make_when_any_controller_task_return_void(
+    std::allocator_arg_t, alloc_type alloc, range_type awaitables, coro::event& notify)
     -> coro::detail::task_self_deleting
 {
     std::atomic<bool> first_completed{false};
@@ -95,21 +122,26 @@ static auto make_when_any_controller_task_return_void(range_type awaitables, cor
 
     for (auto&& a : awaitables)
     {
-        tasks.emplace_back(make_when_any_task_return_void<awaitable_type>(std::move(a), first_completed, notify));
+        tasks.emplace_back(make_when_any_task_return_void<awaitable_type>(
+            std::allocator_arg, alloc, std::move(a), first_completed, notify));
     }
 
-    co_await coro::when_all(std::move(tasks));
+    co_await coro::when_all(std::allocator_arg, alloc, std::move(tasks));
     co_return;
 }
 
 template<
+    typename alloc_type,
     std::ranges::range  range_type,
     concepts::awaitable awaitable_type = std::ranges::range_value_t<range_type>,
     typename return_type               = typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type,
     typename return_type_base          = std::remove_reference_t<return_type>>
 static auto make_when_any_controller_task(
-    range_type awaitables, coro::event& notify, std::optional<return_type_base>& return_value)
-    -> coro::detail::task_self_deleting
+    std::allocator_arg_t,
+    alloc_type                       alloc,
+    range_type                       awaitables,
+    coro::event&                     notify,
+    std::optional<return_type_base>& return_value) -> coro::detail::task_self_deleting
 {
     // This must live for as long as the longest running when_any task since each task tries to see
     // if it was the first to complete. Only the very first task to complete will set the return_value
@@ -126,64 +158,432 @@ static auto make_when_any_controller_task(
 
     for (auto&& a : awaitables)
     {
-        tasks.emplace_back(
-            make_when_any_task<awaitable_type, return_type_base>(std::move(a), first_completed, notify, return_value));
+        tasks.emplace_back(make_when_any_task<awaitable_type, return_type_base>(
+            std::allocator_arg, alloc, std::move(a), first_completed, notify, return_value));
     }
 
-    co_await coro::when_all(std::move(tasks));
+    co_await coro::when_all(std::allocator_arg, alloc, std::move(tasks));
     co_return;
 }
 
+template<typename type>
+struct is_task : std::false_type
+{
+};
+
+template<typename value_type>
+struct is_task<coro::task<value_type>> : std::true_type
+{
+};
+
+/**
+ * The shared state of a when_any over a range of coro::task, attached to each task as its completion hook
+ * so no wrapping coroutine is created per task.  The first task to complete stores its result, or its
+ * exception, and resumes the awaiting coroutine.  The state is reference counted by the tasks and the
+ * awaiting coroutine, the last reference destroys the tasks and frees the state with the allocator.
+ */
+template<typename alloc_type, typename task_type, typename return_type_base>
+class when_any_task_range_state final : public completion_hook
+{
+public:
+    using state_allocator_type =
+        typename std::allocator_traits<alloc_type>::template rebind_alloc<when_any_task_range_state>;
+    using promise_type = typename task_type::promise_type;
+
+    when_any_task_range_state(state_allocator_type alloc, std::vector<task_type> tasks)
+        : completion_hook{&notify_task_completed},
+          m_alloc(std::move(alloc)),
+          m_tasks(std::move(tasks)),
+          m_references(m_tasks.size() + 1)
+    {
+    }
+
+    template<std::ranges::range range_type>
+    static auto make(alloc_type alloc, range_type&& tasks) -> when_any_task_range_state*
+    {
+        std::vector<task_type> owned{};
+        if constexpr (std::is_same_v<std::remove_cvref_t<range_type>, std::vector<task_type>>)
+        {
+            owned = std::move(tasks);
+        }
+        else
+        {
+            for (auto&& t : tasks)
+            {
+                owned.emplace_back(std::move(t));
+            }
+        }
+
+        state_allocator_type state_alloc{alloc};
+        auto*          state = std::allocator_traits<state_allocator_type>::allocate(state_alloc, 1);
+        std::allocator_traits<state_allocator_type>::construct(state_alloc, state, state_alloc, std::move(owned));
+        return state;
+    }
+
+    auto await_ready() const noexcept -> bool { return false; }
+
+    template<typename awaiting_promise_type>
+    auto await_suspend(std::coroutine_handle<awaiting_promise_type> awaiting_coroutine) noexcept -> bool
+    {
+        m_awaiting_coroutine = awaiting_coroutine;
+        for (auto& t : m_tasks)
+        {
+            // The losers can outlive the when_any, they share its task locals but are not linked to its async stack.
+            if constexpr (std::is_base_of_v<promise_base, awaiting_promise_type>)
+            {
+                t.promise().inherit_task_locals(awaiting_coroutine.promise());
+            }
+            t.promise().completion(*this);
+            t.handle().resume();
+        }
+
+        // The winner may have completed while the tasks were being started, if so continue without suspending.
+        return m_resume.fetch_sub(1, std::memory_order::acq_rel) > 1;
+    }
+
+    auto await_resume() noexcept -> void {}
+
+    /**
+     * Takes the winner's result and gives up the awaiting coroutine's reference, the state must not be used
+     * after this is called.
+     */
+    auto take_result() -> return_type_base
+    {
+        auto exception = std::move(m_exception);
+        if constexpr (std::is_void_v<return_type_base>)
+        {
+            release();
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+        }
+        else
+        {
+            std::optional<return_type_base> value{std::move(m_value)};
+            release();
+            if (exception)
+            {
+                std::rethrow_exception(exception);
+            }
+            return std::move(value.value());
+        }
+    }
+
+private:
+    static auto notify_task_completed(completion_hook& hook, std::coroutine_handle<> completed) noexcept
+        -> std::coroutine_handle<>
+    {
+        auto&                   state = static_cast<when_any_task_range_state&>(hook);
+        std::coroutine_handle<> next  = std::noop_coroutine();
+        if (!state.m_first_completed.exchange(true, std::memory_order::acq_rel))
+        {
+            auto& promise = std::coroutine_handle<promise_type>::from_address(completed.address()).promise();
+            try
+            {
+                if constexpr (std::is_void_v<return_type_base>)
+                {
+                    promise.result();
+                }
+                else
+                {
+                    state.m_value.emplace(std::move(promise).result());
+                }
+            }
+            catch (...)
+            {
+                state.m_exception = std::current_exception();
+            }
+
+            if (state.m_resume.fetch_sub(1, std::memory_order::acq_rel) == 1)
+            {
+                next = state.m_awaiting_coroutine;
+            }
+        }
+
+        // This may destroy the completed task's frame, the hook must not touch it afterwards.
+        state.release();
+        return next;
+    }
+
+    auto release() noexcept -> void
+    {
+        if (m_references.fetch_sub(1, std::memory_order::acq_rel) == 1)
+        {
+            state_allocator_type alloc{m_alloc};
+            std::allocator_traits<state_allocator_type>::destroy(alloc, this);
+            std::allocator_traits<state_allocator_type>::deallocate(alloc, this, 1);
+        }
+    }
+
+    struct no_value
+    {
+    };
+
+    state_allocator_type     m_alloc;
+    std::vector<task_type>   m_tasks;
+    std::atomic<std::size_t> m_references;
+    /// Counted down by the winner and by await_suspend once every task is started, the last resumes.
+    std::atomic<std::uint32_t> m_resume{2};
+    std::atomic<bool>          m_first_completed{false};
+    std::coroutine_handle<>    m_awaiting_coroutine{nullptr};
+    std::optional<std::conditional_t<std::is_void_v<return_type_base>, no_value, return_type_base>> m_value{};
+    std::exception_ptr         m_exception{nullptr};
+};
+
+/**
+ * The shared state of a when_any over a pack of coro::task, the tuple counterpart of
+ * when_any_task_range_state.  The tasks are stored in a fixed size tuple inside the state so a single
+ * allocation holds everything, the winner is identified by comparing the completed coroutine against
+ * each task's handle and its result is stored at its index in the variant.
+ */
+template<typename alloc_type, typename return_type, typename... task_types>
+class when_any_task_tuple_state final : public completion_hook
+{
+public:
+    using state_allocator_type =
+        typename std::allocator_traits<alloc_type>::template rebind_alloc<when_any_task_tuple_state>;
+
+    when_any_task_tuple_state(state_allocator_type alloc, task_types&&... tasks)
+        : completion_hook{&notify_task_completed},
+          m_alloc(std::move(alloc)),
+          m_tasks(std::move(tasks)...)
+    {
+    }
+
+    static auto make(alloc_type alloc, task_types&&... tasks) -> when_any_task_tuple_state*
+    {
+        state_allocator_type state_alloc{alloc};
+        auto*                state = std::allocator_traits<state_allocator_type>::allocate(state_alloc, 1);
+        std::allocator_traits<state_allocator_type>::construct(state_alloc, state, state_alloc, std::move(tasks)...);
+        return state;
+    }
+
+    auto await_ready() const noexcept -> bool { return false; }
+
+    template<typename awaiting_promise_type>
+    auto await_suspend(std::coroutine_handle<awaiting_promise_type> awaiting_coroutine) noexcept -> bool
+    {
+        m_awaiting_coroutine = awaiting_coroutine;
+        std::apply(
+            [&](auto&... tasks)
+            {
+                (
+                    [&](auto& t)
+                    {
+                        if constexpr (std::is_base_of_v<promise_base, awaiting_promise_type>)
+                        {
+                            t.promise().inherit_task_locals(awaiting_coroutine.promise());
+                        }
+                        t.promise().completion(*this);
+                        t.handle().resume();
+                    }(tasks),
+                    ...);
+            },
+            m_tasks);
+
+        // The winner may have completed while the tasks were being started, if so continue without suspending.
+        return m_resume.fetch_sub(1, std::memory_order::acq_rel) > 1;
+    }
+
+    auto await_resume() noexcept -> void {}
+
+    /**
+     * Takes the winner's result and gives up the awaiting coroutine's reference, the state must not be used
+     * after this is called.
+     */
+    auto take_result() -> return_type
+    {
+        auto                       exception = std::move(m_exception);
+        std::optional<return_type> value{std::move(m_value)};
+        release();
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+        return std::move(value.value());
+    }
+
+private:
+    static auto notify_task_completed(completion_hook& hook, std::coroutine_handle<> completed) noexcept
+        -> std::coroutine_handle<>
+    {
+        auto&                   state = static_cast<when_any_task_tuple_state&>(hook);
+        std::coroutine_handle<> next  = std::noop_coroutine();
+        if (!state.m_first_completed.exchange(true, std::memory_order::acq_rel))
+        {
+            [&]<std::size_t... indices>(std::index_sequence<indices...>)
+            { (state.template try_store_result<indices>(completed) || ...); }(std::index_sequence_for<task_types...>{});
+
+            if (state.m_resume.fetch_sub(1, std::memory_order::acq_rel) == 1)
+            {
+                next = state.m_awaiting_coroutine;
+            }
+        }
+
+        // This may destroy the completed task's frame, the hook must not touch it afterwards.
+        state.release();
+        return next;
+    }
+
+    /**
+     * @return True if the completed coroutine is the task at this index, its result or exception is stored.
+     */
+    template<std::size_t index>
+    auto try_store_result(std::coroutine_handle<> completed) noexcept -> bool
+    {
+        auto& task = std::get<index>(m_tasks);
+        if (task.handle().address() != completed.address())
+        {
+            return false;
+        }
+
+        try
+        {
+            m_value.emplace(std::in_place_index<index>, std::move(task.promise()).result());
+        }
+        catch (...)
+        {
+            m_exception = std::current_exception();
+        }
+        return true;
+    }
+
+    auto release() noexcept -> void
+    {
+        if (m_references.fetch_sub(1, std::memory_order::acq_rel) == 1)
+        {
+            state_allocator_type alloc{m_alloc};
+            std::allocator_traits<state_allocator_type>::destroy(alloc, this);
+            std::allocator_traits<state_allocator_type>::deallocate(alloc, this, 1);
+        }
+    }
+
+    state_allocator_type      m_alloc;
+    std::tuple<task_types...> m_tasks;
+    std::atomic<std::size_t>  m_references{sizeof...(task_types) + 1};
+    /// Counted down by the winner and by await_suspend once every task is started, the last resumes.
+    std::atomic<std::uint32_t> m_resume{2};
+    std::atomic<bool>          m_first_completed{false};
+    std::coroutine_handle<>    m_awaiting_coroutine{nullptr};
+    std::optional<return_type> m_value{};
+    std::exception_ptr         m_exception{nullptr};
+};
+
 } // namespace detail
 
-template<concepts::awaitable... awaitable_type>
-[[nodiscard]] auto when_any(std::stop_source stop_source, awaitable_type... awaitables) -> coro::task<
-    std::variant<std::remove_reference_t<typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>...>>
+/**
+ * Awaits the given awaitables concurrently and returns the result of the first to complete, then requests
+ * a stop on the stop source.  Losing branches that poll or wait on timers through an io_scheduler with
+ * the source's token are removed from the event loop and resumed with poll_status::cancelled, when_any
+ * does not wait for them to finish.  Every coroutine frame when_any creates, including its own, is
+ * allocated from the given allocator.
+ */
+template<typename alloc_type, concepts::awaitable... awaitable_type>
+[[nodiscard]] auto
+    when_any(std::allocator_arg_t, alloc_type alloc, std::stop_source stop_source, awaitable_type... awaitables)
+        -> coro::task<std::variant<
+            std::remove_reference_t<typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>...>>
 {
     using return_type = std::variant<
         std::remove_reference_t<typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>...>;
 
-    coro::event                notify{};
-    std::optional<return_type> return_value{std::nullopt};
-    auto                       controller_task =
-        detail::make_when_any_tuple_controller_task(notify, return_value, std::forward<awaitable_type>(awaitables)...);
-    controller_task.handle().resume();
+    if constexpr ((detail::is_task<awaitable_type>::value && ...))
+    {
+        auto* state = detail::when_any_task_tuple_state<alloc_type, return_type, awaitable_type...>::make(
+            alloc, std::move(awaitables)...);
+        co_await *state;
+        stop_source.request_stop();
+        co_return state->take_result();
+    }
+    else
+    {
+        coro::event                notify{};
+        std::optional<return_type> return_value{std::nullopt};
+        auto                       controller_task = detail::make_when_any_tuple_controller_task(
+            std::allocator_arg, alloc, notify, return_value, std::forward<awaitable_type>(awaitables)...);
+        controller_task.handle().resume();
 
-    co_await notify;
-    stop_source.request_stop();
-    co_return std::move(return_value.value());
+        co_await notify;
+        stop_source.request_stop();
+        co_return std::move(return_value.value());
+    }
 }
 
 template<concepts::awaitable... awaitable_type>
-[[nodiscard]] auto when_any(awaitable_type... awaitables) -> coro::task<
+[[nodiscard]] auto when_any(std::stop_source stop_source, awaitable_type... awaitables) -> coro::task<
+    std::variant<std::remove_reference_t<typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>...>>
+{
+    return when_any(
+        std::allocator_arg, std::allocator<void>{}, std::move(stop_source), std::forward<awaitable_type>(awaitables)...);
+}
+
+/**
+ * Awaits the given awaitables concurrently and returns the result of the first to complete.  Every
+ * coroutine frame when_any creates, including its own, is allocated from the given allocator.
+ */
+template<typename alloc_type, concepts::awaitable... awaitable_type>
+[[nodiscard]] auto when_any(std::allocator_arg_t, alloc_type alloc, awaitable_type... awaitables) -> coro::task<
     std::variant<std::remove_reference_t<typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>...>>
 {
     using return_type = std::variant<
         std::remove_reference_t<typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>...>;
 
-    coro::event                notify{};
-    std::optional<return_type> return_value{std::nullopt};
-    auto                       controller_task =
-        detail::make_when_any_tuple_controller_task(notify, return_value, std::forward<awaitable_type>(awaitables)...);
-    controller_task.handle().resume();
+    if constexpr ((detail::is_task<awaitable_type>::value && ...))
+    {
+        auto* state = detail::when_any_task_tuple_state<alloc_type, return_type, awaitable_type...>::make(
+            alloc, std::move(awaitables)...);
+        co_await *state;
+        co_return state->take_result();
+    }
+    else
+    {
+        coro::event                notify{};
+        std::optional<return_type> return_value{std::nullopt};
+        auto                       controller_task = detail::make_when_any_tuple_controller_task(
+            std::allocator_arg, alloc, notify, return_value, std::forward<awaitable_type>(awaitables)...);
+        controller_task.handle().resume();
 
-    co_await notify;
-    co_return std::move(return_value.value());
+        co_await notify;
+        co_return std::move(return_value.value());
+    }
 }
 
+template<concepts::awaitable... awaitable_type>
+[[nodiscard]] auto when_any(awaitable_type... awaitables) -> coro::task<
+    std::variant<std::remove_reference_t<typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type>...>>
+{
+    return when_any(std::allocator_arg, std::allocator<void>{}, std::forward<awaitable_type>(awaitables)...);
+}
+
+/**
+ * Awaits the awaitables in the range concurrently and returns the result of the first to complete, then
+ * requests a stop on the stop source so losing branches observing its token are cancelled.  Every
+ * coroutine frame when_any creates, including its own, is allocated from the given allocator.
+ */
 template<
+    typename alloc_type,
     std::ranges::range  range_type,
     concepts::awaitable awaitable_type = std::ranges::range_value_t<range_type>,
     typename return_type               = typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type,
     typename return_type_base          = std::remove_reference_t<return_type>>
-[[nodiscard]] auto when_any(std::stop_source stop_source, range_type awaitables) -> coro::task<return_type_base>
+[[nodiscard]] auto when_any(std::allocator_arg_t, alloc_type alloc, std::stop_source stop_source, range_type awaitables)
+    -> coro::task<return_type_base>
 {
     coro::event notify{};
 
-    if constexpr (std::is_void_v<return_type_base>)
+    if constexpr (detail::is_task<awaitable_type>::value)
+    {
+        auto* state = detail::when_any_task_range_state<alloc_type, awaitable_type, return_type_base>::make(
+            alloc, std::move(awaitables));
+        co_await *state;
+        stop_source.request_stop();
+        co_return state->take_result();
+    }
+    else if constexpr (std::is_void_v<return_type_base>)
     {
-        auto controller_task =
-            detail::make_when_any_controller_task_return_void(std::forward<range_type>(awaitables), notify);
+        auto controller_task = detail::make_when_any_controller_task_return_void(
+            std::allocator_arg, alloc, std::forward<range_type>(awaitables), notify);
         controller_task.handle().resume();
 
         co_await notify;
@@ -195,8 +595,8 @@ template<
         // Using an std::optional to prevent the need to default construct the type on the stack.
         std::optional<return_type_base> return_value{std::nullopt};
 
-        auto controller_task =
-            detail::make_when_any_controller_task(std::forward<range_type>(awaitables), notify, return_value);
+        auto controller_task = detail::make_when_any_controller_task(
+            std::allocator_arg, alloc, std::forward<range_type>(awaitables), notify, return_value);
         controller_task.handle().resume();
 
         co_await notify;
@@ -210,14 +610,37 @@ template<
     concepts::awaitable awaitable_type = std::ranges::range_value_t<range_type>,
     typename return_type               = typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type,
     typename return_type_base          = std::remove_reference_t<return_type>>
-[[nodiscard]] auto when_any(range_type awaitables) -> coro::task<return_type_base>
+[[nodiscard]] auto when_any(std::stop_source stop_source, range_type awaitables) -> coro::task<return_type_base>
+{
+    return when_any(
+        std::allocator_arg, std::allocator<void>{}, std::move(stop_source), std::forward<range_type>(awaitables));
+}
+
+/**
+ * Awaits the awaitables in the range concurrently and returns the result of the first to complete.  Every
+ * coroutine frame when_any creates, including its own, is allocated from the given allocator.
+ */
+template<
+    typename alloc_type,
+    std::ranges::range  range_type,
+    concepts::awaitable awaitable_type = std::ranges::range_value_t<range_type>,
+    typename return_type               = typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type,
+    typename return_type_base          = std::remove_reference_t<return_type>>
+[[nodiscard]] auto when_any(std::allocator_arg_t, alloc_type alloc, range_type awaitables) -> coro::task<return_type_base>
 {
     coro::event notify{};
 
-    if constexpr (std::is_void_v<return_type_base>)
+    if constexpr (detail::is_task<awaitable_type>::value)
     {
-        auto controller_task =
-            detail::make_when_any_controller_task_return_void(std::forward<range_type>(awaitables), notify);
+        auto* state = detail::when_any_task_range_state<alloc_type, awaitable_type, return_type_base>::make(
+            alloc, std::move(awaitables));
+        co_await *state;
+        co_return state->take_result();
+    }
+    else if constexpr (std::is_void_v<return_type_base>)
+    {
+        auto controller_task = detail::make_when_any_controller_task_return_void(
+            std::allocator_arg, alloc, std::forward<range_type>(awaitables), notify);
         controller_task.handle().resume();
 
         co_await notify;
@@ -227,8 +650,8 @@ template<
     {
         std::optional<return_type_base> return_value{std::nullopt};
 
-        auto controller_task =
-            detail::make_when_any_controller_task(std::forward<range_type>(awaitables), notify, return_value);
+        auto controller_task = detail::make_when_any_controller_task(
+            std::allocator_arg, alloc, std::forward<range_type>(awaitables), notify, return_value);
         controller_task.handle().resume();
 
         co_await notify;
@@ -236,6 +659,16 @@ template<
     }
 }
 
+template<
+    std::ranges::range  range_type,
+    concepts::awaitable awaitable_type = std::ranges::range_value_t<range_type>,
+    typename return_type               = typename concepts::awaitable_traits<awaitable_type>::awaiter_return_type,
+    typename return_type_base          = std::remove_reference_t<return_type>>
+[[nodiscard]] auto when_any(range_type awaitables) -> coro::task<return_type_base>
+{
+    return when_any(std::allocator_arg, std::allocator<void>{}, std::forward<range_type>(awaitables));
+}
+
 } // namespace coro
 
 #endif // EMSCRIPTEN
@@ -0,0 +1,160 @@
+#include "coro/async_stack.hpp"
+
+#include <mutex>
+#include <unordered_set>
+
+namespace coro
+{
+namespace
+{
+thread_local const async_stack_frame* t_current{nullptr};
+} // namespace
+
+/**
+ * Every attached frame, in an intrusive list so attaching never allocates.
+ */
+struct async_stack_registry
+{
+    static auto instance() noexcept -> async_stack_registry&
+    {
+        static async_stack_registry s_registry{};
+        return s_registry;
+    }
+
+    auto attach(async_stack_frame& frame) noexcept -> void
+    {
+        std::scoped_lock lk{m_mutex};
+        frame.m_prev = nullptr;
+        frame.m_next = m_head;
+        if (m_head != nullptr)
+        {
+            m_head->m_prev = &frame;
+        }
+        m_head          = &frame;
+        frame.m_attached = true;
+    }
+
+    auto detach(async_stack_frame& frame) noexcept -> void
+    {
+        std::scoped_lock lk{m_mutex};
+        if (!frame.m_attached)
+        {
+            return;
+        }
+
+        if (frame.m_prev != nullptr)
+        {
+            frame.m_prev->m_next = frame.m_next;
+        }
+        else
+        {
+            m_head = frame.m_next;
+        }
+        if (frame.m_next != nullptr)
+        {
+            frame.m_next->m_prev = frame.m_prev;
+        }
+        frame.m_prev     = nullptr;
+        frame.m_next     = nullptr;
+        frame.m_attached = false;
+    }
+
+    auto suspended() -> std::vector<std::vector<async_stack_entry>>
+    {
+        // Frames can only be destroyed after they detach, holding the lock keeps every chain alive.
+        std::scoped_lock lk{m_mutex};
+
+        std::unordered_set<const async_stack_frame*> parents{};
+        for (auto* frame = m_head; frame != nullptr; frame = frame->m_next)
+        {
+            if (const auto* parent = frame->parent(); parent != nullptr)
+            {
+                parents.emplace(parent);
+            }
+        }
+
+        std::vector<std::vector<async_stack_entry>> result{};
+        for (auto* frame = m_head; frame != nullptr; frame = frame->m_next)
+        {
+            if (!parents.contains(frame))
+            {
+                result.emplace_back(async_stack::backtrace(frame));
+            }
+        }
+        return result;
+    }
+
+    std::mutex         m_mutex{};
+    async_stack_frame* m_head{nullptr};
+};
+
+async_stack_frame::~async_stack_frame()
+{
+    detach();
+}
+
+auto async_stack_frame::attach(std::coroutine_handle<> coroutine) noexcept -> void
+{
+    m_coroutine = coroutine;
+    async_stack_registry::instance().attach(*this);
+}
+
+auto async_stack_frame::detach() noexcept -> void
+{
+    async_stack_registry::instance().detach(*this);
+    parent(nullptr);
+}
+
+namespace async_stack
+{
+auto current() noexcept -> const async_stack_frame*
+{
+    return t_current;
+}
+
+auto current(const async_stack_frame* frame) noexcept -> void
+{
+    t_current = frame;
+}
+
+auto backtrace(const async_stack_frame* frame) -> std::vector<async_stack_entry>
+{
+    std::vector<async_stack_entry> entries{};
+    for (; frame != nullptr; frame = frame->parent())
+    {
+        entries.emplace_back(async_stack_entry{
+            .coroutine      = frame->coroutine().address(),
+            .resume_address = frame->resume_address(),
+            .location       = frame->location()});
+    }
+    return entries;
+}
+
+auto suspended() -> std::vector<std::vector<async_stack_entry>>
+{
+    return async_stack_registry::instance().suspended();
+}
+
+auto dump(std::ostream& out) -> void
+{
+    auto chains = suspended();
+    for (std::size_t i = 0; i < chains.size(); ++i)
+    {
+        out << "async stack " << i << ":\n";
+        for (std::size_t depth = 0; depth < chains[i].size(); ++depth)
+        {
+            const auto& entry = chains[i][depth];
+            out << "  #" << depth << " coroutine=" << entry.coroutine << " resume=" << entry.resume_address;
+            if (entry.location.line() != 0)
+            {
+                out << " at " << entry.location.file_name() << ":" << entry.location.line() << " in "
+                    << entry.location.function_name();
+            }
+            out << "\n";
+        }
+    }
+}
+
+} // namespace async_stack
+
+} // namespace coro
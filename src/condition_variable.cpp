@@ -13,6 +13,12 @@ condition_variable::awaiter_base::awaiter_base(
 
 }
 
+auto condition_variable::awaiter_base::relock() -> bool
+{
+    auto& relock = m_relock.emplace(*m_lock.m_mutex);
+    return relock.await_ready() || !relock.await_suspend(m_awaiting_coroutine);
+}
+
 condition_variable::awaiter::awaiter(
     coro::condition_variable& cv,
     coro::scoped_lock& l
@@ -30,7 +36,7 @@ auto condition_variable::awaiter::await_ready() const noexcept -> bool
 auto condition_variable::awaiter::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
 {
     m_awaiting_coroutine = awaiting_coroutine;
-    coro::detail::awaiter_list_push(m_condition_variable.m_awaiters, static_cast<awaiter_base*>(this));
+    m_condition_variable.enqueue(this);
     m_lock.m_mutex->unlock();
     return true;
 }
@@ -43,6 +49,15 @@ auto condition_variable::awaiter::on_notify() -> coro::task<condition_variable::
     co_return notify_status_t::ready;
 }
 
+auto condition_variable::awaiter::try_morph() -> bool
+{
+    if (relock())
+    {
+        m_awaiting_coroutine.resume();
+    }
+    return true;
+}
+
 condition_variable::awaiter_with_predicate::awaiter_with_predicate(
     coro::condition_variable& cv,
     coro::scoped_lock& l,
@@ -60,7 +75,7 @@ auto condition_variable::awaiter_with_predicate::await_ready() const noexcept ->
 auto condition_variable::awaiter_with_predicate::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
 {
     m_awaiting_coroutine = awaiting_coroutine;
-    coro::detail::awaiter_list_push(m_condition_variable.m_awaiters, static_cast<awaiter_base*>(this));
+    m_condition_variable.enqueue(this);
     m_lock.m_mutex->unlock();
     return true;
 }
@@ -74,6 +89,7 @@ auto condition_variable::awaiter_with_predicate::on_notify() -> coro::task<condi
         co_return notify_status_t::ready;
     }
 
+    m_condition_variable.enqueue(this);
     m_lock.m_mutex->unlock();
     co_return notify_status_t::not_ready;
 }
@@ -102,7 +118,7 @@ auto condition_variable::awaiter_with_predicate_stop_token::await_ready() noexce
 auto condition_variable::awaiter_with_predicate_stop_token::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
 {
     m_awaiting_coroutine = awaiting_coroutine;
-    coro::detail::awaiter_list_push(m_condition_variable.m_awaiters, static_cast<awaiter_base*>(this));
+    m_condition_variable.enqueue(this);
     m_lock.m_mutex->unlock();
     return true;
 }
@@ -119,6 +135,7 @@ auto condition_variable::awaiter_with_predicate_stop_token::on_notify() -> coro:
         co_return notify_status_t::ready;
     }
 
+    m_condition_variable.enqueue(this);
     m_lock.m_mutex->unlock();
     co_return notify_status_t::not_ready;
 }
@@ -127,130 +144,239 @@ auto condition_variable::awaiter_with_predicate_stop_token::on_notify() -> coro:
 
 #ifdef LIBCORO_FEATURE_NETWORKING
 
-condition_variable::controller_data::controller_data(
-    std::optional<std::cv_status>& status,
-    bool& predicate_result,
+condition_variable::awaiter_with_wait_base::awaiter_with_wait_base(
+    std::shared_ptr<io_scheduler> scheduler,
+    coro::condition_variable& cv,
+    coro::scoped_lock& l,
+    const std::chrono::nanoseconds wait_for,
     std::optional<condition_variable::predicate_type> predicate,
-    std::optional<const std::stop_token> stop_token
+    std::optional<std::stop_token> stop_token
 ) noexcept
-    : m_status(status),
-      m_predicate_result(predicate_result),
+    : awaiter_base(cv, l),
+      m_scheduler(std::move(scheduler)),
+      m_wait_for(wait_for),
       m_predicate(std::move(predicate)),
-      m_stop_token({std::move(stop_token)})
+      m_stop_token(std::move(stop_token))
+{
+    m_timer.m_awaiter    = this;
+    m_timer.m_on_timeout = &awaiter_with_wait_base::on_timeout;
+}
+
+auto condition_variable::awaiter_with_wait_base::await_ready() noexcept -> bool
 {
+    // If there is no predicate then we are not ready.
+    if (!m_predicate.has_value())
+    {
+        return false;
+    }
 
+    m_predicate_result = m_predicate.value()();
+    return m_predicate_result;
 }
 
-condition_variable::awaiter_with_wait_hook::awaiter_with_wait_hook(
-    coro::condition_variable& cv,
-    coro::scoped_lock& l,
-    condition_variable::controller_data& data
-) noexcept
-    : awaiter_base(cv, l),
-      m_data(data)
+auto condition_variable::awaiter_with_wait_base::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
 {
+    m_awaiting_coroutine = awaiting_coroutine;
+    m_timer.record_worker();
+    m_timer.m_awaiting_coroutine = awaiting_coroutine;
 
+    // Enqueue before arming the timer so an expired timer always finds the waiter claimable, nobody can notify it
+    // until the lock is released.
+    m_condition_variable.enqueue(this);
+    m_scheduler->add_timer_callback(coro::clock::now() + m_wait_for, m_timer);
+    m_lock.m_mutex->unlock();
+    return true;
 }
 
-auto condition_variable::awaiter_with_wait_hook::on_notify() -> coro::task<condition_variable::notify_status_t>
+auto condition_variable::awaiter_with_wait_base::on_notify() -> coro::task<condition_variable::notify_status_t>
 {
-    auto event_lock = co_await m_data.m_event_mutex.scoped_lock();
+    co_await m_lock.m_mutex->lock();
+
+    bool ready{true};
+    if (m_predicate.has_value())
+    {
+        m_predicate_result = m_predicate.value()();
+        // If the predicate is ready or we've been requested to stop then we are ready.
+        ready = m_predicate_result || (m_stop_token.has_value() && m_stop_token.value().stop_requested());
+    }
+
+    // Once disarmed the timer can never fire, this notify owns the waiter.
+    if (ready && m_scheduler->cancel_timer_callback(m_timer))
+    {
+        m_awaiting_coroutine.resume();
+        co_return notify_status_t::ready;
+    }
 
-    // See if this awaiter is a real notify or if it has timed out already.
-    if (m_data.m_awaiter_completed.load(std::memory_order::acquire))
+    std::unique_lock lk{m_condition_variable.m_awaiters_mutex};
+    if (m_expired)
     {
-        // This awaiter timed out, report as dead after killing/resuming the on notify callback task.
-        event_lock.unlock();
-        m_data.m_notify_callback.set();
+        // The timer expired while this waiter was dequeued, its callback left the resume to this notify which
+        // holds the lock on the waiter's behalf.
+        lk.unlock();
+        m_awaiting_coroutine.resume();
         co_return notify_status_t::awaiter_dead;
     }
 
-    auto* waiter_mutex = m_lock.m_mutex;
-    co_await waiter_mutex->lock();
+    if (!ready)
+    {
+        m_condition_variable.link(this);
+        lk.unlock();
+        m_lock.m_mutex->unlock();
+        co_return notify_status_t::not_ready;
+    }
+
+    // The event loop has taken the timer but its callback has yet to claim the waiter, hand it the resume.
+    m_notified = true;
+    lk.unlock();
+    co_return notify_status_t::ready;
+}
 
-    // If there is no predicate then this awaiter is always ready on notify.
-    if (!m_data.m_predicate.has_value())
+auto condition_variable::awaiter_with_wait_base::try_morph() -> bool
+{
+    // Once disarmed the timer can never fire, otherwise on_notify() settles the race with it.
+    if (m_predicate.has_value() || !m_scheduler->cancel_timer_callback(m_timer))
     {
-        m_data.m_awaiter_completed.exchange(true, std::memory_order::release);
-        m_data.m_status = {std::cv_status::no_timeout};
-        event_lock.unlock();
-        m_data.m_notify_callback.set();
-        co_return notify_status_t::ready;
+        return false;
     }
 
-    m_data.m_predicate_result = m_data.m_predicate.value()();
+    if (relock())
+    {
+        m_awaiting_coroutine.resume();
+    }
+    return true;
+}
+
+auto condition_variable::awaiter_with_wait_base::on_timeout(detail::poll_info& pi) -> bool
+{
+    auto& self = *static_cast<timer_node&>(pi).m_awaiter;
+    auto& cv   = self.m_condition_variable;
 
-    // If the predicate is ready or we've been requested to stop then we are ready.
-    if (m_data.m_predicate_result || (m_data.m_stop_token.has_value() && m_data.m_stop_token.value().stop_requested()))
     {
-        m_data.m_awaiter_completed.exchange(true, std::memory_order::release);
-        m_data.m_status = {std::cv_status::no_timeout};
-        event_lock.unlock();
-        m_data.m_notify_callback.set();
-        co_return notify_status_t::ready;
+        std::scoped_lock lk{cv.m_awaiters_mutex};
+        if (self.m_notified)
+        {
+            // A notify claimed the waiter and holds the lock on its behalf.
+            return true;
+        }
+
+        self.m_expired = true;
+        if (!self.m_queued)
+        {
+            // A notify has dequeued the waiter, it sees the expiry and resumes the waiter.
+            return false;
+        }
+        cv.unlink(&self);
     }
 
-    waiter_mutex->unlock();
-    co_return notify_status_t::not_ready;
+    // Before resuming the wait_[for|until]() caller the lock must be re-acquired, if it is held the mutex resumes
+    // the caller once it is unlocked.
+    return self.relock();
 }
 
 #endif
 
 auto condition_variable::notify_one() -> coro::task<void>
 {
-    // The loop is here in case there are *dead* awaiter_hook_tasks that need to be skipped.
+    // The loop is here in case a timed waiter expires while it is being notified.
     while (true)
     {
-        auto* waiter = detail::awaiter_list_pop(m_awaiters);
+        auto* waiter = dequeue();
         if (waiter == nullptr)
         {
             co_return; // There is nobody to currently notify.
         }
 
-        switch (co_await waiter->on_notify())
+        auto status = co_await waiter->on_notify();
+        if (status != notify_status_t::awaiter_dead)
         {
-            case notify_status_t::ready:
-                // The predicate was ready and the awaiter is resumed.
-                co_return;
-            case notify_status_t::not_ready:
-                // Re-enqueue since the predicate isn't ready and return since the notify has been satisfied.
-                coro::detail::awaiter_list_push(m_awaiters, waiter);
-                co_return;
-            case notify_status_t::awaiter_dead:
-                // This is an awaiter_with_wait_hook that timed out, try the next awaiter.
-                break;
+            // Either the waiter was resumed or it re-enqueued itself, the notify has been satisfied.
+            co_return;
         }
     }
 }
 
 auto condition_variable::notify_all() -> coro::task<void>
 {
-    auto* waiter = detail::awaiter_list_pop_all(m_awaiters);
-    awaiter_base* next;
-
-    while (waiter != nullptr)
+    // Waiters that are not ready re-enqueue themselves past the epoch and are not notified twice.
+    auto epoch = notify_epoch();
+    while (auto* waiter = dequeue(epoch))
     {
-        // Need to grab next before notifying since the notifier will self destruct after completing.
-        next = waiter->m_next;
-
-        switch (co_await waiter->on_notify())
+        if (!waiter->try_morph())
         {
-            case notify_status_t::not_ready:
-                // Re-enqueue since the predicate isn't ready and return since the notify has been satisfied.
-                coro::detail::awaiter_list_push(m_awaiters, waiter);
-                break;
-            case notify_status_t::ready:
-            case notify_status_t::awaiter_dead:
-                // Don't re-enqueue any awaiters that are ready or dead.
-                break;
+            co_await waiter->on_notify();
         }
-
-        waiter = next;
     }
 
     co_return;
 }
 
+auto condition_variable::link(awaiter_base* waiter) -> void
+{
+    waiter->m_epoch  = m_next_epoch++;
+    waiter->m_queued = true;
+    waiter->m_prev   = m_awaiters_tail;
+    waiter->m_next   = nullptr;
+    if (m_awaiters_tail != nullptr)
+    {
+        m_awaiters_tail->m_next = waiter;
+    }
+    else
+    {
+        m_awaiters = waiter;
+    }
+    m_awaiters_tail = waiter;
+}
+
+auto condition_variable::unlink(awaiter_base* waiter) -> void
+{
+    if (waiter->m_prev != nullptr)
+    {
+        waiter->m_prev->m_next = waiter->m_next;
+    }
+    else
+    {
+        m_awaiters = waiter->m_next;
+    }
+
+    if (waiter->m_next != nullptr)
+    {
+        waiter->m_next->m_prev = waiter->m_prev;
+    }
+    else
+    {
+        m_awaiters_tail = waiter->m_prev;
+    }
+
+    waiter->m_prev   = nullptr;
+    waiter->m_next   = nullptr;
+    waiter->m_queued = false;
+}
+
+auto condition_variable::enqueue(awaiter_base* waiter) -> void
+{
+    std::scoped_lock lk{m_awaiters_mutex};
+    link(waiter);
+}
+
+auto condition_variable::dequeue(std::uint64_t before_epoch) -> awaiter_base*
+{
+    std::scoped_lock lk{m_awaiters_mutex};
+    auto* waiter = m_awaiters;
+    if (waiter == nullptr || waiter->m_epoch >= before_epoch)
+    {
+        return nullptr;
+    }
+
+    unlink(waiter);
+    return waiter;
+}
+
+auto condition_variable::notify_epoch() -> std::uint64_t
+{
+    std::scoped_lock lk{m_awaiters_mutex};
+    return m_next_epoch;
+}
+
 auto condition_variable::wait(coro::scoped_lock& lock) -> awaiter
 {
     return awaiter{*this, lock};
@@ -3,11 +3,17 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <cerrno>
 #include <chrono>
 #include <stdexcept>
 
 #include "coro/detail/timer_handle.hpp"
 
+// epoll_pwait2() takes a nanosecond resolution timeout, it was added in linux 5.11 and glibc 2.35.
+#if defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 35))
+    #define LIBCORO_HAS_EPOLL_PWAIT2
+#endif
+
 using namespace std::chrono_literals;
 
 namespace coro::detail
@@ -89,11 +95,42 @@ auto io_notifier_epoll::unwatch_timer(const detail::timer_handle& timer) -> bool
 }
 
 auto io_notifier_epoll::next_events(
-    std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
+    std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::nanoseconds timeout)
     -> void
 {
     auto ready_set = std::array<event_t, m_max_events>{};
-    int  num_ready = ::epoll_wait(m_fd, ready_set.data(), ready_set.size(), timeout.count());
+    int  num_ready{-1};
+
+#if defined(LIBCORO_HAS_EPOLL_PWAIT2)
+    if (m_epoll_pwait2_supported)
+    {
+        // A negative timeout blocks indefinitely.
+        auto  timeout_spec = ::timespec{};
+        auto* timeout_ptr  = static_cast<::timespec*>(nullptr);
+        if (timeout >= 0ns)
+        {
+            auto seconds         = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+            timeout_spec.tv_sec  = seconds.count();
+            timeout_spec.tv_nsec = (timeout - seconds).count();
+            timeout_ptr          = &timeout_spec;
+        }
+
+        num_ready = ::epoll_pwait2(m_fd, ready_set.data(), ready_set.size(), timeout_ptr, nullptr);
+        if (num_ready == -1 && errno == ENOSYS)
+        {
+            m_epoll_pwait2_supported = false;
+        }
+    }
+
+    if (!m_epoll_pwait2_supported)
+#endif
+    {
+        // epoll_wait() only has millisecond resolution, round up so the wait never returns early.
+        auto timeout_ms =
+            (timeout < 0ns) ? -1 : static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+        num_ready = ::epoll_wait(m_fd, ready_set.data(), ready_set.size(), timeout_ms);
+    }
+
     for (int i = 0; i < num_ready; ++i)
     {
         ready_events.emplace_back(
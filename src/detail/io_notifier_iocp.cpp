@@ -128,7 +128,7 @@ auto io_notifier_iocp::watch(coro::signal& signal, void* data) -> bool
  */
 auto io_notifier_iocp::next_events(
     std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events,
-    const std::chrono::milliseconds                                timeout) -> void
+    const std::chrono::nanoseconds                                 timeout) -> void
 {
     using namespace std::chrono;
 
@@ -171,7 +171,9 @@ auto io_notifier_iocp::next_events(
 
     std::array<OVERLAPPED_ENTRY, max_events> entries{};
     ULONG                                    number_of_events{};
-    const DWORD dword_timeout = (timeout <= 0ms) ? INFINITE : static_cast<DWORD>(timeout.count());
+    // Round up so a sub-millisecond timeout never returns before it has elapsed.
+    const DWORD dword_timeout =
+        (timeout <= 0ns) ? INFINITE : static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
 
     if (const BOOL ok = GetQueuedCompletionStatusEx(
             m_iocp, entries.data(), entries.size(), &number_of_events, dword_timeout, FALSE);
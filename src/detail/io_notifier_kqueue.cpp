@@ -135,7 +135,7 @@ auto io_notifier_kqueue::unwatch_timer(const detail::timer_handle& timer) -> boo
 }
 
 auto io_notifier_kqueue::next_events(
-    std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::milliseconds timeout)
+    std::vector<std::pair<detail::poll_info*, coro::poll_status>>& ready_events, std::chrono::nanoseconds timeout)
     -> void
 {
     auto       ready_set       = std::array<event_t, m_max_events>{};
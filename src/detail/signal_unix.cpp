@@ -2,6 +2,7 @@
 // Created by pyxiion on 13.06.2025.
 //
 #include "coro/detail/signal_unix.hpp"
+#include <fcntl.h>
 #include <unistd.h>
 
 namespace coro::detail
@@ -9,6 +10,8 @@ namespace coro::detail
 signal_unix::signal_unix()
 {
     ::pipe(m_pipe.data());
+    // The read end is drained on unset() without knowing how many times the signal was set.
+    ::fcntl(m_pipe[0], F_SETFL, ::fcntl(m_pipe[0], F_GETFL) | O_NONBLOCK);
 }
 signal_unix::~signal_unix()
 {
@@ -29,6 +32,8 @@ void signal_unix::set()
 void signal_unix::unset()
 {
     int control = 0;
-    ::read(m_pipe[1], reinterpret_cast<void*>(&control), sizeof(control));
+    while (::read(m_pipe[0], reinterpret_cast<void*>(&control), sizeof(control)) > 0)
+    {
+    }
 }
 } // namespace coro::detail
\ No newline at end of file
@@ -0,0 +1,233 @@
+#include "coro/file.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace coro
+{
+static const std::string file_status_ok{"ok"};
+static const std::string file_status_end_of_file{"end_of_file"};
+static const std::string file_status_error{"error"};
+static const std::string file_status_unknown{"unknown"};
+
+auto to_string(file_status status) -> const std::string&
+{
+    switch (status)
+    {
+        case file_status::ok:
+            return file_status_ok;
+        case file_status::end_of_file:
+            return file_status_end_of_file;
+        case file_status::error:
+            return file_status_error;
+        default:
+            return file_status_unknown;
+    }
+}
+
+static auto open_mode_to_os(file::open_mode mode) -> int
+{
+    switch (mode)
+    {
+        case file::open_mode::read:
+            return O_RDONLY;
+        case file::open_mode::write:
+            return O_WRONLY | O_CREAT;
+        case file::open_mode::write_truncate:
+            return O_WRONLY | O_CREAT | O_TRUNC;
+        case file::open_mode::read_write:
+            return O_RDWR | O_CREAT;
+    }
+    return O_RDONLY;
+}
+
+file::file(
+    std::shared_ptr<io_scheduler> scheduler,
+    std::shared_ptr<thread_pool>  helper,
+    const std::filesystem::path&  path,
+    open_mode                     mode,
+    int                           permissions)
+    : m_io_scheduler(std::move(scheduler)),
+      m_helper(std::move(helper))
+{
+    if (m_io_scheduler == nullptr || m_helper == nullptr)
+    {
+        throw std::runtime_error{"file cannot have a nullptr io_scheduler or helper thread_pool"};
+    }
+
+    m_fd = ::open(path.c_str(), open_mode_to_os(mode) | O_CLOEXEC, permissions);
+    if (m_fd == -1)
+    {
+        throw std::runtime_error{"failed to open " + path.string() + ": " + std::string{strerror(errno)}};
+    }
+}
+
+file::file(std::shared_ptr<io_scheduler> scheduler, std::shared_ptr<thread_pool> helper, fd_t fd)
+    : m_io_scheduler(std::move(scheduler)),
+      m_helper(std::move(helper)),
+      m_fd(fd)
+{
+    if (m_io_scheduler == nullptr || m_helper == nullptr)
+    {
+        throw std::runtime_error{"file cannot have a nullptr io_scheduler or helper thread_pool"};
+    }
+}
+
+file::file(file&& other) noexcept
+    : m_io_scheduler(std::move(other.m_io_scheduler)),
+      m_helper(std::move(other.m_helper)),
+      m_fd(std::exchange(other.m_fd, -1)),
+      m_last_error(other.m_last_error.load(std::memory_order::acquire))
+{
+}
+
+auto file::operator=(file&& other) noexcept -> file&
+{
+    if (std::addressof(other) != this)
+    {
+        close();
+        m_io_scheduler = std::move(other.m_io_scheduler);
+        m_helper       = std::move(other.m_helper);
+        m_fd           = std::exchange(other.m_fd, -1);
+        m_last_error.store(other.m_last_error.load(std::memory_order::acquire), std::memory_order::release);
+    }
+    return *this;
+}
+
+file::~file()
+{
+    close();
+}
+
+auto file::close() -> void
+{
+    if (m_fd != -1)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+auto file::read_at(std::span<char> buffer, uint64_t offset) -> coro::task<std::pair<file_status, std::span<char>>>
+{
+    std::size_t total{0};
+
+#if defined(CORO_PLATFORM_LINUX) && defined(RWF_NOWAIT)
+    // Attempt to read straight from the page cache without blocking, this avoids the round trip
+    // through the helper threads entirely for hot files.  Any failure, including the kernel not
+    // supporting RWF_NOWAIT for this file, falls back to the helper threads.
+    while (total < buffer.size())
+    {
+        iovec iov{.iov_base = buffer.data() + total, .iov_len = buffer.size() - total};
+        auto  n = ::preadv2(m_fd, &iov, 1, static_cast<off_t>(offset + total), RWF_NOWAIT);
+        if (n > 0)
+        {
+            total += static_cast<std::size_t>(n);
+        }
+        else if (n == 0)
+        {
+            co_return {file_status::end_of_file, buffer.subspan(0, total)};
+        }
+        else
+        {
+            break;
+        }
+    }
+#endif
+
+    if (total == buffer.size())
+    {
+        co_return {file_status::ok, buffer};
+    }
+
+    co_await m_helper->schedule();
+
+    auto status = file_status::ok;
+    while (total < buffer.size())
+    {
+        auto n = ::pread(m_fd, buffer.data() + total, buffer.size() - total, static_cast<off_t>(offset + total));
+        if (n > 0)
+        {
+            total += static_cast<std::size_t>(n);
+        }
+        else if (n == 0)
+        {
+            status = file_status::end_of_file;
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            m_last_error.store(errno, std::memory_order::release);
+            status = file_status::error;
+            break;
+        }
+    }
+
+    co_await m_io_scheduler->schedule();
+    co_return {status, buffer.subspan(0, total)};
+}
+
+auto file::write_at(std::span<const char> buffer, uint64_t offset)
+    -> coro::task<std::pair<file_status, std::span<const char>>>
+{
+    if (buffer.empty())
+    {
+        co_return {file_status::ok, buffer};
+    }
+
+    co_await m_helper->schedule();
+
+    auto        status = file_status::ok;
+    std::size_t total{0};
+    while (total < buffer.size())
+    {
+        auto n = ::pwrite(m_fd, buffer.data() + total, buffer.size() - total, static_cast<off_t>(offset + total));
+        if (n > 0)
+        {
+            total += static_cast<std::size_t>(n);
+        }
+        else if (n == 0)
+        {
+            // No progress with bytes remaining would otherwise spin forever, report it as a short write.
+            m_last_error.store(EIO, std::memory_order::release);
+            status = file_status::error;
+            break;
+        }
+        else if (errno != EINTR)
+        {
+            m_last_error.store(errno, std::memory_order::release);
+            status = file_status::error;
+            break;
+        }
+    }
+
+    co_await m_io_scheduler->schedule();
+    co_return {status, buffer.subspan(total)};
+}
+
+auto file::fsync(bool data_only) -> coro::task<file_status>
+{
+    co_await m_helper->schedule();
+
+    auto status = file_status::ok;
+#if defined(CORO_PLATFORM_LINUX)
+    auto r = data_only ? ::fdatasync(m_fd) : ::fsync(m_fd);
+#else
+    (void)data_only;
+    auto r = ::fsync(m_fd);
+#endif
+    if (r == -1)
+    {
+        m_last_error.store(errno, std::memory_order::release);
+        status = file_status::error;
+    }
+
+    co_await m_io_scheduler->schedule();
+    co_return status;
+}
+
+} // namespace coro
@@ -0,0 +1,327 @@
+#include "coro/frame_allocator.hpp"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace coro
+{
+namespace
+{
+struct thread_cache;
+
+/// Prepended to every allocation, the owner is where the frame returns to when it is freed.
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) block_header
+{
+    /// The thread cache the block belongs to, nullptr if the block is not pooled.
+    thread_cache* m_owner{nullptr};
+    /// The block's size class.
+    std::size_t m_size_class{0};
+};
+
+/// While a block is free the start of its payload links it to the next free block.
+auto next_of(block_header* block) noexcept -> block_header*&
+{
+    return *reinterpret_cast<block_header**>(block + 1);
+}
+
+auto block_size(std::size_t size_class) noexcept -> std::size_t
+{
+    return (size_class + 1) * frame_allocator::size_class_granularity;
+}
+
+struct thread_cache
+{
+    /// Freelists per size class, only touched by the owning thread.
+    std::array<block_header*, frame_allocator::size_class_count> m_free{};
+    /// Blocks freed by other threads, pushed a batch at a time and reclaimed by the owning thread.
+    std::atomic<block_header*> m_remote{nullptr};
+    /// Set once the owning thread has exited, frees to an orphaned cache go to the global allocator.
+    std::atomic<bool> m_orphaned{false};
+
+    /// Blocks this thread freed that belong to m_batch_owner, handed over once the batch is full.
+    thread_cache* m_batch_owner{nullptr};
+    block_header* m_batch_head{nullptr};
+    block_header* m_batch_tail{nullptr};
+    std::size_t   m_batch_count{0};
+
+    /// Counters, only written by the owning thread.
+    std::atomic<uint64_t> m_hits{0};
+    std::atomic<uint64_t> m_misses{0};
+    std::atomic<uint64_t> m_remote_frees{0};
+    std::atomic<uint64_t> m_bytes_cached{0};
+};
+
+/// Single writer counter update, avoids a locked read-modify-write on the allocation path.
+auto counter_add(std::atomic<uint64_t>& counter, uint64_t amount) noexcept -> void
+{
+    counter.store(counter.load(std::memory_order::relaxed) + amount, std::memory_order::relaxed);
+}
+
+auto counter_sub(std::atomic<uint64_t>& counter, uint64_t amount) noexcept -> void
+{
+    counter.store(counter.load(std::memory_order::relaxed) - amount, std::memory_order::relaxed);
+}
+
+struct cache_registry
+{
+    std::mutex m_mutex{};
+    /// Every thread cache ever created, caches are recycled but never destroyed so blocks can always
+    /// be returned to their owner.
+    std::vector<thread_cache*> m_caches{};
+    /// Caches whose thread has exited, a new thread adopts one before creating a new cache.
+    std::vector<thread_cache*> m_orphaned{};
+};
+
+/// Intentionally leaked so threads that exit during static destruction can still return their cache.
+auto registry() -> cache_registry&
+{
+    static auto* r = new cache_registry{};
+    return *r;
+}
+
+auto free_list(block_header* block) noexcept -> void
+{
+    while (block != nullptr)
+    {
+        auto* next = next_of(block);
+        ::operator delete(block);
+        block = next;
+    }
+}
+
+auto push_remote(thread_cache& owner, block_header* head, block_header* tail) noexcept -> void
+{
+    auto* expected = owner.m_remote.load(std::memory_order::relaxed);
+    do
+    {
+        next_of(tail) = expected;
+    } while (!owner.m_remote.compare_exchange_weak(
+        expected, head, std::memory_order::seq_cst, std::memory_order::relaxed));
+
+    // If the owner exited nobody will ever reclaim these, free them.  The owning thread sets the flag
+    // before draining so between the two of them every block is freed exactly once.
+    if (owner.m_orphaned.load(std::memory_order::seq_cst))
+    {
+        free_list(owner.m_remote.exchange(nullptr, std::memory_order::acquire));
+    }
+}
+
+auto flush_batch(thread_cache& cache) noexcept -> void
+{
+    if (cache.m_batch_count > 0)
+    {
+        push_remote(*cache.m_batch_owner, cache.m_batch_head, cache.m_batch_tail);
+        cache.m_batch_owner = nullptr;
+        cache.m_batch_head  = nullptr;
+        cache.m_batch_tail  = nullptr;
+        cache.m_batch_count = 0;
+    }
+}
+
+auto release_cached(thread_cache& cache) noexcept -> void
+{
+    flush_batch(cache);
+    for (auto& head : cache.m_free)
+    {
+        free_list(head);
+        head = nullptr;
+    }
+    cache.m_bytes_cached.store(0, std::memory_order::relaxed);
+}
+
+/// Reclaims the blocks other threads freed back onto this cache's freelists.
+auto reclaim_remote(thread_cache& cache) noexcept -> void
+{
+    auto* block = cache.m_remote.exchange(nullptr, std::memory_order::acquire);
+    while (block != nullptr)
+    {
+        auto* next = next_of(block);
+        auto  size = block_size(block->m_size_class);
+        if (cache.m_bytes_cached.load(std::memory_order::relaxed) + size <= frame_allocator::max_cached_bytes)
+        {
+            next_of(block)                    = cache.m_free[block->m_size_class];
+            cache.m_free[block->m_size_class] = block;
+            counter_add(cache.m_bytes_cached, size);
+        }
+        else
+        {
+            ::operator delete(block);
+        }
+        block = next;
+    }
+}
+
+struct thread_cache_handle
+{
+    thread_cache_handle()
+    {
+        auto&            r = registry();
+        std::scoped_lock lk{r.m_mutex};
+        if (!r.m_orphaned.empty())
+        {
+            m_cache = r.m_orphaned.back();
+            r.m_orphaned.pop_back();
+            m_cache->m_orphaned.store(false, std::memory_order::seq_cst);
+        }
+        else
+        {
+            m_cache = new thread_cache{};
+            r.m_caches.emplace_back(m_cache);
+        }
+    }
+
+    ~thread_cache_handle()
+    {
+        release_cached(*m_cache);
+        m_cache->m_orphaned.store(true, std::memory_order::seq_cst);
+        free_list(m_cache->m_remote.exchange(nullptr, std::memory_order::acquire));
+
+        auto&            r = registry();
+        std::scoped_lock lk{r.m_mutex};
+        r.m_orphaned.emplace_back(m_cache);
+        t_destroyed = true;
+    }
+
+    thread_cache* m_cache{nullptr};
+
+    /// Frames freed during thread exit after the cache is gone bypass it.
+    static thread_local bool t_destroyed;
+};
+
+thread_local bool thread_cache_handle::t_destroyed{false};
+
+auto local_cache() -> thread_cache*
+{
+    if (thread_cache_handle::t_destroyed)
+    {
+        return nullptr;
+    }
+    thread_local thread_cache_handle handle{};
+    return handle.m_cache;
+}
+
+} // namespace
+
+auto frame_allocator::allocate(std::size_t size) -> void*
+{
+    auto total = size + sizeof(block_header);
+    if (total > max_pooled_size)
+    {
+        auto* block = static_cast<block_header*>(::operator new(total));
+        new (block) block_header{};
+        return block + 1;
+    }
+
+    auto  size_class = (total - 1) / size_class_granularity;
+    auto* cache      = local_cache();
+    if (cache == nullptr)
+    {
+        auto* block = static_cast<block_header*>(::operator new(block_size(size_class)));
+        new (block) block_header{.m_owner = nullptr, .m_size_class = size_class};
+        return block + 1;
+    }
+
+    if (cache->m_free[size_class] == nullptr && cache->m_remote.load(std::memory_order::relaxed) != nullptr)
+    {
+        reclaim_remote(*cache);
+    }
+
+    if (auto* block = cache->m_free[size_class]; block != nullptr)
+    {
+        cache->m_free[size_class] = next_of(block);
+        counter_sub(cache->m_bytes_cached, block_size(size_class));
+        counter_add(cache->m_hits, 1);
+        return block + 1;
+    }
+
+    counter_add(cache->m_misses, 1);
+    auto* block = static_cast<block_header*>(::operator new(block_size(size_class)));
+    new (block) block_header{.m_owner = cache, .m_size_class = size_class};
+    return block + 1;
+}
+
+auto frame_allocator::deallocate(void* ptr, std::size_t /*size*/) noexcept -> void
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+
+    auto* block = static_cast<block_header*>(ptr) - 1;
+    auto* owner = block->m_owner;
+    if (owner == nullptr)
+    {
+        ::operator delete(block);
+        return;
+    }
+
+    auto* cache = local_cache();
+    if (cache == nullptr)
+    {
+        // This thread is exiting, hand the block straight back to its owner.
+        push_remote(*owner, block, block);
+        return;
+    }
+
+    if (owner == cache)
+    {
+        auto size = block_size(block->m_size_class);
+        if (cache->m_bytes_cached.load(std::memory_order::relaxed) + size <= max_cached_bytes)
+        {
+            next_of(block)                     = cache->m_free[block->m_size_class];
+            cache->m_free[block->m_size_class] = block;
+            counter_add(cache->m_bytes_cached, size);
+        }
+        else
+        {
+            ::operator delete(block);
+        }
+        return;
+    }
+
+    // Batch up frees to the same owner, frames usually ping-pong between the same pair of threads.
+    counter_add(cache->m_remote_frees, 1);
+    if (cache->m_batch_owner != owner)
+    {
+        flush_batch(*cache);
+        cache->m_batch_owner = owner;
+        cache->m_batch_tail  = block;
+    }
+    next_of(block)      = cache->m_batch_head;
+    cache->m_batch_head = block;
+    if (++cache->m_batch_count >= remote_batch_size)
+    {
+        flush_batch(*cache);
+    }
+}
+
+auto frame_allocator::stats() -> statistics
+{
+    statistics s{};
+
+    auto&            r = registry();
+    std::scoped_lock lk{r.m_mutex};
+    for (auto* cache : r.m_caches)
+    {
+        s.hits += cache->m_hits.load(std::memory_order::relaxed);
+        s.misses += cache->m_misses.load(std::memory_order::relaxed);
+        s.remote_frees += cache->m_remote_frees.load(std::memory_order::relaxed);
+        s.bytes_cached += cache->m_bytes_cached.load(std::memory_order::relaxed);
+    }
+
+    return s;
+}
+
+auto frame_allocator::trim() noexcept -> void
+{
+    if (auto* cache = local_cache(); cache != nullptr)
+    {
+        release_cached(*cache);
+        free_list(cache->m_remote.exchange(nullptr, std::memory_order::acquire));
+    }
+}
+
+} // namespace coro
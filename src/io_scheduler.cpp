@@ -2,6 +2,7 @@
 #include "coro/detail/task_self_deleting.hpp"
 #include "coro/platform.hpp"
 
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <optional>
@@ -14,6 +15,10 @@
     #include <Windows.h>
 #endif
 
+#if defined(CORO_PLATFORM_LINUX)
+    #include <sys/prctl.h>
+#endif
+
 using namespace std::chrono_literals;
 
 namespace coro
@@ -33,6 +38,10 @@ io_scheduler::io_scheduler(options&& opts, private_constructor)
 
     m_io_notifier.watch(m_schedule_signal, const_cast<void*>(m_schedule_ptr));
 
+#if defined(CORO_PLATFORM_UNIX)
+    m_io_notifier.watch(m_cancel_signal, const_cast<void*>(m_cancel_ptr));
+#endif
+
     m_recent_events.reserve(m_max_events);
 }
 
@@ -61,7 +70,7 @@ io_scheduler::~io_scheduler()
     }
 }
 
-auto io_scheduler::process_events(std::chrono::milliseconds timeout) -> std::size_t
+auto io_scheduler::process_events(std::chrono::nanoseconds timeout) -> std::size_t
 {
     process_events_manual(timeout);
     return size();
@@ -93,10 +102,8 @@ auto io_scheduler::yield_until(time_point time) -> coro::task<void>
     {
         m_size.fetch_add(1, std::memory_order::release);
 
-        auto amount = std::chrono::duration_cast<std::chrono::milliseconds>(time - now);
-
         detail::poll_info pi{};
-        add_timer_token(now + amount, pi);
+        add_timer_token(time, pi);
         co_await pi;
 
         m_size.fetch_sub(1, std::memory_order::release);
@@ -106,40 +113,93 @@ auto io_scheduler::yield_until(time_point time) -> coro::task<void>
 
 #if defined(CORO_PLATFORM_UNIX)
 
-auto io_scheduler::poll(fd_t fd, coro::poll_op op, std::chrono::milliseconds timeout) -> coro::task<poll_status>
+auto io_scheduler::yield_until(time_point time, std::stop_token stop_token) -> coro::task<poll_status>
+{
+    auto now = clock::now();
+    if (time <= now)
+    {
+        co_await schedule();
+        co_return stop_token.stop_requested() ? poll_status::cancelled : poll_status::timeout;
+    }
+
+    // A poll without a file descriptor is only its timer, a stop request cancels it like any other poll.
+    co_return co_await poll_operation{
+        *this, -1, poll_op::read, std::chrono::duration_cast<std::chrono::nanoseconds>(time - now), std::move(stop_token)};
+}
+
+auto io_scheduler::poll_operation::cancel_callback::operator()() noexcept -> void
+{
+    auto& scheduler = m_operation.m_scheduler;
+    {
+        std::scoped_lock lk{scheduler.m_cancelled_polls_mutex};
+        scheduler.m_cancelled_polls.emplace_back(&m_operation.m_pi);
+        m_operation.m_cancel_queued.store(true, std::memory_order::release);
+    }
+    scheduler.m_cancel_signal.set();
+}
+
+auto io_scheduler::poll_operation::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
 {
     // Because the size will drop when this coroutine suspends every poll needs to undo the subtraction
     // on the number of active tasks in the scheduler.  When this task is resumed by the event loop.
-    m_size.fetch_add(1, std::memory_order::release);
+    m_scheduler.m_size.fetch_add(1, std::memory_order::release);
+
+    if (m_stop_token.stop_requested())
+    {
+        m_pi.m_poll_status = poll_status::cancelled;
+        return false;
+    }
 
     // Setup two events, a timeout event and the actual poll for op event.
     // Whichever triggers first will delete the other to guarantee only one wins.
     // The resume token will be set by the scheduler to what the event turned out to be.
-
-    bool timeout_requested = (timeout > 0ms);
-
-    auto pi = detail::poll_info{fd, op};
-
-    if (timeout_requested)
+    if (m_timeout > 0ms)
     {
-        pi.m_timer_pos = add_timer_token(clock::now() + timeout, pi);
+        m_pi.m_timer_pos = m_scheduler.add_timer_token(clock::now() + m_timeout, m_pi);
     }
 
-    if (!m_io_notifier.watch(pi))
+    if (m_pi.m_fd != -1 && !m_scheduler.m_io_notifier.watch(m_pi))
     {
-        std::cerr << "Failed to add " << fd << " to watch list\n";
+        std::cerr << "Failed to add " << m_pi.m_fd << " to watch list\n";
     }
 
     // The event loop will 'clean-up' whichever event didn't win since the coroutine is scheduled
     // onto the thread poll its possible the other type of event could trigger while its waiting
-    // to execute again, thus restarting the coroutine twice, that would be quite bad.
-    auto result = co_await pi;
-    m_size.fetch_sub(1, std::memory_order::release);
-    co_return result;
+    // to execute again, thus restarting the coroutine twice, that would be quite bad.  The event
+    // loop waits for the awaiting coroutine to be set so both registrations above are complete
+    // before it touches either of them.  This includes the stop callback, if a stop is requested
+    // while registering the callback is invoked inline and the event loop waits for the same.
+    if (m_stop_token.stop_possible())
+    {
+        m_stop_callback.emplace(m_stop_token, cancel_callback{*this});
+    }
+
+    m_pi.record_worker();
+    m_pi.m_awaiting_coroutine = awaiting_coroutine;
+    std::atomic_thread_fence(std::memory_order::release);
+    return true;
+}
+
+auto io_scheduler::poll_operation::await_resume() noexcept -> poll_status
+{
+    if (m_stop_callback.has_value())
+    {
+        // Destroying the callback waits for a concurrently executing stop request to finish.  If it
+        // queued this poll but an event won the race, remove it so the event loop never sees it again.
+        m_stop_callback.reset();
+        if (m_cancel_queued.load(std::memory_order::acquire))
+        {
+            std::scoped_lock lk{m_scheduler.m_cancelled_polls_mutex};
+            std::erase(m_scheduler.m_cancelled_polls, &m_pi);
+        }
+    }
+
+    m_scheduler.m_size.fetch_sub(1, std::memory_order::release);
+    return m_pi.m_poll_status;
 }
 
 #elif defined(CORO_PLATFORM_WINDOWS) && defined(LIBCORO_FEATURE_NETWORKING)
-auto io_scheduler::poll(detail::poll_info& pi, std::chrono::milliseconds timeout) -> coro::task<poll_status>
+auto io_scheduler::poll(detail::poll_info& pi, std::chrono::nanoseconds timeout) -> coro::task<poll_status>
 {
     m_size.fetch_add(1, std::memory_order::release);
     bool timeout_requested = (timeout > 0ms);
@@ -213,7 +273,7 @@ auto io_scheduler::yield_for_internal(std::chrono::nanoseconds amount) -> coro::
     co_return;
 }
 
-auto io_scheduler::process_events_manual(std::chrono::milliseconds timeout) -> void
+auto io_scheduler::process_events_manual(std::chrono::nanoseconds timeout) -> void
 {
     bool expected{false};
     if (m_io_processing.compare_exchange_strong(expected, true, std::memory_order::release, std::memory_order::relaxed))
@@ -230,6 +290,11 @@ auto io_scheduler::process_events_dedicated_thread() -> void
         m_opts.on_io_thread_start_functor();
     }
 
+#if defined(CORO_PLATFORM_LINUX)
+    // The default 50us timer slack would coalesce the timerfd wake ups far past sub-millisecond deadlines.
+    ::prctl(PR_SET_TIMERSLACK, 1UL);
+#endif
+
     m_io_processing.exchange(true, std::memory_order::release);
     // Execute tasks until stopped or there are no more tasks to complete.
     while (!m_shutdown_requested.load(std::memory_order::acquire) || size() > 0)
@@ -244,11 +309,19 @@ auto io_scheduler::process_events_dedicated_thread() -> void
     }
 }
 
-auto io_scheduler::process_events_execute(std::chrono::milliseconds timeout) -> void
+auto io_scheduler::process_events_execute(std::chrono::nanoseconds timeout) -> void
 {
     // Clear the recent events without decreasing the allocated capacity to reduce allocations
     m_recent_events.clear();
+    auto wait_start = clock::now();
     m_io_notifier.next_events(m_recent_events, timeout);
+    auto wait_stop = clock::now();
+
+    stats_add(m_stats_loop_iterations, 1);
+    stats_add(
+        m_stats_time_blocked, std::chrono::duration_cast<std::chrono::nanoseconds>(wait_stop - wait_start).count());
+    stats_add(m_stats_events, m_recent_events.size());
+    stats_max(m_stats_max_events_per_iteration, m_recent_events.size());
 
     for (auto& [handle_ptr, poll_status] : m_recent_events)
     {
@@ -262,6 +335,13 @@ auto io_scheduler::process_events_execute(std::chrono::milliseconds timeout) ->
             // Process scheduled coroutines.
             process_scheduled_execute_inline();
         }
+#if defined(CORO_PLATFORM_UNIX)
+        else if (handle_ptr == m_cancel_ptr)
+        {
+            // Process polls that have had a stop requested.
+            process_cancelled_execute();
+        }
+#endif
         else if (handle_ptr == m_shutdown_ptr) [[unlikely]]
         {
             // Nothing to do, just needed to wake-up and smell the flowers
@@ -283,18 +363,23 @@ auto io_scheduler::process_events_execute(std::chrono::milliseconds timeout) ->
     {
         if (m_opts.execution_strategy == execution_strategy_t::process_tasks_inline)
         {
-            for (auto& handle : m_handles_to_resume)
+            stats_add(m_stats_resumed_inline, m_handles_to_resume.size());
+            for (auto& [handle, worker] : m_handles_to_resume)
             {
                 handle.resume();
             }
         }
         else
         {
+            stats_add(m_stats_resumed_offloaded, m_handles_to_resume.size());
             m_thread_pool->resume(m_handles_to_resume);
         }
 
         m_handles_to_resume.clear();
     }
+
+    stats_add(
+        m_stats_time_processing, std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - wait_stop).count());
 }
 
 auto io_scheduler::process_scheduled_execute_inline() -> void
@@ -313,6 +398,7 @@ auto io_scheduler::process_scheduled_execute_inline() -> void
     }
 
     // This set of handles can be safely resumed now since they do not have a corresponding timeout event.
+    stats_add(m_stats_resumed_inline, tasks.size());
     for (auto& task : tasks)
     {
         task.resume();
@@ -329,6 +415,12 @@ auto io_scheduler::process_event_execute(detail::poll_info* pi, poll_status stat
         // is ever processed, the other is discarded.
         pi->m_processed = true;
 
+        // Wait for the poll to finish registering its event and timeout before removing them.
+        while (pi->m_awaiting_coroutine == nullptr)
+        {
+            std::atomic_thread_fence(std::memory_order::acquire);
+        }
+
 #if defined(CORO_PLATFORM_UNIX)
         // Given a valid fd always remove it from epoll so the next poll can blindly EPOLL_CTL_ADD.
         if (pi->m_fd != -1)
@@ -345,19 +437,56 @@ auto io_scheduler::process_event_execute(detail::poll_info* pi, poll_status stat
 
         pi->m_poll_status = status;
 
-        while (pi->m_awaiting_coroutine == nullptr)
+        queue_resume(*pi);
+    }
+}
+
+#if defined(CORO_PLATFORM_UNIX)
+auto io_scheduler::process_cancelled_execute() -> void
+{
+    // The lock is held while cancelling, a poll that was resumed by its event in the meantime
+    // must acquire it to remove itself from the list before it can be destroyed.
+    std::scoped_lock lk{m_cancelled_polls_mutex};
+    m_cancel_signal.unset();
+
+    for (auto* pi : m_cancelled_polls)
+    {
+        if (!pi->m_processed)
         {
-            std::atomic_thread_fence(std::memory_order::acquire);
-        }
+            // The event or timeout may have already won, otherwise the cancellation does.
+            pi->m_processed = true;
 
-        m_handles_to_resume.emplace_back(pi->m_awaiting_coroutine);
+            // Wait for the poll to finish registering its event and timeout before removing them.
+            while (pi->m_awaiting_coroutine == nullptr)
+            {
+                std::atomic_thread_fence(std::memory_order::acquire);
+            }
+
+            if (pi->m_fd != -1)
+            {
+                m_io_notifier.unwatch(*pi);
+            }
+
+            if (pi->m_timer_pos.has_value())
+            {
+                remove_timer_token(pi->m_timer_pos.value());
+            }
+
+            pi->m_poll_status = poll_status::cancelled;
+            queue_resume(*pi);
+        }
     }
+
+    m_cancelled_polls.clear();
 }
+#endif
 
 auto io_scheduler::process_timeout_execute() -> void
 {
-    std::vector<detail::poll_info*> poll_infos{};
-    auto                            now = clock::now();
+    std::vector<std::pair<time_point, detail::poll_info*>> poll_infos{};
+    auto                                                   now = clock::now();
+    // The timer was armed early by the spin amount, anything due within that window is collected now.
+    auto latest = now;
 
     {
         std::scoped_lock lk{m_timed_events_mutex};
@@ -366,10 +495,16 @@ auto io_scheduler::process_timeout_execute() -> void
             auto first    = m_timed_events.begin();
             auto [tp, pi] = *first;
 
-            if (tp <= now)
+            if (tp <= now + m_opts.timer_spin)
             {
                 m_timed_events.erase(first);
-                poll_infos.emplace_back(pi);
+                if (pi->m_on_timeout != nullptr)
+                {
+                    // Taken by the event loop, cancel_timer_callback() can no longer disarm it.
+                    pi->m_timer_pos = std::nullopt;
+                }
+                poll_infos.emplace_back(tp, pi);
+                latest = std::max(latest, tp);
             }
             else
             {
@@ -378,14 +513,31 @@ auto io_scheduler::process_timeout_execute() -> void
         }
     }
 
-    for (auto pi : poll_infos)
+    // Busy wait the remainder of the spin window so the timeouts resume as close to their deadline as possible.
+    auto fired = clock::now();
+    while (fired < latest)
     {
+        fired = clock::now();
+    }
+
+    for (auto [tp, pi] : poll_infos)
+    {
+        auto lateness = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(fired - tp).count());
+        stats_add(m_stats_timer_lateness, lateness);
+        stats_max(m_stats_max_timer_lateness, lateness);
+
         if (!pi->m_processed)
         {
             // Its possible the event and the timeout occurred in the same epoll, make sure only one
             // is ever processed, the other is discarded.
             pi->m_processed = true;
 
+            // Wait for the poll to finish registering its event before removing it.
+            while (pi->m_awaiting_coroutine == nullptr)
+            {
+                std::atomic_thread_fence(std::memory_order::acquire);
+            }
+
 #if defined(CORO_PLATFORM_UNIX)
             // Since this timed out, remove its corresponding event if it has one.
             if (pi->m_fd != -1)
@@ -394,21 +546,62 @@ auto io_scheduler::process_timeout_execute() -> void
             }
 #endif
 
-            while (pi->m_awaiting_coroutine == nullptr)
+            if (pi->m_on_timeout != nullptr)
             {
-                std::atomic_thread_fence(std::memory_order::acquire);
+                m_size.fetch_sub(1, std::memory_order::release);
+                // The callback may have handed the coroutine elsewhere, the poll info is not touched again.
+                if (!pi->m_on_timeout(*pi))
+                {
+                    continue;
+                }
             }
 
-            m_handles_to_resume.emplace_back(pi->m_awaiting_coroutine);
             pi->m_poll_status = coro::poll_status::timeout;
+            queue_resume(*pi);
         }
     }
 
+    stats_add(m_stats_timers_fired, poll_infos.size());
+
     // Update the time to the next smallest time point, re-take the current now time
     // since updating and resuming tasks could shift the time.
     update_timeout(clock::now());
 }
 
+auto io_scheduler::stats() const -> statistics
+{
+    statistics s{
+        .loop_iterations          = m_stats_loop_iterations.load(std::memory_order::relaxed),
+        .time_blocked             = std::chrono::nanoseconds{m_stats_time_blocked.load(std::memory_order::relaxed)},
+        .time_processing          = std::chrono::nanoseconds{m_stats_time_processing.load(std::memory_order::relaxed)},
+        .events                   = m_stats_events.load(std::memory_order::relaxed),
+        .max_events_per_iteration = m_stats_max_events_per_iteration.load(std::memory_order::relaxed),
+        .timers_fired             = m_stats_timers_fired.load(std::memory_order::relaxed),
+        .timer_lateness           = std::chrono::nanoseconds{m_stats_timer_lateness.load(std::memory_order::relaxed)},
+        .max_timer_lateness = std::chrono::nanoseconds{m_stats_max_timer_lateness.load(std::memory_order::relaxed)},
+        .timed_events       = 0,
+        .resumed_inline     = m_stats_resumed_inline.load(std::memory_order::relaxed),
+        .resumed_offloaded  = m_stats_resumed_offloaded.load(std::memory_order::relaxed),
+        .schedule_queue_depth = 0};
+
+    {
+        std::scoped_lock lk{m_timed_events_mutex};
+        s.timed_events = m_timed_events.size();
+    }
+
+    if (m_opts.execution_strategy == execution_strategy_t::process_tasks_inline)
+    {
+        std::scoped_lock lk{m_scheduled_tasks_mutex};
+        s.schedule_queue_depth = m_scheduled_tasks.size();
+    }
+    else
+    {
+        s.schedule_queue_depth = m_thread_pool->queue_size();
+    }
+
+    return s;
+}
+
 auto io_scheduler::add_timer_token(time_point tp, detail::poll_info& pi) -> timed_events::iterator
 {
     std::scoped_lock lk{m_timed_events_mutex};
@@ -441,13 +634,48 @@ auto io_scheduler::remove_timer_token(timed_events::iterator pos) -> void
     }
 }
 
+auto io_scheduler::add_timer_callback(time_point tp, detail::poll_info& pi) -> void
+{
+    m_size.fetch_add(1, std::memory_order::release);
+
+    std::scoped_lock lk{m_timed_events_mutex};
+    pi.m_timer_pos = m_timed_events.emplace(tp, &pi);
+    if (pi.m_timer_pos.value() == m_timed_events.begin())
+    {
+        update_timeout(clock::now());
+    }
+}
+
+auto io_scheduler::cancel_timer_callback(detail::poll_info& pi) -> bool
+{
+    {
+        std::scoped_lock lk{m_timed_events_mutex};
+        if (!pi.m_timer_pos.has_value())
+        {
+            return false;
+        }
+
+        auto pos      = pi.m_timer_pos.value();
+        auto is_first = (m_timed_events.begin() == pos);
+        m_timed_events.erase(pos);
+        pi.m_timer_pos = std::nullopt;
+        if (is_first)
+        {
+            update_timeout(clock::now());
+        }
+    }
+
+    m_size.fetch_sub(1, std::memory_order::release);
+    return true;
+}
+
 auto io_scheduler::update_timeout(time_point now) -> void
 {
     if (!m_timed_events.empty())
     {
         auto& [tp, pi] = *m_timed_events.begin();
 
-        auto amount = tp - now;
+        auto amount = tp - now - m_opts.timer_spin;
 
         if (!m_io_notifier.watch_timer(m_timer, amount))
         {
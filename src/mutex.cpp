@@ -12,10 +12,21 @@ auto lock_operation_base::await_ready() const noexcept -> bool
 
 auto lock_operation_base::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> bool
 {
-    m_awaiting_coroutine = awaiting_coroutine;
     auto& state = m_mutex.m_state;
-    void* current = state.load(std::memory_order::acquire);
     const void* unlocked_value = m_mutex.unlocked_value();
+
+    // Waiters are handed the lock directly by unlock() so the mutex only reads as unlocked when nobody is queued,
+    // spinning can never overtake a waiter.
+    for (std::size_t i = 0; i < m_mutex.m_spin_count; ++i)
+    {
+        if (state.load(std::memory_order::relaxed) == unlocked_value && m_mutex.try_lock())
+        {
+            return false;
+        }
+    }
+
+    m_awaiting_coroutine = awaiting_coroutine;
+    void* current = state.load(std::memory_order::acquire);
     do
     {
         // While trying to suspend the lock can become available, if so attempt to grab it and then don't suspend.
@@ -106,6 +117,10 @@ auto mutex::unlock() -> void
             // assert waiter != nullptr, nobody else should be unlocking this mutex.
             // Directly transfer control to the waiter, they are now responsible for unlocking the mutex.
             std::atomic_thread_fence(std::memory_order::acq_rel);
+            if (m_resume_on_executor != nullptr && m_resume_on_executor(m_executor.get(), waiter->m_awaiting_coroutine))
+            {
+                return;
+            }
             waiter->m_awaiting_coroutine.resume();
             return;
         }
@@ -8,6 +8,7 @@ const static std::string connect_status_connected{"connected"};
 const static std::string connect_status_invalid_ip_address{"invalid_ip_address"};
 const static std::string connect_status_timeout{"timeout"};
 const static std::string connect_status_error{"error"};
+const static std::string connect_status_cancelled{"cancelled"};
 
 auto to_string(const connect_status& status) -> const std::string&
 {
@@ -21,6 +22,8 @@ auto to_string(const connect_status& status) -> const std::string&
             return connect_status_timeout;
         case connect_status::error:
             return connect_status_error;
+        case connect_status::cancelled:
+            return connect_status_cancelled;
     }
 
     throw std::logic_error{"Invalid/unknown connect status."};
@@ -10,6 +10,13 @@
 // clang-format on
 #endif
 
+#if defined(CORO_PLATFORM_LINUX)
+    #include <algorithm>
+    #include <fcntl.h>
+    #include <sys/sendfile.h>
+    #include <unistd.h>
+#endif
+
 namespace coro::net::tcp
 {
 using namespace std::chrono_literals;
@@ -95,7 +102,7 @@ auto client::operator=(const client& other) noexcept -> client&
 }
 #endif
 
-auto client::connect(std::chrono::milliseconds timeout) -> coro::task<connect_status>
+auto client::connect(std::chrono::nanoseconds timeout, std::stop_token stop_token) -> coro::task<connect_status>
 {
     // Only allow the user to connect per tcp client once, if they need to re-connect they should
     // make a new tcp::client.
@@ -127,7 +134,7 @@ auto client::connect(std::chrono::milliseconds timeout) -> coro::task<connect_st
         // when the connection is established.
         if (errno == EAGAIN || errno == EINPROGRESS)
         {
-            auto pstatus = co_await m_io_scheduler->poll(m_socket, poll_op::write, timeout);
+            auto pstatus = co_await m_io_scheduler->poll(m_socket, poll_op::write, timeout, std::move(stop_token));
             if (pstatus == poll_status::event)
             {
                 int       result{0};
@@ -146,6 +153,10 @@ auto client::connect(std::chrono::milliseconds timeout) -> coro::task<connect_st
             {
                 co_return return_value(connect_status::timeout);
             }
+            else if (pstatus == poll_status::cancelled)
+            {
+                co_return return_value(connect_status::cancelled);
+            }
         }
     }
 
@@ -241,14 +252,156 @@ auto client::connect(std::chrono::milliseconds timeout) -> coro::task<connect_st
 #endif
 }
 
-#if defined(CORO_PLATFORM_UNIX)
-auto client::poll(coro::poll_op op, std::chrono::milliseconds timeout) -> coro::task<poll_status>
+#if defined(CORO_PLATFORM_LINUX)
+
+static auto poll_status_to_write_status(poll_status status) -> write_status
 {
-    return m_io_scheduler->poll(m_socket, op, timeout);
+    switch (status)
+    {
+        case poll_status::event:
+            return write_status::ok;
+        case poll_status::timeout:
+            return write_status::timeout;
+        case poll_status::closed:
+            return write_status::closed;
+        case poll_status::cancelled:
+            return write_status::cancelled;
+        case poll_status::error:
+        default:
+            return write_status::error;
+    }
 }
-#elif defined(CORO_PLATFORM_WINDOWS)
 
-auto client::write(std::span<const char> buffer, std::chrono::milliseconds timeout)
+static auto errno_to_write_status(int err) -> write_status
+{
+    return (err == EPIPE || err == ECONNRESET) ? write_status::closed : write_status::error;
+}
+
+auto client::send_file(
+    fd_t fd, uint64_t offset, std::size_t length, std::chrono::nanoseconds timeout, std::stop_token stop_token)
+    -> coro::task<std::pair<write_status, std::size_t>>
+{
+    std::size_t sent{0};
+    auto        file_offset = static_cast<off_t>(offset);
+
+    // Optimistically send first, the socket only needs to be polled once its send buffer is full.
+    while (sent < length)
+    {
+        auto n = ::sendfile(m_socket.native_handle(), fd, &file_offset, length - sent);
+        if (n > 0)
+        {
+            sent += static_cast<std::size_t>(n);
+        }
+        else if (n == 0)
+        {
+            // The file ended before the requested length.
+            break;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            auto pstatus = co_await poll(poll_op::write, timeout, stop_token);
+            if (pstatus != poll_status::event)
+            {
+                co_return {poll_status_to_write_status(pstatus), sent};
+            }
+        }
+        else if (errno != EINTR)
+        {
+            co_return {errno_to_write_status(errno), sent};
+        }
+    }
+
+    co_return {write_status::ok, sent};
+}
+
+auto client::splice_to(
+    client& destination, std::size_t length, std::chrono::nanoseconds timeout, std::stop_token stop_token)
+    -> coro::task<std::pair<write_status, std::size_t>>
+{
+    // splice() requires one end of each transfer to be a pipe, the bytes move socket -> pipe -> socket
+    // entirely within the kernel.
+    int pipe_fds[2];
+    if (::pipe2(pipe_fds, O_NONBLOCK | O_CLOEXEC) == -1)
+    {
+        co_return {write_status::error, 0};
+    }
+
+    auto        status = write_status::ok;
+    std::size_t moved{0};
+    std::size_t in_pipe{0};
+    const auto  flags = SPLICE_F_MOVE | SPLICE_F_NONBLOCK;
+    // The kernel rejects lengths that do not fit in a ssize_t, the pipe's capacity limits each splice anyway.
+    constexpr std::size_t max_chunk = std::size_t{1} << 20;
+
+    while (moved < length)
+    {
+        if (in_pipe == 0)
+        {
+            auto n = ::splice(
+                m_socket.native_handle(), nullptr, pipe_fds[1], nullptr, std::min(length - moved, max_chunk), flags);
+            if (n > 0)
+            {
+                in_pipe = static_cast<std::size_t>(n);
+            }
+            else if (n == 0)
+            {
+                // This client's peer has closed the connection.
+                status = write_status::closed;
+                break;
+            }
+            else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                auto pstatus = co_await poll(poll_op::read, timeout, stop_token);
+                if (pstatus != poll_status::event)
+                {
+                    status = poll_status_to_write_status(pstatus);
+                    break;
+                }
+                continue;
+            }
+            else if (errno == EINTR)
+            {
+                continue;
+            }
+            else
+            {
+                status = errno_to_write_status(errno);
+                break;
+            }
+        }
+
+        auto n = ::splice(pipe_fds[0], nullptr, destination.m_socket.native_handle(), nullptr, in_pipe, flags);
+        if (n > 0)
+        {
+            in_pipe -= static_cast<std::size_t>(n);
+            moved += static_cast<std::size_t>(n);
+        }
+        else if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            auto pstatus = co_await destination.poll(poll_op::write, timeout, stop_token);
+            if (pstatus != poll_status::event)
+            {
+                status = poll_status_to_write_status(pstatus);
+                break;
+            }
+        }
+        else if (n == -1 && errno != EINTR)
+        {
+            status = errno_to_write_status(errno);
+            break;
+        }
+    }
+
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+    co_return {status, moved};
+}
+
+#endif
+
+#if defined(CORO_PLATFORM_WINDOWS)
+
+auto client::write(std::span<const char> buffer, std::chrono::nanoseconds timeout, std::stop_token /*stop_token*/)
     -> task<std::pair<write_status, std::span<const char>>>
 {
     static constexpr auto send_fn = [](SOCKET s, detail::overlapped_io_operation& ov, WSABUF& buf)
@@ -258,7 +411,7 @@ auto client::write(std::span<const char> buffer, std::chrono::milliseconds timeo
         m_io_scheduler, reinterpret_cast<SOCKET>(m_socket.native_handle()), send_fn, buffer, timeout);
 }
 
-auto client::read(std::span<char> buffer, std::chrono::milliseconds timeout)
+auto client::read(std::span<char> buffer, std::chrono::nanoseconds timeout, std::stop_token /*stop_token*/)
     -> task<std::pair<read_status, std::span<char>>>
 {
     static constexpr auto recv_fn = [](SOCKET s, detail::overlapped_io_operation& ov, WSABUF& buf)
@@ -79,21 +79,21 @@ auto server::accept() const -> coro::net::tcp::client
         }};
 };
 
-auto server::accept_client(const std::chrono::milliseconds timeout) -> coro::task<std::optional<coro::net::tcp::client>>
+auto server::accept_client(const std::chrono::nanoseconds timeout, std::stop_token stop_token)
+    -> coro::task<std::optional<coro::net::tcp::client>>
 {
-    switch (co_await poll(timeout))
+    // Not a switch on the co_await expression, gcc 12 miscompiles that form and never starts the coroutine body.
+    auto status = co_await poll(timeout, std::move(stop_token));
+    if (status != poll_status::event)
     {
-        case poll_status::event:
-            break; // ignoring
-        case poll_status::closed:
-        case poll_status::error:
-        case poll_status::timeout:
-            co_return std::nullopt;
+        // closed, error, timeout or cancelled.
+        co_return std::nullopt;
     }
     co_return accept();
 }
 #elif defined(CORO_PLATFORM_WINDOWS)
-auto server::accept_client(const std::chrono::milliseconds timeout) -> coro::task<std::optional<coro::net::tcp::client>>
+auto server::accept_client(const std::chrono::nanoseconds timeout, std::stop_token /*stop_token*/)
+    -> coro::task<std::optional<coro::net::tcp::client>>
 {
     static LPFN_ACCEPTEX  accept_ex_function;
     static std::once_flag accept_ex_function_created;
@@ -38,7 +38,7 @@ peer::peer(std::shared_ptr<io_scheduler> scheduler, const info& bind_info)
 }
 
 #if defined(CORO_PLATFORM_WINDOWS)
-auto peer::write_to(const info& peer_info, std::span<const char> buffer, std::chrono::milliseconds timeout)
+auto peer::write_to(const info& peer_info, std::span<const char> buffer, std::chrono::nanoseconds timeout)
     -> coro::task<std::pair<write_status, std::span<const char>>>
 {
     if (buffer.empty())
@@ -101,7 +101,7 @@ auto peer::write_to(const info& peer_info, std::span<const char> buffer, std::ch
 
     co_return {write_status::error, buffer};
 }
-auto peer::read_from(std::span<char> buffer, std::chrono::milliseconds timeout)
+auto peer::read_from(std::span<char> buffer, std::chrono::nanoseconds timeout)
     -> coro::task<std::tuple<read_status, peer::info, std::span<char>>>
 {
     if (!m_bound)
@@ -0,0 +1,94 @@
+#include "coro/periodic_timer.hpp"
+#include "coro/io_scheduler.hpp"
+
+#include <stdexcept>
+
+namespace coro
+{
+periodic_timer::periodic_timer(
+    std::shared_ptr<io_scheduler> scheduler, std::chrono::nanoseconds period, missed_tick_policy policy)
+    : m_scheduler(std::move(scheduler)),
+      m_period(period),
+      m_policy(policy),
+      m_next(clock::now() + period)
+{
+    if (m_scheduler == nullptr)
+    {
+        throw std::runtime_error{"periodic_timer cannot have a nullptr scheduler"};
+    }
+
+    if (m_period <= std::chrono::nanoseconds{0})
+    {
+        throw std::runtime_error{"periodic_timer period must be greater than zero"};
+    }
+}
+
+auto periodic_timer::reset() noexcept -> void
+{
+    m_next = clock::now() + m_period;
+}
+
+auto periodic_timer::tick_operation::await_ready() noexcept -> bool
+{
+    auto now = clock::now();
+    if (now < m_timer.m_next)
+    {
+        return false;
+    }
+
+    // The deadline has already passed, deliver this tick now.  The number of whole periods elapsed
+    // past the deadline are the ticks that were missed entirely.
+    auto missed = static_cast<uint64_t>((now - m_timer.m_next) / m_timer.m_period);
+    switch (m_timer.m_policy)
+    {
+        case missed_tick_policy::burst:
+            m_timer.m_next += m_timer.m_period;
+            m_ready_ticks = 1;
+            break;
+        case missed_tick_policy::skip:
+            m_timer.m_next += m_timer.m_period * (missed + 1);
+            m_ready_ticks = 1;
+            break;
+        case missed_tick_policy::coalesce:
+            m_timer.m_next += m_timer.m_period * (missed + 1);
+            m_ready_ticks = missed + 1;
+            break;
+    }
+
+    return true;
+}
+
+auto periodic_timer::tick_operation::await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> void
+{
+    auto& scheduler = *m_timer.m_scheduler;
+    auto& pi        = m_timer.m_pi;
+
+    // The previous tick's resumption synchronized with the event loop, the node is no longer
+    // referenced by the scheduler and can be re-armed.
+    pi.m_processed          = false;
+    pi.m_awaiting_coroutine = nullptr;
+    pi.m_poll_status        = poll_status::error;
+
+    scheduler.m_size.fetch_add(1, std::memory_order::release);
+    scheduler.add_timer_token(m_timer.m_next, pi);
+
+    pi.record_worker();
+    pi.m_awaiting_coroutine = awaiting_coroutine;
+    std::atomic_thread_fence(std::memory_order::release);
+}
+
+auto periodic_timer::tick_operation::await_resume() noexcept -> uint64_t
+{
+    if (m_ready_ticks > 0)
+    {
+        return m_ready_ticks;
+    }
+
+    // Resumed by the event loop at the deadline, advance from the deadline itself and not from
+    // 'now' so the schedule never drifts.
+    m_timer.m_scheduler->m_size.fetch_sub(1, std::memory_order::release);
+    m_timer.m_next += m_timer.m_period;
+    return 1;
+}
+
+} // namespace coro
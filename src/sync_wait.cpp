@@ -1,31 +1,104 @@
 #include "coro/sync_wait.hpp"
 
+#include <utility>
+
 namespace coro::detail
 {
-sync_wait_event::sync_wait_event(bool initially_set) : m_set(initially_set)
+namespace
+{
+/// The buffer the next sync_wait wrapper frame on this thread is placed in, consumed by its allocation.
+thread_local sync_wait_frame_buffer* t_frame_buffer{nullptr};
+
+/// The buffer the frame was placed in, nullptr for a pooled frame, is stored right after the frame.
+constexpr auto buffer_offset(std::size_t size) noexcept -> std::size_t
+{
+    return (size + alignof(sync_wait_frame_buffer*) - 1) & ~(alignof(sync_wait_frame_buffer*) - 1);
+}
+} // namespace
+
+auto sync_wait_task_promise_base::frame_buffer(sync_wait_frame_buffer& buffer) noexcept -> void
+{
+    t_frame_buffer = &buffer;
+}
+
+auto sync_wait_task_promise_base::operator new(std::size_t size) -> void*
+{
+    auto  total  = buffer_offset(size) + sizeof(sync_wait_frame_buffer*);
+    auto* buffer = std::exchange(t_frame_buffer, nullptr);
+
+    std::byte* frame{nullptr};
+    if (buffer != nullptr && total <= sync_wait_frame_buffer::size)
+    {
+        frame = buffer->m_bytes;
+    }
+    else
+    {
+        buffer = nullptr;
+        frame  = static_cast<std::byte*>(pooled_frame::operator new(total));
+    }
+
+    *reinterpret_cast<sync_wait_frame_buffer**>(frame + buffer_offset(size)) = buffer;
+    return frame;
+}
+
+auto sync_wait_task_promise_base::operator delete(void* ptr, std::size_t size) noexcept -> void
+{
+    auto  total  = buffer_offset(size) + sizeof(sync_wait_frame_buffer*);
+    auto* buffer = *reinterpret_cast<sync_wait_frame_buffer**>(static_cast<std::byte*>(ptr) + buffer_offset(size));
+    if (buffer == nullptr)
+    {
+        pooled_frame::operator delete(ptr, total);
+    }
+}
+
+sync_wait_event::sync_wait_event(bool initially_set) : m_state(initially_set ? state::set : state::unset)
 {
 }
 
 auto sync_wait_event::set() noexcept -> void
 {
-    // issue-270 100~ task's on a thread_pool within sync_wait(when_all(tasks)) can cause a deadlock/hang if using
-    // release/acquire or even seq_cst.
+    // issue-270 the waiter only sleeps after publishing state::waiting, so it is only woken when it has actually
+    // gone to sleep.  The exchange and the futex compare are both on m_state, a set can never slip in between the
+    // waiter's check and its sleep.
+    //
+    // The waiter can observe state::set and return, destroying this event, before notify_all() runs.  The futex
+    // wake only uses the address to find sleepers, at worst it spuriously wakes an unrelated waiter which rechecks
+    // its own state.
+    if (m_state.exchange(state::set, std::memory_order::acq_rel) == state::waiting)
     {
-        std::unique_lock<std::mutex> lk{m_mutex};
-        m_set.exchange(true, std::memory_order::seq_cst);
-        m_cv.notify_all();
+        m_state.notify_all();
     }
 }
 
 auto sync_wait_event::reset() noexcept -> void
 {
-    m_set.exchange(false, std::memory_order::seq_cst);
+    m_state.store(state::unset, std::memory_order::release);
 }
 
 auto sync_wait_event::wait() noexcept -> void
 {
-    std::unique_lock<std::mutex> lk{m_mutex};
-    m_cv.wait(lk, [this] { return m_set.load(std::memory_order::seq_cst); });
+    // Most awaitables driven by sync_wait complete within a few microseconds, spin briefly before paying for the
+    // futex syscalls on both sides.
+    for (std::size_t i = 0; i < spin_count; ++i)
+    {
+        if (m_state.load(std::memory_order::acquire) == state::set)
+        {
+            return;
+        }
+    }
+
+    auto expected = state::unset;
+    if (!m_state.compare_exchange_strong(
+            expected, state::waiting, std::memory_order::acq_rel, std::memory_order::acquire) &&
+        expected == state::set)
+    {
+        return;
+    }
+
+    while (m_state.load(std::memory_order::acquire) != state::set)
+    {
+        m_state.wait(state::waiting, std::memory_order::acquire);
+    }
 }
 
 } // namespace coro::detail
@@ -0,0 +1,40 @@
+#include "coro/task_local.hpp"
+
+namespace coro::detail
+{
+auto task_local_storage::next_slot() noexcept -> std::size_t
+{
+    static std::atomic<std::size_t> s_next_slot{0};
+    return s_next_slot.fetch_add(1, std::memory_order::relaxed);
+}
+
+auto task_local_storage::with(const task_local_storage* storage, std::size_t slot, std::shared_ptr<const void> value)
+    -> const task_local_storage*
+{
+    auto* copy = new task_local_storage{};
+    if (storage != nullptr)
+    {
+        copy->m_values = storage->m_values;
+    }
+    if (copy->m_values.size() <= slot)
+    {
+        copy->m_values.resize(slot + 1);
+    }
+    copy->m_values[slot] = std::move(value);
+    return copy;
+}
+
+auto retain_task_locals(const task_local_storage* storage) noexcept -> void
+{
+    storage->m_references.fetch_add(1, std::memory_order::relaxed);
+}
+
+auto release_task_locals(const task_local_storage* storage) noexcept -> void
+{
+    if (storage->m_references.fetch_sub(1, std::memory_order::acq_rel) == 1)
+    {
+        delete storage;
+    }
+}
+
+} // namespace coro::detail
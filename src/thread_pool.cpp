@@ -3,6 +3,14 @@
 
 namespace coro
 {
+namespace
+{
+/// The thread pool the calling thread is an executor of.
+thread_local thread_pool* t_current_thread_pool{nullptr};
+/// The calling executor thread's index within its thread pool.
+thread_local std::size_t t_current_worker{thread_pool::no_worker};
+} // namespace
+
 thread_pool::schedule_operation::schedule_operation(thread_pool& tp) noexcept : m_thread_pool(tp)
 {
 
@@ -16,6 +24,12 @@ auto thread_pool::schedule_operation::await_suspend(std::coroutine_handle<> awai
 thread_pool::thread_pool(options&& opts, private_constructor) : m_opts(opts)
 {
     m_threads.reserve(m_opts.thread_count);
+    m_workers.reserve(m_opts.thread_count);
+    m_idle_workers.reserve(m_opts.thread_count);
+    for (uint32_t i = 0; i < m_opts.thread_count; ++i)
+    {
+        m_workers.emplace_back(std::make_unique<worker>());
+    }
 }
 
 auto thread_pool::make_shared(options opts) -> std::shared_ptr<thread_pool>
@@ -77,6 +91,35 @@ auto thread_pool::resume(std::coroutine_handle<> handle) noexcept -> bool
     return true;
 }
 
+auto thread_pool::resume(std::coroutine_handle<> handle, std::size_t worker) noexcept -> bool
+{
+    if (handle == nullptr || handle.done())
+    {
+        return false;
+    }
+
+    m_size.fetch_add(1, std::memory_order::release);
+    if (m_shutdown_requested.load(std::memory_order::acquire))
+    {
+        m_size.fetch_sub(1, std::memory_order::release);
+        return false;
+    }
+
+    std::scoped_lock lk{m_wait_mutex};
+    enqueue_locked(handle, worker);
+    return true;
+}
+
+auto thread_pool::current() noexcept -> thread_pool*
+{
+    return t_current_thread_pool;
+}
+
+auto thread_pool::current_worker() noexcept -> std::size_t
+{
+    return t_current_worker;
+}
+
 auto thread_pool::shutdown() noexcept -> void
 {
     // Only allow shutdown to occur once.
@@ -86,7 +129,10 @@ auto thread_pool::shutdown() noexcept -> void
             // There is a race condition if we are not holding the lock with the executors
             // to always receive this.  std::jthread stop token works without this properly.
             std::unique_lock<std::mutex> lk{m_wait_mutex};
-            m_wait_cv.notify_all();
+            for (auto& w : m_workers)
+            {
+                w->m_wait_cv.notify_all();
+            }
         }
 
         for (auto& thread : m_threads)
@@ -101,44 +147,44 @@ auto thread_pool::shutdown() noexcept -> void
 
 auto thread_pool::executor(std::size_t idx) -> void
 {
+    t_current_thread_pool = this;
+    t_current_worker      = idx;
+
     if (m_opts.on_thread_start_functor != nullptr)
     {
         m_opts.on_thread_start_functor(idx);
     }
 
-    // Process until shutdown is requested.
-    while (!m_shutdown_requested.load(std::memory_order::acquire))
+    auto& self = *m_workers[idx];
+
+    // Process until shutdown is requested and there are no ready tasks left.
+    while (true)
     {
         std::unique_lock<std::mutex> lk{m_wait_mutex};
-        m_wait_cv.wait(lk, [&]() { return !m_queue.empty() || m_shutdown_requested.load(std::memory_order::acquire); });
-
-        if (m_queue.empty())
+        self.m_running = false;
+        auto handle    = dequeue_locked(idx);
+        while (handle == nullptr && !m_shutdown_requested.load(std::memory_order::acquire))
         {
-            continue;
-        }
+            self.m_idle = true;
+            m_idle_workers.emplace_back(idx);
+            self.m_wait_cv.wait(lk);
 
-        auto handle = m_queue.front();
-        m_queue.pop_front();
-        lk.unlock();
+            // Whoever woke this executor already removed it from the idle list, otherwise this was a
+            // spurious wakeup or shutdown.
+            if (self.m_idle)
+            {
+                self.m_idle = false;
+                std::erase(m_idle_workers, idx);
+            }
 
-        // Release the lock while executing the coroutine.
-        handle.resume();
-        m_size.fetch_sub(1, std::memory_order::release);
-    }
+            handle = dequeue_locked(idx);
+        }
 
-    // Process until there are no ready tasks left.
-    while (m_size.load(std::memory_order::acquire) > 0)
-    {
-        std::unique_lock<std::mutex> lk{m_wait_mutex};
-        // m_size will only drop to zero once all executing coroutines are finished
-        // but the queue could be empty for threads that finished early.
-        if (m_queue.empty())
+        if (handle == nullptr)
         {
             break;
         }
-
-        auto handle = m_queue.front();
-        m_queue.pop_front();
+        self.m_running = true;
         lk.unlock();
 
         // Release the lock while executing the coroutine.
@@ -150,6 +196,9 @@ auto thread_pool::executor(std::size_t idx) -> void
     {
         m_opts.on_thread_stop_functor(idx);
     }
+
+    t_current_thread_pool = nullptr;
+    t_current_worker      = no_worker;
 }
 
 auto thread_pool::schedule_impl(std::coroutine_handle<> handle) noexcept -> void
@@ -161,8 +210,89 @@ auto thread_pool::schedule_impl(std::coroutine_handle<> handle) noexcept -> void
 
     {
         std::scoped_lock lk{m_wait_mutex};
+        enqueue_locked(handle, no_worker);
+    }
+}
+
+auto thread_pool::enqueue_locked(std::coroutine_handle<> handle, std::size_t worker) noexcept -> void
+{
+    m_queue_size.fetch_add(1, std::memory_order::release);
+    if (worker < m_workers.size() && m_workers[worker]->m_queue.size() < m_opts.max_local_queue_size)
+    {
+        auto& w = *m_workers[worker];
+        w.m_queue.emplace_back(handle);
+
+        if (w.m_idle)
+        {
+            w.m_idle = false;
+            std::erase(m_idle_workers, worker);
+            w.m_wait_cv.notify_one();
+        }
+        else if (w.m_running || w.m_queue.size() > 1)
+        {
+            // The preferred executor is busy, it could be running something long or even blocked waiting on
+            // this coroutine, let an idle executor steal.
+            wake_idle_worker_locked();
+        }
+    }
+    else
+    {
         m_queue.emplace_back(handle);
-        m_wait_cv.notify_one();
+        wake_idle_worker_locked();
+    }
+}
+
+auto thread_pool::dequeue_locked(std::size_t idx) noexcept -> std::coroutine_handle<>
+{
+    std::coroutine_handle<> handle{nullptr};
+
+    auto& local = m_workers[idx]->m_queue;
+    if (!local.empty())
+    {
+        handle = local.front();
+        local.pop_front();
+    }
+    else if (!m_queue.empty())
+    {
+        handle = m_queue.front();
+        m_queue.pop_front();
+    }
+    else
+    {
+        // Steal the most recently queued task from another executor's backlog, the oldest tasks are left
+        // for the owner that is most likely about to get to them.  The next task of an executor that is
+        // between tasks is never stolen, otherwise the thread that just resumed a coroutine onto it would
+        // take it straight back.  An executor that is running a coroutine may not get to its queue for a
+        // long time, anything queued on it can be stolen.
+        for (std::size_t i = 1; i < m_workers.size(); ++i)
+        {
+            auto& victim = *m_workers[(idx + i) % m_workers.size()];
+            if (victim.m_queue.size() > 1 || (victim.m_running && !victim.m_queue.empty()))
+            {
+                handle = victim.m_queue.back();
+                victim.m_queue.pop_back();
+                break;
+            }
+        }
+    }
+
+    if (handle != nullptr)
+    {
+        m_queue_size.fetch_sub(1, std::memory_order::release);
+    }
+    return handle;
+}
+
+auto thread_pool::wake_idle_worker_locked() noexcept -> void
+{
+    if (!m_idle_workers.empty())
+    {
+        auto idx = m_idle_workers.back();
+        m_idle_workers.pop_back();
+
+        auto& w  = *m_workers[idx];
+        w.m_idle = false;
+        w.m_wait_cv.notify_one();
     }
 }
 
@@ -3,11 +3,22 @@
 
 #include <coro/coro.hpp>
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#if defined(LIBCORO_TEST_STD_EXECUTION)
+    #include <execution>
+#endif
 
 TEST_CASE("bench", "[bench]")
 {
@@ -84,6 +95,54 @@ TEST_CASE("benchmark counter func coro::sync_wait(awaitable)", "[benchmark]")
     REQUIRE(counter == iterations);
 }
 
+TEST_CASE("benchmark counter task awaiting task vs eager_task", "[benchmark]")
+{
+    constexpr std::size_t iterations = default_iterations;
+    // Without optimizations symmetric transfer is not a tail call, keep the chain of resumptions short.
+    constexpr std::size_t batch = 1'000;
+
+    auto lazy  = []() -> coro::task<uint64_t> { co_return 1; };
+    auto eager = []() -> coro::eager_task<uint64_t> { co_return 1; };
+
+    auto make_lazy_batch = [&]() -> coro::task<uint64_t>
+    {
+        uint64_t counter{0};
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            counter += co_await lazy();
+        }
+        co_return counter;
+    };
+
+    auto make_eager_batch = [&]() -> coro::task<uint64_t>
+    {
+        uint64_t counter{0};
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            counter += co_await eager();
+        }
+        co_return counter;
+    };
+
+    uint64_t counter{0};
+    auto     start = sc::now();
+    for (std::size_t i = 0; i < iterations / batch; ++i)
+    {
+        counter += coro::sync_wait(make_lazy_batch());
+    }
+    print_stats("benchmark counter task awaiting task", iterations, start, sc::now());
+    REQUIRE(counter == iterations);
+
+    counter = 0;
+    start   = sc::now();
+    for (std::size_t i = 0; i < iterations / batch; ++i)
+    {
+        counter += coro::sync_wait(make_eager_batch());
+    }
+    print_stats("benchmark counter task awaiting eager_task", iterations, start, sc::now());
+    REQUIRE(counter == iterations);
+}
+
 TEST_CASE("benchmark counter func coro::sync_wait(coro::when_all(awaitable)) x10", "[benchmark]")
 {
     constexpr std::size_t iterations = default_iterations;
@@ -132,6 +191,263 @@ TEST_CASE("benchmark counter func coro::sync_wait(coro::when_all(vector<awaitabl
     REQUIRE(counter == iterations);
 }
 
+TEST_CASE("benchmark parallel_for vs std::execution::par", "[benchmark]")
+{
+    constexpr std::size_t elements = default_iterations;
+    auto                  tp       = coro::thread_pool::make_shared();
+    auto                  f        = [](double& v) { v = std::sqrt(v) * std::log1p(v); };
+
+    std::vector<double> values(elements);
+    std::iota(values.begin(), values.end(), 1.0);
+
+    auto start = sc::now();
+    coro::sync_wait(coro::parallel_for(tp, values, f));
+    print_stats("benchmark coro::parallel_for", elements, start, sc::now());
+
+#if defined(LIBCORO_TEST_STD_EXECUTION)
+    std::iota(values.begin(), values.end(), 1.0);
+    start = sc::now();
+    std::for_each(std::execution::par, values.begin(), values.end(), f);
+    print_stats("benchmark std::for_each(std::execution::par)", elements, start, sc::now());
+#endif
+
+    std::iota(values.begin(), values.end(), 1.0);
+    start = sc::now();
+    std::for_each(values.begin(), values.end(), f);
+    print_stats("benchmark std::for_each", elements, start, sc::now());
+    tp->shutdown();
+}
+
+TEST_CASE("benchmark parallel_transform_reduce vs std::execution::par", "[benchmark]")
+{
+    constexpr std::size_t elements = default_iterations;
+    auto                  tp       = coro::thread_pool::make_shared();
+    auto                  square   = [](uint64_t v) { return v * v; };
+
+    std::vector<uint64_t> values(elements);
+    std::iota(values.begin(), values.end(), 0);
+
+    auto start  = sc::now();
+    auto result = coro::sync_wait(coro::parallel_transform_reduce(tp, values, uint64_t{0}, std::plus<>{}, square));
+    print_stats("benchmark coro::parallel_transform_reduce", elements, start, sc::now());
+
+#if defined(LIBCORO_TEST_STD_EXECUTION)
+    start = sc::now();
+    REQUIRE(
+        std::transform_reduce(std::execution::par, values.begin(), values.end(), uint64_t{0}, std::plus<>{}, square) ==
+        result);
+    print_stats("benchmark std::transform_reduce(std::execution::par)", elements, start, sc::now());
+#endif
+
+    start = sc::now();
+    REQUIRE(std::transform_reduce(values.begin(), values.end(), uint64_t{0}, std::plus<>{}, square) == result);
+    print_stats("benchmark std::transform_reduce", elements, start, sc::now());
+    tp->shutdown();
+}
+
+TEST_CASE("benchmark parallel_sort vs std::execution::par", "[benchmark]")
+{
+    constexpr std::size_t elements = default_iterations;
+    auto                  tp       = coro::thread_pool::make_shared();
+
+    std::mt19937_64       rng{42};
+    std::vector<uint64_t> input(elements);
+    std::ranges::generate(input, rng);
+
+    auto values = input;
+    auto start  = sc::now();
+    coro::sync_wait(coro::parallel_sort(tp, values));
+    print_stats("benchmark coro::parallel_sort", elements, start, sc::now());
+    REQUIRE(std::ranges::is_sorted(values));
+
+#if defined(LIBCORO_TEST_STD_EXECUTION)
+    values = input;
+    start  = sc::now();
+    std::sort(std::execution::par, values.begin(), values.end());
+    print_stats("benchmark std::sort(std::execution::par)", elements, start, sc::now());
+#endif
+
+    values = input;
+    start  = sc::now();
+    std::sort(values.begin(), values.end());
+    print_stats("benchmark std::sort", elements, start, sc::now());
+    tp->shutdown();
+}
+
+TEST_CASE("benchmark mutex contended spin vs suspend and inline vs executor unlock", "[benchmark]")
+{
+    constexpr std::size_t iterations = default_iterations / 10;
+    // Without optimizations symmetric transfer is not a tail call, keep each task's chain of locks short.
+    constexpr std::size_t batch = 1'000;
+
+    auto tp = coro::thread_pool::make_shared(
+        coro::thread_pool::options{.thread_count = std::max(2u, std::thread::hardware_concurrency())});
+
+    auto run = [&](const std::string& name, coro::mutex& m)
+    {
+        uint64_t counter{0};
+
+        auto make_task = [&]() -> coro::task<void>
+        {
+            co_await tp->schedule();
+            for (std::size_t i = 0; i < batch; ++i)
+            {
+                co_await m.lock();
+                ++counter;
+                m.unlock();
+            }
+        };
+
+        std::vector<coro::task<void>> tasks{};
+        tasks.reserve(iterations / batch);
+        for (std::size_t i = 0; i < iterations / batch; ++i)
+        {
+            tasks.emplace_back(make_task());
+        }
+
+        auto start = sc::now();
+        coro::sync_wait(coro::when_all(std::move(tasks)));
+        print_stats(name, iterations, start, sc::now());
+        REQUIRE(counter == iterations);
+    };
+
+    coro::mutex suspend{};
+    run("benchmark mutex contended suspend", suspend);
+    coro::mutex spin{128};
+    run("benchmark mutex contended spin=128", spin);
+    coro::mutex handoff{tp};
+    run("benchmark mutex contended unlock hands off to executor", handoff);
+    coro::mutex spin_handoff{tp, 128};
+    run("benchmark mutex contended spin=128 unlock hands off to executor", spin_handoff);
+
+    tp->shutdown();
+}
+
+TEST_CASE("benchmark shared_mutex read mostly", "[benchmark]")
+{
+    constexpr std::size_t iterations = default_iterations / 10;
+    constexpr std::size_t batch      = 1'000;
+
+    auto tp = coro::thread_pool::make_shared(
+        coro::thread_pool::options{.thread_count = std::max(2u, std::thread::hardware_concurrency())});
+
+    auto run = [&](const std::string& name, coro::shared_mutex_policy policy)
+    {
+        coro::shared_mutex<coro::thread_pool> m{tp, policy};
+        std::atomic<uint64_t>                 reads{0};
+        uint64_t                              writes{0};
+
+        auto make_task = [&]() -> coro::task<void>
+        {
+            co_await tp->schedule();
+            for (std::size_t i = 0; i < batch; ++i)
+            {
+                // One exclusive lock for every hundred shared locks.
+                if (i % 100 == 0)
+                {
+                    auto scoped_lock = co_await m.lock();
+                    ++writes;
+                }
+                else
+                {
+                    auto scoped_lock = co_await m.lock_shared();
+                    reads.fetch_add(1, std::memory_order::relaxed);
+                }
+            }
+        };
+
+        std::vector<coro::task<void>> tasks{};
+        tasks.reserve(iterations / batch);
+        for (std::size_t i = 0; i < iterations / batch; ++i)
+        {
+            tasks.emplace_back(make_task());
+        }
+
+        auto start = sc::now();
+        coro::sync_wait(coro::when_all(std::move(tasks)));
+        print_stats(name, iterations, start, sc::now());
+        REQUIRE(reads + writes == iterations);
+    };
+
+    run("benchmark shared_mutex read mostly prefer_writers", coro::shared_mutex_policy::prefer_writers);
+    run("benchmark shared_mutex read mostly prefer_readers", coro::shared_mutex_policy::prefer_readers);
+
+    tp->shutdown();
+}
+
+TEST_CASE("benchmark condition_variable notify_all 1k waiters", "[benchmark]")
+{
+    constexpr std::size_t waiters = 1'000;
+    constexpr std::size_t rounds  = 100;
+
+    auto tp = coro::thread_pool::make_shared(
+        coro::thread_pool::options{.thread_count = std::max(2u, std::thread::hardware_concurrency())});
+
+    auto run = [&](const std::string& name, bool with_predicate)
+    {
+        coro::condition_variable cv{};
+        coro::mutex              m{};
+        uint64_t                 counter{0};
+        sc::duration             elapsed{0};
+
+        for (std::size_t round = 0; round < rounds; ++round)
+        {
+            coro::latch l{waiters};
+            bool        released{false};
+
+            auto make_waiter = [&]() -> coro::task<void>
+            {
+                co_await tp->schedule();
+                auto lk = co_await m.scoped_lock();
+                l.count_down();
+                if (with_predicate)
+                {
+                    co_await cv.wait(lk, [&]() -> bool { return released; });
+                }
+                else
+                {
+                    co_await cv.wait(lk);
+                }
+                ++counter;
+            };
+
+            sc::time_point start{};
+            auto make_notifier = [&]() -> coro::task<void>
+            {
+                co_await tp->schedule();
+                co_await l;
+                {
+                    auto lk  = co_await m.scoped_lock();
+                    released = true;
+                }
+                start = sc::now();
+                co_await cv.notify_all();
+            };
+
+            std::vector<coro::task<void>> tasks{};
+            tasks.reserve(waiters + 1);
+            for (std::size_t i = 0; i < waiters; ++i)
+            {
+                tasks.emplace_back(make_waiter());
+            }
+            tasks.emplace_back(make_notifier());
+
+            coro::sync_wait(coro::when_all(std::move(tasks)));
+            elapsed += sc::now() - start;
+        }
+
+        // Only the time from notify_all() until the last waiter finishes is counted.
+        print_stats(name, waiters * rounds, sc::time_point{}, sc::time_point{elapsed});
+        REQUIRE(counter == waiters * rounds);
+    };
+
+    // Plain waiters are morphed onto the mutex's waiter list, predicate waiters are notified one at a time.
+    run("benchmark condition_variable notify_all 1k waiters morphed onto the mutex", false);
+    run("benchmark condition_variable notify_all 1k waiters with a predicate", true);
+
+    tp->shutdown();
+}
+
 TEST_CASE("benchmark thread_pool{1} counter task", "[benchmark]")
 {
     constexpr std::size_t iterations = default_iterations;
@@ -312,6 +628,53 @@ TEST_CASE("benchmark counter task scheduler{1} yield_for", "[benchmark]")
     REQUIRE(counter == iterations);
 }
 
+TEST_CASE("benchmark io_scheduler timer lateness", "[benchmark]")
+{
+    constexpr std::size_t iterations = 1'000;
+    static constexpr auto delay      = std::chrono::microseconds{200};
+
+    auto make_task = [](std::shared_ptr<coro::io_scheduler> s, std::vector<std::chrono::nanoseconds>& lateness)
+        -> coro::task<void>
+    {
+        co_await s->schedule();
+        for (std::size_t i = 0; i < iterations; ++i)
+        {
+            auto deadline = sc::now() + delay;
+            co_await s->yield_until(deadline);
+            lateness.emplace_back(sc::now() - deadline);
+        }
+        co_return;
+    };
+
+    for (auto timer_spin : {std::chrono::nanoseconds{0}, std::chrono::nanoseconds{50us}})
+    {
+        auto s = coro::io_scheduler::make_shared(coro::io_scheduler::options{
+            .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline,
+            .timer_spin         = timer_spin});
+
+        std::vector<std::chrono::nanoseconds> lateness{};
+        lateness.reserve(iterations);
+        coro::sync_wait(make_task(s, lateness));
+        std::sort(lateness.begin(), lateness.end());
+
+        std::chrono::nanoseconds total{0};
+        for (const auto& l : lateness)
+        {
+            total += l;
+        }
+
+        std::cout << "benchmark io_scheduler timer lateness timer_spin=" << timer_spin.count() << "ns\n";
+        std::cout << "    avg: " << (total / iterations).count() << "ns\n";
+        std::cout << "    p50: " << lateness[iterations / 2].count() << "ns\n";
+        std::cout << "    p99: " << lateness[(iterations * 99) / 100].count() << "ns\n";
+        std::cout << "    max: " << lateness.back().count() << "ns\n";
+
+        REQUIRE(lateness.front() >= 0ns);
+        s->shutdown();
+        REQUIRE(s->empty());
+    }
+}
+
 TEST_CASE("benchmark counter task scheduler await event from another coroutine", "[benchmark]")
 {
     constexpr std::size_t iterations = default_iterations;
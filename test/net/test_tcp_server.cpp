@@ -4,8 +4,15 @@
 
     #include <coro/coro.hpp>
 
+    #include <filesystem>
+    #include <fstream>
     #include <iostream>
 
+    #if defined(CORO_PLATFORM_LINUX)
+        #include <fcntl.h>
+        #include <unistd.h>
+    #endif
+
 TEST_CASE("tcp_server ping server", "[tcp_server]")
 {
     const std::string client_msg{"Hello from client"};
@@ -162,6 +169,166 @@ TEST_CASE("tcp_server concurrent polling on the same socket", "[tcp_server]")
 
     REQUIRE(request == response);
 }
+
+TEST_CASE("tcp_server accept_client cancelled by stop token", "[tcp_server]")
+{
+    using namespace std::chrono_literals;
+    auto scheduler = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    std::stop_source stop_source{};
+
+    auto make_server_task = [](std::shared_ptr<coro::io_scheduler> scheduler,
+                               std::stop_token st) -> coro::task<std::optional<coro::net::tcp::client>>
+    {
+        co_await scheduler->schedule();
+        coro::net::tcp::server server{scheduler};
+        // No client ever connects, the stop request is the only way out.
+        co_return co_await server.accept_client(0ms, std::move(st));
+    };
+
+    auto make_stop_task = [](std::shared_ptr<coro::io_scheduler> scheduler,
+                             std::stop_source&                   stop_source) -> coro::task<void>
+    {
+        co_await scheduler->schedule();
+        co_await scheduler->yield_for(10ms);
+        stop_source.request_stop();
+        co_return;
+    };
+
+    auto [client, unused] = coro::sync_wait(coro::when_all(
+        make_server_task(scheduler, stop_source.get_token()), make_stop_task(scheduler, stop_source)));
+    REQUIRE_FALSE(client.return_value().has_value());
+}
     #endif // CORO_PLATFORM_UNIX
 
+    #if defined(CORO_PLATFORM_LINUX)
+static auto read_exactly(coro::net::tcp::client& client, std::size_t length) -> coro::task<std::string>
+{
+    std::string received{};
+    std::string buffer(64 * 1024, '\0');
+    while (received.size() < length)
+    {
+        auto [rstatus, rspan] = co_await client.read(buffer);
+        if (rstatus != coro::net::read_status::ok)
+        {
+            break;
+        }
+        received.append(rspan.data(), rspan.size());
+    }
+    co_return received;
+}
+
+TEST_CASE("tcp_server send_file", "[tcp_server]")
+{
+    auto scheduler = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    // Large enough to fill the socket's send buffer so send_file() has to poll for writability.
+    std::string contents(4 * 1024 * 1024, '\0');
+    for (std::size_t i = 0; i < contents.size(); ++i)
+    {
+        contents[i] = static_cast<char>('a' + (i % 26));
+    }
+
+    auto path = std::filesystem::temp_directory_path() / "libcoro_test_send_file.bin";
+    {
+        std::ofstream out{path, std::ios::binary};
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    auto make_test = [](std::shared_ptr<coro::io_scheduler> scheduler,
+                        std::filesystem::path               path,
+                        const std::string&                  contents) -> coro::task<void>
+    {
+        co_await scheduler->schedule();
+        coro::net::tcp::server server{scheduler};
+        coro::net::tcp::client client{scheduler};
+        REQUIRE(co_await client.connect() == coro::net::connect_status::connected);
+        auto accepted = co_await server.accept_client();
+        REQUIRE(accepted);
+
+        auto fd = ::open(path.c_str(), O_RDONLY);
+        REQUIRE(fd != -1);
+
+        const std::size_t offset = 3;
+        const std::size_t length = contents.size() - 10;
+
+        auto make_send_task = [](coro::net::tcp::client& c, int fd, std::size_t offset, std::size_t length)
+            -> coro::task<std::pair<coro::net::write_status, std::size_t>>
+        { co_return co_await c.send_file(fd, offset, length); };
+
+        auto [sent, received] =
+            co_await coro::when_all(make_send_task(*accepted, fd, offset, length), read_exactly(client, length));
+        ::close(fd);
+
+        REQUIRE(sent.return_value().first == coro::net::write_status::ok);
+        REQUIRE(sent.return_value().second == length);
+        REQUIRE(received.return_value() == contents.substr(offset, length));
+        co_return;
+    };
+
+    coro::sync_wait(make_test(scheduler, path, contents));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("tcp_server splice_to", "[tcp_server]")
+{
+    auto scheduler = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    auto make_test = [](std::shared_ptr<coro::io_scheduler> scheduler) -> coro::task<void>
+    {
+        co_await scheduler->schedule();
+        coro::net::tcp::server server{scheduler};
+
+        // Proxy the bytes from 'upstream' to 'downstream' through the two accepted connections.
+        coro::net::tcp::client upstream{scheduler};
+        REQUIRE(co_await upstream.connect() == coro::net::connect_status::connected);
+        auto from = co_await server.accept_client();
+        REQUIRE(from);
+
+        coro::net::tcp::client downstream{scheduler};
+        REQUIRE(co_await downstream.connect() == coro::net::connect_status::connected);
+        auto to = co_await server.accept_client();
+        REQUIRE(to);
+
+        std::string payload(1024 * 1024, '\0');
+        for (std::size_t i = 0; i < payload.size(); ++i)
+        {
+            payload[i] = static_cast<char>(i % 251);
+        }
+
+        auto make_upstream_task = [](coro::net::tcp::client& c, const std::string& payload) -> coro::task<void>
+        {
+            std::span<const char> remaining{payload};
+            while (!remaining.empty())
+            {
+                auto [wstatus, rest] = co_await c.write(remaining);
+                REQUIRE(wstatus == coro::net::write_status::ok);
+                remaining = rest;
+            }
+            // Closing the connection ends the splice.
+            c.socket().shutdown();
+            co_return;
+        };
+
+        auto make_splice_task = [](coro::net::tcp::client& from, coro::net::tcp::client& to)
+            -> coro::task<std::pair<coro::net::write_status, std::size_t>> { co_return co_await from.splice_to(to); };
+
+        auto [unused, spliced, received] = co_await coro::when_all(
+            make_upstream_task(upstream, payload),
+            make_splice_task(*from, *to),
+            read_exactly(downstream, payload.size()));
+
+        REQUIRE(spliced.return_value().first == coro::net::write_status::closed);
+        REQUIRE(spliced.return_value().second == payload.size());
+        REQUIRE(received.return_value() == payload);
+        co_return;
+    };
+
+    coro::sync_wait(make_test(scheduler));
+}
+    #endif // CORO_PLATFORM_LINUX
+
 #endif // LIBCORO_FEATURE_NETWORKING
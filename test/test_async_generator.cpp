@@ -0,0 +1,147 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+TEST_CASE("async_generator", "[async_generator]")
+{
+    std::cerr << "[async_generator]\n\n";
+}
+
+TEST_CASE("async_generator yields values in order", "[async_generator]")
+{
+    auto gen = [](uint64_t max) -> coro::async_generator<uint64_t>
+    {
+        for (uint64_t i = 0; i < max; ++i)
+        {
+            co_yield i;
+        }
+    };
+
+    auto make_task = [&]() -> coro::task<uint64_t>
+    {
+        uint64_t sum{0};
+        auto     g = gen(100);
+        for (auto it = co_await g.begin(); it != g.end(); co_await ++it)
+        {
+            sum += *it;
+        }
+        co_return sum;
+    };
+
+    REQUIRE(coro::sync_wait(make_task()) == 4950);
+}
+
+TEST_CASE("async_generator awaits between yields", "[async_generator]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 2});
+
+    // Pages are 'fetched' on the thread pool between yields.
+    auto pages = [](std::shared_ptr<coro::thread_pool> tp, uint64_t page_count) -> coro::async_generator<std::string>
+    {
+        for (uint64_t page = 0; page < page_count; ++page)
+        {
+            co_await tp->schedule();
+            co_yield "page " + std::to_string(page);
+        }
+    };
+
+    auto make_task = [&]() -> coro::task<std::vector<std::string>>
+    {
+        std::vector<std::string> results{};
+        auto                     g = pages(tp, 5);
+        for (auto it = co_await g.begin(); it != g.end(); co_await ++it)
+        {
+            results.emplace_back(*it);
+        }
+        co_return results;
+    };
+
+    auto results = coro::sync_wait(make_task());
+    REQUIRE(results.size() == 5);
+    REQUIRE(results.front() == "page 0");
+    REQUIRE(results.back() == "page 4");
+    tp->shutdown();
+}
+
+TEST_CASE("async_generator producer only runs when asked", "[async_generator]")
+{
+    uint64_t produced{0};
+
+    auto gen = [](uint64_t& produced) -> coro::async_generator<uint64_t>
+    {
+        while (true)
+        {
+            ++produced;
+            co_yield produced;
+        }
+    };
+
+    auto make_task = [&]() -> coro::task<void>
+    {
+        auto g = gen(produced);
+        REQUIRE(produced == 0);
+
+        auto it = co_await g.begin();
+        REQUIRE(produced == 1);
+        REQUIRE(*it == 1);
+
+        co_await ++it;
+        co_await ++it;
+        REQUIRE(produced == 3);
+        REQUIRE(*it == 3);
+        // Destroying the generator here destroys the suspended infinite producer.
+        co_return;
+    };
+
+    coro::sync_wait(make_task());
+    REQUIRE(produced == 3);
+}
+
+TEST_CASE("async_generator propagates exceptions", "[async_generator]")
+{
+    auto gen = []() -> coro::async_generator<uint64_t>
+    {
+        co_yield 1;
+        throw std::runtime_error{"producer failed"};
+    };
+
+    auto make_task = [&]() -> coro::task<uint64_t>
+    {
+        uint64_t count{0};
+        auto     g = gen();
+        for (auto it = co_await g.begin(); it != g.end(); co_await ++it)
+        {
+            ++count;
+        }
+        co_return count;
+    };
+
+    REQUIRE_THROWS_AS(coro::sync_wait(make_task()), std::runtime_error);
+}
+
+TEST_CASE("async_generator empty", "[async_generator]")
+{
+    auto gen = []() -> coro::async_generator<uint64_t> { co_return; };
+
+    auto make_task = [&]() -> coro::task<uint64_t>
+    {
+        uint64_t count{0};
+        auto     g = gen();
+        for (auto it = co_await g.begin(); it != g.end(); co_await ++it)
+        {
+            ++count;
+        }
+        co_return count;
+    };
+
+    REQUIRE(coro::sync_wait(make_task()) == 0);
+}
+
+TEST_CASE("~async_generator", "[async_generator]")
+{
+    std::cerr << "[~async_generator]\n\n";
+}
@@ -0,0 +1,111 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <iostream>
+#include <sstream>
+
+TEST_CASE("async_stack", "[async_stack]")
+{
+    std::cerr << "[async_stack]\n\n";
+}
+
+TEST_CASE("async_stack annotate completes immediately", "[async_stack]")
+{
+    auto make_task = []() -> coro::task<uint64_t>
+    {
+        co_await coro::this_task::annotate();
+        co_return 42;
+    };
+
+    REQUIRE(coro::sync_wait(make_task()) == 42);
+}
+
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+TEST_CASE("async_stack backtrace of the running task", "[async_stack]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+
+    uint32_t leaf_line{0};
+    uint32_t root_line{0};
+
+    auto make_leaf = [&]() -> coro::task<std::vector<coro::async_stack_entry>>
+    {
+        // The current frame follows the task onto the pool's thread.
+        co_await tp->schedule();
+        leaf_line = std::source_location::current().line() + 1;
+        co_await coro::this_task::annotate();
+        co_return coro::async_stack::backtrace(coro::async_stack::current());
+    };
+
+    auto make_middle = [&]() -> coro::task<std::vector<coro::async_stack_entry>> { co_return co_await make_leaf(); };
+
+    auto make_root = [&]() -> coro::task<std::vector<coro::async_stack_entry>>
+    {
+        root_line = std::source_location::current().line() + 1;
+        co_await coro::this_task::annotate();
+        auto [entries] = co_await coro::when_all(make_middle());
+        co_return entries.return_value();
+    };
+
+    REQUIRE(coro::async_stack::current() == nullptr);
+    auto entries = coro::sync_wait(make_root());
+    REQUIRE(entries.size() == 3);
+    REQUIRE(entries[0].location.line() == leaf_line);
+    REQUIRE(entries[1].location.line() == 0);
+    REQUIRE(entries[2].location.line() == root_line);
+    for (const auto& entry : entries)
+    {
+        REQUIRE(entry.coroutine != nullptr);
+        REQUIRE(entry.resume_address != nullptr);
+    }
+    REQUIRE(coro::async_stack::current() == nullptr);
+    tp->shutdown();
+}
+
+TEST_CASE("async_stack suspended lists every waiting chain", "[async_stack]")
+{
+    coro::event release{};
+
+    auto make_leaf = [&]() -> coro::task<void>
+    {
+        co_await coro::this_task::annotate();
+        co_await release;
+    };
+
+    auto make_root = [&]() -> coro::task<void>
+    {
+        co_await coro::this_task::annotate();
+        co_await make_leaf();
+    };
+
+    auto first  = make_root();
+    auto second = make_root();
+    first.resume();
+    second.resume();
+
+    auto chains = coro::async_stack::suspended();
+    REQUIRE(chains.size() == 2);
+    for (const auto& chain : chains)
+    {
+        REQUIRE(chain.size() == 2);
+        REQUIRE(chain[0].location.line() != 0);
+        REQUIRE(chain[1].location.line() != 0);
+    }
+
+    std::stringstream out{};
+    coro::async_stack::dump(out);
+    REQUIRE(out.str().find("async stack 1:") != std::string::npos);
+    REQUIRE(out.str().find("test_async_stack.cpp") != std::string::npos);
+
+    release.set();
+    REQUIRE(first.is_ready());
+    REQUIRE(second.is_ready());
+    REQUIRE(coro::async_stack::suspended().empty());
+}
+#endif
+
+TEST_CASE("~async_stack", "[async_stack]")
+{
+    std::cerr << "[~async_stack]\n\n";
+}
@@ -301,6 +301,42 @@ TEST_CASE("wait(lock) 3 waiters notify_all", "[condition_variable]")
     REQUIRE(std::get<2>(results).return_value() == 3);
 }
 
+TEST_CASE("wait(lock) notify_all moves the waiters onto the mutex", "[condition_variable]")
+{
+    coro::condition_variable cv{};
+    coro::mutex m{};
+    coro::latch l{3};
+    uint64_t resumed{0};
+
+    auto make_waiter = [](coro::condition_variable& cv, coro::mutex& m, coro::latch& l, uint64_t& resumed) -> coro::task<void>
+    {
+        auto lk = co_await m.scoped_lock();
+        l.count_down();
+        co_await cv.wait(lk);
+        // Each waiter is handed the lock by the previous unlock.
+        REQUIRE_FALSE(m.try_lock());
+        ++resumed;
+    };
+
+    auto make_notifier = [](coro::condition_variable& cv, coro::mutex& m, coro::latch& l, uint64_t& resumed) -> coro::task<void>
+    {
+        co_await l;
+        auto lk = co_await m.scoped_lock();
+        // Notifying with the lock held queues the waiters on the mutex, none of them can run until it is released.
+        co_await cv.notify_all();
+        REQUIRE(resumed == 0);
+        lk.unlock();
+        REQUIRE(resumed == 3);
+    };
+
+    coro::sync_wait(coro::when_all(
+        make_waiter(cv, m, l, resumed),
+        make_waiter(cv, m, l, resumed),
+        make_waiter(cv, m, l, resumed),
+        make_notifier(cv, m, l, resumed)));
+    REQUIRE(resumed == 3);
+}
+
 TEST_CASE("wait(lock predicate) 3 waiters predicate notify_all", "[condition_variable]")
 {
     auto s = coro::io_scheduler::make_shared(coro::io_scheduler::options{
@@ -622,6 +658,103 @@ TEST_CASE("wait_for(s lock duration) 3 with notify_all timeout", "[condition_var
     REQUIRE(std::get<2>(results).return_value() == -3);
 }
 
+TEST_CASE("wait_for(s lock duration) timed out waiters leave the list", "[condition_variable]")
+{
+    auto s = coro::io_scheduler::make_shared(coro::io_scheduler::options{
+            .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline});
+    coro::condition_variable cv{};
+    coro::mutex m{};
+    coro::latch l{8};
+
+    auto make_timed_waiter = [](std::shared_ptr<coro::io_scheduler> s, coro::condition_variable& cv, coro::mutex& m, coro::latch& l) -> coro::task<int64_t>
+    {
+        co_await s->schedule();
+        auto lk = co_await m.scoped_lock();
+        auto status = co_await cv.wait_for(s, lk, std::chrono::milliseconds{10});
+        l.count_down();
+        co_return (status == std::cv_status::timeout) ? 1 : 0;
+    };
+
+    auto make_waiter = [](std::shared_ptr<coro::io_scheduler> s, coro::condition_variable& cv, coro::mutex& m) -> coro::task<int64_t>
+    {
+        co_await s->yield_for(std::chrono::milliseconds{5});
+        auto lk = co_await m.scoped_lock();
+        co_await cv.wait(lk);
+        co_return 100;
+    };
+
+    auto make_notifier = [](std::shared_ptr<coro::io_scheduler> s, coro::condition_variable& cv, coro::latch& l) -> coro::task<int64_t>
+    {
+        co_await s->schedule();
+        co_await l;
+        // The timed waiters ahead of the untimed one have unlinked themselves, a single notify reaches it.
+        co_await cv.notify_one();
+        co_return 0;
+    };
+
+    std::vector<coro::task<int64_t>> tasks{};
+    for (int i = 0; i < 8; ++i)
+    {
+        tasks.emplace_back(make_timed_waiter(s, cv, m, l));
+    }
+    tasks.emplace_back(make_waiter(s, cv, m));
+    tasks.emplace_back(make_notifier(s, cv, l));
+
+    auto results = coro::sync_wait(coro::when_all(std::move(tasks)));
+    int64_t total{0};
+    for (auto& t : results)
+    {
+        total += t.return_value();
+    }
+    REQUIRE(total == 108);
+    REQUIRE(s->stats().timed_events == 0);
+}
+
+TEST_CASE("wait_for(s lock duration) notify racing the timeout", "[condition_variable]")
+{
+    auto s = coro::io_scheduler::make_shared(coro::io_scheduler::options{
+        .pool = coro::thread_pool::options{.thread_count = 4}});
+    coro::condition_variable cv{};
+    coro::mutex m{};
+    std::atomic<uint64_t> resumed{0};
+    std::atomic<uint64_t> resumed_unlocked{0};
+
+    auto make_waiter = [](std::shared_ptr<coro::io_scheduler> s, coro::condition_variable& cv, coro::mutex& m, std::atomic<uint64_t>& resumed, std::atomic<uint64_t>& resumed_unlocked) -> coro::task<void>
+    {
+        co_await s->schedule();
+        auto lk = co_await m.scoped_lock();
+        co_await cv.wait_for(s, lk, std::chrono::microseconds{500});
+        // Either way the waiter wakes up it must hold the lock.
+        if (m.try_lock())
+        {
+            resumed_unlocked++;
+            m.unlock();
+        }
+        resumed++;
+    };
+
+    auto make_notifier = [](std::shared_ptr<coro::io_scheduler> s, coro::condition_variable& cv) -> coro::task<void>
+    {
+        co_await s->schedule();
+        co_await s->yield_for(std::chrono::microseconds{500});
+        co_await cv.notify_all();
+    };
+
+    for (int i = 0; i < 100; ++i)
+    {
+        coro::sync_wait(coro::when_all(
+            make_waiter(s, cv, m, resumed, resumed_unlocked),
+            make_waiter(s, cv, m, resumed, resumed_unlocked),
+            make_waiter(s, cv, m, resumed, resumed_unlocked),
+            make_waiter(s, cv, m, resumed, resumed_unlocked),
+            make_notifier(s, cv)));
+    }
+
+    REQUIRE(resumed == 400);
+    REQUIRE(resumed_unlocked == 0);
+    s->shutdown();
+}
+
 TEST_CASE("wait_until(s lock time_point) 1 waiter no_timeout", "[condition_variable]")
 {
     auto s = coro::io_scheduler::make_shared(coro::io_scheduler::options{
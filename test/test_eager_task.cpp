@@ -0,0 +1,130 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+
+TEST_CASE("eager_task", "[eager_task]")
+{
+    std::cerr << "[eager_task]\n\n";
+}
+
+TEST_CASE("eager_task runs synchronously until it suspends", "[eager_task]")
+{
+    uint64_t counter{0};
+
+    auto make_task = [](uint64_t& counter) -> coro::eager_task<uint64_t>
+    {
+        counter += 1;
+        co_return counter;
+    };
+
+    // The body has already run by the time the task is returned.
+    auto task = make_task(counter);
+    REQUIRE(counter == 1);
+    REQUIRE(task.is_ready());
+    REQUIRE(coro::sync_wait(task) == 1);
+}
+
+TEST_CASE("eager_task cache hit never suspends the awaiter", "[eager_task]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+
+    std::unordered_map<uint64_t, std::string> cache{{1, "cached"}};
+
+    auto lookup = [](std::shared_ptr<coro::thread_pool>              tp,
+                     std::unordered_map<uint64_t, std::string>& cache,
+                     uint64_t                                   key) -> coro::eager_task<std::string>
+    {
+        if (auto it = cache.find(key); it != cache.end())
+        {
+            co_return it->second;
+        }
+
+        // A miss goes to another thread to 'load' the value.
+        co_await tp->schedule();
+        cache.emplace(key, "loaded");
+        co_return std::string{"loaded"};
+    };
+
+    auto make_task = [&]() -> coro::task<void>
+    {
+        auto hit = lookup(tp, cache, 1);
+        REQUIRE(hit.is_ready());
+        REQUIRE(co_await hit == "cached");
+
+        auto miss = co_await lookup(tp, cache, 2);
+        REQUIRE(miss == "loaded");
+        co_return;
+    };
+
+    coro::sync_wait(make_task());
+    REQUIRE(cache.size() == 2);
+    tp->shutdown();
+}
+
+TEST_CASE("eager_task completes on another thread while being awaited", "[eager_task]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 2});
+
+    auto make_eager = [](std::shared_ptr<coro::thread_pool> tp, uint64_t value) -> coro::eager_task<uint64_t>
+    {
+        co_await tp->schedule();
+        co_return value;
+    };
+
+    auto make_task = [&]() -> coro::task<uint64_t>
+    {
+        uint64_t total{0};
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            // Races the eager task completing against attaching the continuation.
+            total += co_await make_eager(tp, i);
+        }
+        co_return total;
+    };
+
+    REQUIRE(coro::sync_wait(make_task()) == 499500);
+    tp->shutdown();
+}
+
+TEST_CASE("eager_task void and exceptions", "[eager_task]")
+{
+    bool ran{false};
+    auto make_void = [](bool& ran) -> coro::eager_task<void>
+    {
+        ran = true;
+        co_return;
+    };
+
+    auto t = make_void(ran);
+    REQUIRE(ran);
+    REQUIRE(t.is_ready());
+    coro::sync_wait(t);
+
+    auto make_throw = []() -> coro::eager_task<uint64_t>
+    {
+        throw std::runtime_error{"eager"};
+        co_return 1;
+    };
+
+    auto thrower = make_throw();
+    REQUIRE(thrower.is_ready());
+    REQUIRE_THROWS_AS(coro::sync_wait(thrower), std::runtime_error);
+}
+
+TEST_CASE("eager_task returning a reference", "[eager_task]")
+{
+    uint64_t value{42};
+    auto     make_task = [](uint64_t& value) -> coro::eager_task<uint64_t&> { co_return value; };
+
+    auto& ref = coro::sync_wait(make_task(value));
+    REQUIRE(std::addressof(ref) == std::addressof(value));
+}
+
+TEST_CASE("~eager_task", "[eager_task]")
+{
+    std::cerr << "[~eager_task]\n\n";
+}
@@ -0,0 +1,92 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#if defined(CORO_PLATFORM_UNIX)
+
+    #include <filesystem>
+    #include <random>
+    #include <string>
+    #include <vector>
+
+    #include <unistd.h>
+
+TEST_CASE("file", "[file]")
+{
+    std::cerr << "[file]\n\n";
+}
+
+TEST_CASE("file write_at read_at fsync", "[file]")
+{
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+    auto helper = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 2});
+    // Unique per run so concurrent test processes do not share the file.
+    auto name =
+        "libcoro_test_file_" + std::to_string(::getpid()) + "_" + std::to_string(std::random_device{}()) + ".bin";
+    auto path = std::filesystem::temp_directory_path() / name;
+
+    auto make_task = [](std::shared_ptr<coro::io_scheduler> s,
+                        std::shared_ptr<coro::thread_pool>  helper,
+                        std::filesystem::path               path) -> coro::task<void>
+    {
+        co_await s->schedule();
+        coro::file f{s, helper, path, coro::file::open_mode::read_write};
+        REQUIRE(f.is_open());
+
+        std::string first{"hello "};
+        std::string second{"world"};
+
+        // Writes at explicit offsets can be issued out of order.
+        auto [wstatus2, wremaining2] = co_await f.write_at(second, first.size());
+        REQUIRE(wstatus2 == coro::file_status::ok);
+        REQUIRE(wremaining2.empty());
+        auto [wstatus1, wremaining1] = co_await f.write_at(first, 0);
+        REQUIRE(wstatus1 == coro::file_status::ok);
+        REQUIRE(wremaining1.empty());
+
+        REQUIRE(co_await f.fsync() == coro::file_status::ok);
+        REQUIRE(co_await f.fsync(true) == coro::file_status::ok);
+
+        std::string buffer(5, '\0');
+        auto [rstatus, read] = co_await f.read_at(buffer, 6);
+        REQUIRE(rstatus == coro::file_status::ok);
+        REQUIRE(std::string{read.data(), read.size()} == "world");
+
+        // Reading past the end returns the partial read.
+        std::string large(64, '\0');
+        auto [estatus, partial] = co_await f.read_at(large, 0);
+        REQUIRE(estatus == coro::file_status::end_of_file);
+        REQUIRE(std::string{partial.data(), partial.size()} == "hello world");
+
+        auto [eofstatus, none] = co_await f.read_at(large, 1024);
+        REQUIRE(eofstatus == coro::file_status::end_of_file);
+        REQUIRE(none.empty());
+        co_return;
+    };
+
+    coro::sync_wait(make_task(s, helper, path));
+    std::filesystem::remove(path);
+
+    std::cerr << "io_scheduler.size() before shutdown = " << s->size() << "\n";
+    s->shutdown();
+    std::cerr << "io_scheduler.size() after shutdown = " << s->size() << "\n";
+    REQUIRE(s->empty());
+}
+
+TEST_CASE("file open failure", "[file]")
+{
+    auto s      = coro::io_scheduler::make_shared();
+    auto helper = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+
+    REQUIRE_THROWS_AS(
+        coro::file(s, helper, "/this/path/does/not/exist/libcoro.bin", coro::file::open_mode::read),
+        std::runtime_error);
+}
+
+TEST_CASE("~file", "[file]")
+{
+    std::cerr << "[~file]\n\n";
+}
+
+#endif // CORO_PLATFORM_UNIX
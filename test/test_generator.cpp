@@ -2,7 +2,9 @@
 
 #include <coro/coro.hpp>
 
+#include <array>
 #include <iostream>
+#include <memory_resource>
 
 TEST_CASE("generator", "[generator]")
 {
@@ -85,6 +87,29 @@ TEST_CASE("generator satisfies view concept for compatibility with std::views::t
     }
 }
 
+TEST_CASE("generator allocator_arg", "[generator]")
+{
+    std::array<std::byte, 1024>         buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+    auto func = [](std::allocator_arg_t, std::pmr::polymorphic_allocator<std::byte>, int64_t max)
+        -> coro::generator<int64_t>
+    {
+        for (int64_t i = 0; i < max; ++i)
+        {
+            co_yield i;
+        }
+    };
+
+    // The arena has no upstream, the frame can only have come from the buffer.
+    int64_t sum{0};
+    for (auto v : func(std::allocator_arg, &arena, 10))
+    {
+        sum += v;
+    }
+    REQUIRE(sum == 45);
+}
+
 TEST_CASE("~generator", "[generator]")
 {
     std::cerr << "[~generator]\n\n";
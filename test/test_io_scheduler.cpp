@@ -186,6 +186,178 @@ TEST_CASE("io_scheduler task with read poll with timeout", "[io_scheduler]")
     close(trigger_fds[1]);
 }
 
+TEST_CASE("io_scheduler poll operation awaited directly", "[io_scheduler]")
+{
+    auto trigger_fds = std::array<fd_t, 2>{};
+    ::pipe(trigger_fds.data());
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    auto make_poll_write_task = [](std::shared_ptr<coro::io_scheduler> s, int trigger_fd) -> coro::task<coro::poll_status>
+    {
+        co_await s->schedule();
+        uint64_t value{42};
+        auto     unused = write(trigger_fd, &value, sizeof(value));
+        (void)unused;
+        co_return coro::poll_status::event;
+    };
+
+    // The poll operation is a plain awaitable, it can be moved into when_all prior to being awaited.
+    auto poll_op = s->poll(trigger_fds[0], coro::poll_op::read, 1s);
+    auto [read_status, write_status] = coro::sync_wait(
+        coro::when_all(std::move(poll_op), make_poll_write_task(s, trigger_fds[1])));
+    REQUIRE(read_status.return_value() == coro::poll_status::event);
+    REQUIRE(write_status.return_value() == coro::poll_status::event);
+
+    std::cerr << "io_scheduler.size() before shutdown = " << s->size() << "\n";
+    s->shutdown();
+    std::cerr << "io_scheduler.size() after shutdown = " << s->size() << "\n";
+    REQUIRE(s->empty());
+    close(trigger_fds[0]);
+    close(trigger_fds[1]);
+}
+
+TEST_CASE("io_scheduler poll cancelled by stop token", "[io_scheduler]")
+{
+    auto trigger_fds = std::array<fd_t, 2>{};
+    ::pipe(trigger_fds.data());
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    std::stop_source stop_source{};
+
+    auto make_poll_task = [](std::shared_ptr<coro::io_scheduler> s, int fd, std::stop_token st)
+        -> coro::task<coro::poll_status>
+    {
+        co_await s->schedule();
+        // Nothing is ever written, only the stop request can resume this poll before its timeout.
+        co_return co_await s->poll(fd, coro::poll_op::read, 10s, std::move(st));
+    };
+
+    auto make_stop_task = [](std::shared_ptr<coro::io_scheduler> s, std::stop_source& ss) -> coro::task<void>
+    {
+        co_await s->schedule();
+        co_await s->yield_for(10ms);
+        ss.request_stop();
+        co_return;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto [poll_status, unused] = coro::sync_wait(
+        coro::when_all(make_poll_task(s, trigger_fds[0], stop_source.get_token()), make_stop_task(s, stop_source)));
+    REQUIRE(poll_status.return_value() == coro::poll_status::cancelled);
+    REQUIRE(std::chrono::steady_clock::now() - start < 10s);
+    REQUIRE(s->stats().timed_events == 0);
+
+    // A poll awaited with an already stopped token completes immediately without registering.
+    auto stopped = coro::sync_wait(make_poll_task(s, trigger_fds[0], stop_source.get_token()));
+    REQUIRE(stopped == coro::poll_status::cancelled);
+
+    std::cerr << "io_scheduler.size() before shutdown = " << s->size() << "\n";
+    s->shutdown();
+    std::cerr << "io_scheduler.size() after shutdown = " << s->size() << "\n";
+    REQUIRE(s->empty());
+    close(trigger_fds[0]);
+    close(trigger_fds[1]);
+}
+
+TEST_CASE("io_scheduler schedule task with timeout", "[io_scheduler]")
+{
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    auto make_task = [](std::shared_ptr<coro::io_scheduler> s, uint64_t value) -> coro::task<uint64_t>
+    {
+        co_await s->schedule();
+        co_return value;
+    };
+
+    auto make_many = [&]() -> coro::task<uint64_t>
+    {
+        uint64_t total{0};
+        for (uint64_t i = 0; i < 1000; ++i)
+        {
+            auto result = co_await s->schedule(make_task(s, i), 30s);
+            total += result.value();
+        }
+        co_return total;
+    };
+
+    // Every fast task removes its timer on completion, none of the 30 second timeouts are left behind.
+    REQUIRE(coro::sync_wait(make_many()) == 499500);
+    REQUIRE(s->stats().timed_events == 0);
+
+    // When the timeout wins the task keeps running and its frame is freed once it completes.
+    std::atomic<bool> destroyed{false};
+    struct set_on_destroy
+    {
+        std::atomic<bool>& m_flag;
+        ~set_on_destroy() { m_flag = true; }
+    };
+
+    auto make_slow_task = [](std::shared_ptr<coro::io_scheduler> s, std::atomic<bool>& destroyed) -> coro::task<uint64_t>
+    {
+        set_on_destroy guard{destroyed};
+        co_await s->yield_for(50ms);
+        co_return 1;
+    };
+
+    auto timed_out = coro::sync_wait(s->schedule(make_slow_task(s, destroyed), 5ms));
+    REQUIRE_FALSE(timed_out.has_value());
+    REQUIRE(timed_out.error() == coro::timeout_status::timeout);
+    REQUIRE_FALSE(destroyed);
+    while (!destroyed)
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    auto make_throw = []() -> coro::task<uint64_t>
+    {
+        throw std::runtime_error{"timed"};
+        co_return 0;
+    };
+    REQUIRE_THROWS_AS(coro::sync_wait(s->schedule(make_throw(), 30s)), std::runtime_error);
+
+    s->shutdown();
+    REQUIRE(s->empty());
+}
+
+TEST_CASE("io_scheduler yield_for cancelled by stop token", "[io_scheduler]")
+{
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    std::stop_source stop_source{};
+
+    auto make_timer_task = [](std::shared_ptr<coro::io_scheduler> s, std::stop_token st) -> coro::task<coro::poll_status>
+    {
+        co_await s->schedule();
+        co_return co_await s->yield_for(10s, std::move(st));
+    };
+
+    auto make_stop_task = [](std::shared_ptr<coro::io_scheduler> s, std::stop_source& ss) -> coro::task<void>
+    {
+        co_await s->schedule();
+        co_await s->yield_for(10ms);
+        ss.request_stop();
+        co_return;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    auto [timer_status, unused] =
+        coro::sync_wait(coro::when_all(make_timer_task(s, stop_source.get_token()), make_stop_task(s, stop_source)));
+    REQUIRE(timer_status.return_value() == coro::poll_status::cancelled);
+    REQUIRE(std::chrono::steady_clock::now() - start < 10s);
+    REQUIRE(s->stats().timed_events == 0);
+
+    // Without a stop request the timer expires as normal.
+    auto expired = coro::sync_wait(s->schedule_after(5ms, std::stop_token{}));
+    REQUIRE(expired == coro::poll_status::timeout);
+
+    s->shutdown();
+    REQUIRE(s->empty());
+}
+
 TEST_CASE("io_scheduler task with read poll timeout", "[io_scheduler]")
 {
     auto trigger_fds = std::array<fd_t, 2>{};
@@ -566,6 +738,218 @@ TEST_CASE("io_scheduler yield_until", "[io_scheduler]")
     REQUIRE(s->empty());
 }
 
+TEST_CASE("io_scheduler yield_until sub-millisecond", "[io_scheduler]")
+{
+    auto s = coro::io_scheduler::make_shared(coro::io_scheduler::options{
+        .execution_strategy = coro::io_scheduler::execution_strategy_t::process_tasks_inline,
+        .timer_spin         = std::chrono::microseconds{50}});
+
+    const std::chrono::microseconds wait_for{250};
+
+    auto make_task = [](std::shared_ptr<coro::io_scheduler> s,
+                        std::chrono::microseconds           wait_for) -> coro::task<std::chrono::nanoseconds>
+    {
+        co_await s->schedule();
+        auto deadline = std::chrono::steady_clock::now() + wait_for;
+        co_await s->yield_until(deadline);
+        co_return std::chrono::steady_clock::now() - deadline;
+    };
+
+    // The deadline is no longer truncated to milliseconds, so the task can never resume early.
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+        auto lateness = coro::sync_wait(make_task(s, wait_for));
+        REQUIRE(lateness >= std::chrono::nanoseconds{0});
+    }
+
+    std::cerr << "io_scheduler.size() before shutdown = " << s->size() << "\n";
+    s->shutdown();
+    std::cerr << "io_scheduler.size() after shutdown = " << s->size() << "\n";
+    REQUIRE(s->empty());
+}
+
+TEST_CASE("io_scheduler schedule_every", "[io_scheduler]")
+{
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    const std::chrono::milliseconds period{5};
+
+    auto make_drift_task = [](std::shared_ptr<coro::io_scheduler> s,
+                              std::chrono::milliseconds           period) -> coro::task<void>
+    {
+        co_await s->schedule();
+        auto timer = s->schedule_every(period);
+        auto start = timer.next_tick() - period;
+
+        // Every tick lands on start + n * period regardless of how long each tick took to resume.
+        for (int64_t n = 1; n <= 5; ++n)
+        {
+            auto ticks = co_await timer;
+            REQUIRE(ticks == 1);
+            REQUIRE(std::chrono::steady_clock::now() >= start + period * n);
+            REQUIRE(timer.next_tick() == start + period * (n + 1));
+        }
+        co_return;
+    };
+
+    auto make_missed_task = [](std::shared_ptr<coro::io_scheduler> s,
+                               std::chrono::milliseconds           period,
+                               coro::missed_tick_policy            policy) -> coro::task<uint64_t>
+    {
+        co_await s->schedule();
+        auto timer = s->schedule_every(period, policy);
+        co_await timer;
+
+        // Fall behind by several ticks.
+        std::this_thread::sleep_for(period * 4 + period / 2);
+        auto ticks = co_await timer;
+
+        // The missed ticks are dropped, the next tick is back on the original schedule.
+        REQUIRE(timer.next_tick() > std::chrono::steady_clock::now());
+        co_return ticks;
+    };
+
+    auto make_burst_task = [](std::shared_ptr<coro::io_scheduler> s,
+                              std::chrono::milliseconds           period) -> coro::task<void>
+    {
+        co_await s->schedule();
+        auto timer = s->schedule_every(period, coro::missed_tick_policy::burst);
+        auto start = timer.next_tick() - period;
+        co_await timer;
+
+        // Fall behind by several ticks, the deadlines at 2..5 periods have all passed.
+        std::this_thread::sleep_for(period * 4 + period / 2);
+
+        // Each missed tick is delivered on its own and back to back, none of them waits for a deadline.
+        auto burst_start = std::chrono::steady_clock::now();
+        for (int64_t n = 2; n <= 5; ++n)
+        {
+            auto ticks = co_await timer;
+            REQUIRE(ticks == 1);
+            REQUIRE(timer.next_tick() == start + period * (n + 1));
+        }
+        REQUIRE(std::chrono::steady_clock::now() - burst_start < period);
+
+        // Caught up, the next tick waits for its deadline on the original start + n * period schedule.
+        auto ticks = co_await timer;
+        REQUIRE(ticks == 1);
+        REQUIRE(std::chrono::steady_clock::now() >= start + period * 6);
+        REQUIRE(timer.next_tick() == start + period * 7);
+        co_return;
+    };
+
+    coro::sync_wait(make_drift_task(s, period));
+    REQUIRE(coro::sync_wait(make_missed_task(s, period, coro::missed_tick_policy::skip)) == 1);
+    REQUIRE(coro::sync_wait(make_missed_task(s, period, coro::missed_tick_policy::coalesce)) >= 4);
+    coro::sync_wait(make_burst_task(s, period));
+
+    std::cerr << "io_scheduler.size() before shutdown = " << s->size() << "\n";
+    s->shutdown();
+    std::cerr << "io_scheduler.size() after shutdown = " << s->size() << "\n";
+    REQUIRE(s->empty());
+}
+
+TEST_CASE("io_scheduler resumes timed events on the suspending worker", "[io_scheduler]")
+{
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 4}});
+
+    auto make_task = [](std::shared_ptr<coro::io_scheduler> s) -> coro::task<uint64_t>
+    {
+        co_await s->schedule();
+
+        uint64_t same_worker{0};
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            auto before = coro::thread_pool::current_worker();
+            co_await s->yield_for(std::chrono::milliseconds{1});
+            if (coro::thread_pool::current_worker() == before)
+            {
+                ++same_worker;
+            }
+        }
+        co_return same_worker;
+    };
+
+    // The only coroutine on the pool, nothing can steal it away from its preferred worker.
+    REQUIRE(coro::sync_wait(make_task(s)) == 20);
+
+    std::cerr << "io_scheduler.size() before shutdown = " << s->size() << "\n";
+    s->shutdown();
+    std::cerr << "io_scheduler.size() after shutdown = " << s->size() << "\n";
+    REQUIRE(s->empty());
+}
+
+TEST_CASE("io_scheduler timed event pinned to a blocked worker is stolen", "[io_scheduler]")
+{
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 2}});
+
+    auto make_pinned_task = [](std::shared_ptr<coro::io_scheduler> s) -> coro::task<std::size_t>
+    {
+        co_await s->yield_for(std::chrono::milliseconds{10});
+        co_return coro::thread_pool::current_worker();
+    };
+
+    auto make_blocking_task = [&make_pinned_task](std::shared_ptr<coro::io_scheduler> s) -> coro::task<bool>
+    {
+        co_await s->schedule();
+        auto worker = coro::thread_pool::current_worker();
+
+        // Started inline the pinned task suspends on this worker, which then blocks until it has completed.
+        auto pinned = make_pinned_task(s);
+        pinned.resume();
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        while (!pinned.is_ready() && std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+        co_return pinned.is_ready() && pinned.promise().result() != worker;
+    };
+
+    REQUIRE(coro::sync_wait(make_blocking_task(s)));
+
+    std::cerr << "io_scheduler.size() before shutdown = " << s->size() << "\n";
+    s->shutdown();
+    std::cerr << "io_scheduler.size() after shutdown = " << s->size() << "\n";
+    REQUIRE(s->empty());
+}
+
+TEST_CASE("io_scheduler stats", "[io_scheduler]")
+{
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    auto before = s->stats();
+
+    auto make_task = [](std::shared_ptr<coro::io_scheduler> s) -> coro::task<void>
+    {
+        co_await s->schedule();
+        co_await s->yield_for(std::chrono::milliseconds{5});
+        co_return;
+    };
+
+    coro::sync_wait(coro::when_all(make_task(s), make_task(s)));
+
+    auto after = s->stats();
+    REQUIRE(after.loop_iterations > before.loop_iterations);
+    REQUIRE(after.events >= after.loop_iterations - before.loop_iterations);
+    REQUIRE(after.timers_fired - before.timers_fired == 2);
+    REQUIRE(after.resumed_offloaded - before.resumed_offloaded >= 2);
+    REQUIRE(after.resumed_inline == 0);
+    REQUIRE(after.timed_events == 0);
+    REQUIRE(after.time_blocked > std::chrono::nanoseconds{0});
+    REQUIRE(after.max_timer_lateness <= after.timer_lateness);
+    REQUIRE(after.events_per_iteration() > 0.0);
+
+    std::cerr << "io_scheduler.size() before shutdown = " << s->size() << "\n";
+    s->shutdown();
+    std::cerr << "io_scheduler.size() after shutdown = " << s->size() << "\n";
+    REQUIRE(s->empty());
+}
+
 TEST_CASE("io_scheduler multipler event waiters", "[io_scheduler]")
 {
     const constexpr std::size_t total{10};
@@ -2,9 +2,11 @@
 
 #include <coro/coro.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 TEST_CASE("mutex", "[mutex]")
 {
@@ -142,6 +144,71 @@ TEST_CASE("mutex lock", "[mutex]")
     coro::sync_wait(make_task(m));
 }
 
+TEST_CASE("mutex spin before suspending", "[mutex]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 4});
+
+    coro::mutex m{128};
+    uint64_t    counter{0};
+
+    auto make_task = [&]() -> coro::task<void>
+    {
+        co_await tp->schedule();
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto lk = co_await m.scoped_lock();
+            ++counter;
+        }
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (int i = 0; i < 8; ++i)
+    {
+        tasks.emplace_back(make_task());
+    }
+    coro::sync_wait(coro::when_all(std::move(tasks)));
+
+    REQUIRE(counter == 8000);
+    REQUIRE(m.try_lock());
+    m.unlock();
+    tp->shutdown();
+}
+
+TEST_CASE("mutex unlock hands the waiter to the executor", "[mutex]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+
+    coro::mutex       m{tp};
+    std::atomic<bool> acquired{false};
+    std::thread::id   acquired_on{};
+
+    auto make_waiter = [&]() -> coro::task<void>
+    {
+        co_await m.lock();
+        acquired_on = std::this_thread::get_id();
+        acquired    = true;
+        m.unlock();
+    };
+
+    REQUIRE(m.try_lock());
+    auto waiter = make_waiter();
+    waiter.resume();
+    REQUIRE_FALSE(waiter.is_ready());
+
+    // Resuming inline would run the waiter on this thread before unlock() returns.
+    m.unlock();
+    while (!acquired)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    tp->shutdown();
+
+    REQUIRE(acquired_on != std::this_thread::get_id());
+    REQUIRE(waiter.is_ready());
+    REQUIRE(m.try_lock());
+    m.unlock();
+}
+
 TEST_CASE("~mutex", "[mutex]")
 {
     std::cerr << "[~mutex]\n\n";
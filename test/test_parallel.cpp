@@ -0,0 +1,115 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("parallel", "[parallel]")
+{
+    std::cerr << "[parallel]\n\n";
+}
+
+TEST_CASE("parallel_for visits every element once", "[parallel]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 4});
+
+    std::vector<uint64_t> values(10'000, 0);
+    coro::sync_wait(coro::parallel_for(tp, values, [](uint64_t& v) { v += 1; }));
+    REQUIRE(std::ranges::all_of(values, [](uint64_t v) { return v == 1; }));
+
+    // A grain of one splits all the way down to single elements.
+    std::atomic<uint64_t> visited{0};
+    coro::sync_wait(coro::parallel_for(tp, std::views::iota(0, 100), [&](int) { visited.fetch_add(1); }, 1));
+    REQUIRE(visited == 100);
+
+    std::vector<uint64_t> empty{};
+    coro::sync_wait(coro::parallel_for(tp, empty, [](uint64_t&) { FAIL("visited an empty range"); }));
+    tp->shutdown();
+}
+
+TEST_CASE("parallel_for propagates exceptions", "[parallel]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 2});
+
+    std::vector<uint64_t> values(1'000);
+    std::iota(values.begin(), values.end(), 0);
+    auto f = [](uint64_t v)
+    {
+        if (v == 500)
+        {
+            throw std::runtime_error{"500"};
+        }
+    };
+
+    REQUIRE_THROWS_AS(coro::sync_wait(coro::parallel_for(tp, values, f, 10)), std::runtime_error);
+    tp->shutdown();
+}
+
+TEST_CASE("parallel_transform_reduce", "[parallel]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 4});
+
+    std::vector<uint64_t> values(100'000);
+    std::iota(values.begin(), values.end(), 1);
+
+    auto sum_of_squares = coro::sync_wait(
+        coro::parallel_transform_reduce(tp, values, uint64_t{0}, std::plus<>{}, [](uint64_t v) { return v * v; }));
+    uint64_t expected{0};
+    for (auto v : values)
+    {
+        expected += v * v;
+    }
+    REQUIRE(sum_of_squares == expected);
+
+    // The initial value is reduced in once, an empty range returns it unchanged.
+    std::vector<uint64_t> empty{};
+    REQUIRE(
+        coro::sync_wait(coro::parallel_transform_reduce(
+            tp, empty, uint64_t{42}, std::plus<>{}, [](uint64_t v) { return v; })) == 42);
+
+    auto max = coro::sync_wait(coro::parallel_transform_reduce(
+        tp, values, uint64_t{0}, [](uint64_t a, uint64_t b) { return std::max(a, b); }, [](uint64_t v) { return v; }, 7));
+    REQUIRE(max == 100'000);
+
+    // An rvalue range is moved into the task, it does not dangle when the task is started later.
+    auto task = coro::parallel_transform_reduce(
+        tp, std::vector<uint64_t>(1'000, 2), uint64_t{0}, std::plus<>{}, [](uint64_t v) { return v; }, 10);
+    REQUIRE(coro::sync_wait(std::move(task)) == 2'000);
+    tp->shutdown();
+}
+
+TEST_CASE("parallel_sort", "[parallel]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 4});
+
+    std::mt19937_64       rng{42};
+    std::vector<uint64_t> values(100'000);
+    std::ranges::generate(values, rng);
+    auto expected = values;
+    std::ranges::sort(expected);
+
+    coro::sync_wait(coro::parallel_sort(tp, values));
+    REQUIRE(values == expected);
+
+    // Descending with a tiny grain to exercise many merges.
+    std::ranges::shuffle(values, rng);
+    coro::sync_wait(coro::parallel_sort(tp, values, std::ranges::greater{}, 16));
+    REQUIRE(std::ranges::is_sorted(values, std::ranges::greater{}));
+
+    std::vector<uint64_t> single{1};
+    coro::sync_wait(coro::parallel_sort(tp, single));
+    REQUIRE(single.front() == 1);
+    tp->shutdown();
+}
+
+TEST_CASE("~parallel", "[parallel]")
+{
+    std::cerr << "[~parallel]\n\n";
+}
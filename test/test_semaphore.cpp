@@ -2,6 +2,7 @@
 
 #include <coro/coro.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -274,6 +275,107 @@ TEST_CASE("semaphore 1 producers and many consumers", "[semaphore]")
     std::cerr << "END semaphore 1 producers and many consumers\n";
 }
 
+TEST_CASE("semaphore acquire and release many", "[semaphore]")
+{
+    coro::semaphore<10> s{10};
+
+    auto make_task = [&]() -> coro::task<void>
+    {
+        auto first  = co_await s.acquire(4);
+        auto second = co_await s.acquire(4);
+        REQUIRE(first == coro::semaphore_acquire_result::acquired);
+        REQUIRE(second == coro::semaphore_acquire_result::acquired);
+        REQUIRE(s.value() == 2);
+        REQUIRE_FALSE(s.try_acquire(3));
+        REQUIRE(s.try_acquire(2));
+        co_return;
+    };
+
+    coro::sync_wait(make_task());
+    REQUIRE(s.value() == 0);
+
+    s.release(8);
+    REQUIRE(s.value() == 8);
+    s.release(8);
+    REQUIRE(s.value() == 10);
+
+    REQUIRE_THROWS_AS(s.acquire(11), std::runtime_error);
+
+    // A negative or oversized release is rejected and leaves the counter untouched.
+    REQUIRE_THROWS_AS(s.release(-1), std::runtime_error);
+    REQUIRE_THROWS_AS(s.release(11), std::runtime_error);
+    REQUIRE(s.value() == 10);
+}
+
+TEST_CASE("semaphore acquire many is first in first out", "[semaphore]")
+{
+    coro::semaphore<10>   s{0};
+    std::vector<uint64_t> order{};
+
+    auto make_task = [&](uint64_t id, std::ptrdiff_t count) -> coro::task<void>
+    {
+        co_await s.acquire(count);
+        order.emplace_back(id);
+        co_return;
+    };
+
+    auto large = make_task(1, 8);
+    auto small = make_task(2, 1);
+    large.resume();
+    small.resume();
+
+    // The small request fits but must not overtake the large one queued ahead of it.
+    s.release(5);
+    REQUIRE(order.empty());
+    REQUIRE(s.value() == 5);
+    REQUIRE_FALSE(s.try_acquire());
+
+    // Both are satisfied by a single release, in the order they arrived.
+    s.release(5);
+    REQUIRE(order == std::vector<uint64_t>{1, 2});
+    REQUIRE(s.value() == 1);
+    REQUIRE(s.try_acquire());
+}
+
+TEST_CASE("semaphore release resumes waiters on the executor", "[semaphore]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+
+    coro::semaphore<4>    s{0, tp};
+    std::atomic<uint64_t> on_executor{0};
+    auto                  releasing_thread = std::this_thread::get_id();
+
+    auto make_task = [&]() -> coro::task<void>
+    {
+        co_await s.acquire(2);
+        if (std::this_thread::get_id() != releasing_thread)
+        {
+            on_executor.fetch_add(1, std::memory_order::relaxed);
+        }
+        co_return;
+    };
+
+    std::vector<coro::task<void>> tasks{};
+    for (int i = 0; i < 2; ++i)
+    {
+        tasks.emplace_back(make_task());
+        tasks.back().resume();
+    }
+
+    s.release(4);
+    for (const auto& t : tasks)
+    {
+        while (!t.is_ready())
+        {
+            std::this_thread::yield();
+        }
+    }
+    REQUIRE(on_executor == 2);
+    REQUIRE(s.value() == 0);
+
+    tp->shutdown();
+}
+
 TEST_CASE("~semaphore", "[semaphore]")
 {
     std::cerr << "[~semaphore]\n\n";
@@ -2,6 +2,7 @@
 
 #include <coro/coro.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <thread>
@@ -180,6 +181,155 @@ TEST_CASE("mutex many shared and exclusive waiters interleaved", "[shared_mutex]
 }
 #endif // #ifdef LIBCORO_FEATURE_NETWORKING
 
+TEST_CASE("shared_mutex prefer_writers queues shared lockers behind an exclusive waiter", "[shared_mutex]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+    coro::shared_mutex<coro::thread_pool> m{tp};
+
+    REQUIRE(m.try_lock_shared());
+
+    auto make_exclusive_task = [&]() -> coro::task<void>
+    {
+        auto scoped_lock = co_await m.lock();
+        co_return;
+    };
+
+    auto exclusive = make_exclusive_task();
+    exclusive.resume();
+    REQUIRE_FALSE(exclusive.is_ready());
+
+    // The exclusive waiter holds back new shared users until it has had the lock.
+    REQUIRE_FALSE(m.try_lock_shared());
+    m.unlock_shared();
+    REQUIRE(exclusive.is_ready());
+
+    REQUIRE(m.try_lock_shared());
+    m.unlock_shared();
+}
+
+TEST_CASE("shared_mutex prefer_readers lets shared lockers past an exclusive waiter", "[shared_mutex]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+    coro::shared_mutex<coro::thread_pool> m{tp, coro::shared_mutex_policy::prefer_readers};
+
+    REQUIRE(m.try_lock_shared());
+
+    auto make_exclusive_task = [&]() -> coro::task<void>
+    {
+        auto scoped_lock = co_await m.lock();
+        co_return;
+    };
+
+    auto exclusive = make_exclusive_task();
+    exclusive.resume();
+    REQUIRE_FALSE(exclusive.is_ready());
+
+    REQUIRE(m.try_lock_shared());
+    m.unlock_shared();
+    REQUIRE_FALSE(exclusive.is_ready());
+
+    // The last shared user hands the lock to the exclusive waiter.
+    m.unlock_shared();
+    REQUIRE(exclusive.is_ready());
+    REQUIRE(m.try_lock());
+    m.unlock();
+}
+
+TEST_CASE("shared_mutex unlock wakes every shared waiter in batches", "[shared_mutex]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 2});
+
+    for (auto policy : {coro::shared_mutex_policy::prefer_writers, coro::shared_mutex_policy::prefer_readers})
+    {
+        coro::shared_mutex<coro::thread_pool> m{tp, policy};
+        std::atomic<uint64_t>                 readers{0};
+
+        auto make_shared_task = [&]() -> coro::task<void>
+        {
+            auto scoped_lock = co_await m.lock_shared();
+            readers.fetch_add(1, std::memory_order::relaxed);
+        };
+
+        REQUIRE(m.try_lock());
+
+        std::vector<coro::task<void>> tasks{};
+        for (std::size_t i = 0; i < 100; ++i)
+        {
+            tasks.emplace_back(make_shared_task());
+            tasks.back().resume();
+        }
+        REQUIRE(readers == 0);
+
+        m.unlock();
+        for (const auto& t : tasks)
+        {
+            while (!t.is_ready())
+            {
+                std::this_thread::yield();
+            }
+        }
+        REQUIRE(readers == 100);
+        REQUIRE(m.try_lock());
+        m.unlock();
+    }
+
+    tp->shutdown();
+}
+
+TEST_CASE("shared_mutex shared and exclusive users from many threads", "[shared_mutex]")
+{
+    constexpr std::size_t tasks_count = 16;
+    constexpr std::size_t iterations  = 1'000;
+
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 4});
+
+    for (auto policy : {coro::shared_mutex_policy::prefer_writers, coro::shared_mutex_policy::prefer_readers})
+    {
+        coro::shared_mutex<coro::thread_pool> m{tp, policy};
+        uint64_t                              value{0};
+        std::atomic<uint64_t>                 readers{0};
+        std::atomic<bool>                     overlapped{false};
+
+        auto make_task = [&](std::size_t id) -> coro::task<void>
+        {
+            co_await tp->schedule();
+            for (std::size_t i = 0; i < iterations; ++i)
+            {
+                if ((id + i) % 8 == 0)
+                {
+                    auto scoped_lock = co_await m.lock();
+                    if (readers.load(std::memory_order::relaxed) != 0)
+                    {
+                        overlapped = true;
+                    }
+                    ++value;
+                }
+                else
+                {
+                    auto scoped_lock = co_await m.lock_shared();
+                    readers.fetch_add(1, std::memory_order::relaxed);
+                    [[maybe_unused]] auto v = value;
+                    readers.fetch_sub(1, std::memory_order::relaxed);
+                }
+            }
+        };
+
+        std::vector<coro::task<void>> tasks{};
+        for (std::size_t i = 0; i < tasks_count; ++i)
+        {
+            tasks.emplace_back(make_task(i));
+        }
+        coro::sync_wait(coro::when_all(std::move(tasks)));
+
+        REQUIRE_FALSE(overlapped);
+        REQUIRE(value == tasks_count * iterations / 8);
+        REQUIRE(m.try_lock());
+        m.unlock();
+    }
+
+    tp->shutdown();
+}
+
 TEST_CASE("~shared_mutex", "[shared_mutex]")
 {
     std::cerr << "[~shared_mutex]\n\n";
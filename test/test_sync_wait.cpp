@@ -2,8 +2,11 @@
 
 #include <coro/coro.hpp>
 
+#include <array>
+#include <chrono>
 #include <iostream>
 #include <random>
+#include <thread>
 #include <unordered_set>
 
 TEST_CASE("sync_wait", "[sync_wait]")
@@ -247,6 +250,52 @@ TEST_CASE("issue-286", "[sync_wait]")
     REQUIRE(foo.m_moves == 2);
 }
 
+TEST_CASE("sync_wait completes on another thread", "[sync_wait]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+
+    // Alternate between completing inside the spin and after the waiter has gone to sleep.
+    auto make_task = [](std::shared_ptr<coro::thread_pool> tp, uint64_t i) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        if (i % 2 == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds{100});
+        }
+        co_return i;
+    };
+
+    uint64_t sum{0};
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        sum += coro::sync_wait(make_task(tp, i));
+    }
+    REQUIRE(sum == 499500);
+    tp->shutdown();
+}
+
+TEST_CASE("sync_wait frame larger than the stack buffer", "[sync_wait]")
+{
+    struct large
+    {
+        std::array<uint64_t, 256> values{};
+    };
+
+    auto make_task = []() -> coro::task<large>
+    {
+        large l{};
+        l.values.back() = 42;
+        co_return l;
+    };
+
+    // The wrapper frame holds the result so it cannot fit in the buffer sync_wait reserves on the stack.
+    static_assert(sizeof(large) > coro::detail::sync_wait_frame_buffer::size);
+    for (int i = 0; i < 3; ++i)
+    {
+        REQUIRE(coro::sync_wait(make_task()).values.back() == 42);
+    }
+}
+
 TEST_CASE("~sync_wait", "[sync_wait]")
 {
     std::cerr << "[~sync_wait]\n\n";
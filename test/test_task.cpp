@@ -4,8 +4,35 @@
 
 #include <chrono>
 #include <iostream>
+#include <memory_resource>
 #include <thread>
 
+namespace
+{
+/// Counts the allocations made through it so tests can see which frames were allocated from it.
+class counting_memory_resource : public std::pmr::memory_resource
+{
+public:
+    uint64_t m_allocations{0};
+    uint64_t m_deallocations{0};
+
+private:
+    auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override
+    {
+        ++m_allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    auto do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) -> void override
+    {
+        ++m_deallocations;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override { return this == &other; }
+};
+} // namespace
+
 TEST_CASE("task", "[task]")
 {
     std::cerr << "[task]\n\n";
@@ -436,9 +463,17 @@ TEST_CASE("task supports instantiation with non assignable type", "[task]")
 TEST_CASE("task promise sizeof", "[task]")
 {
     REQUIRE(sizeof(coro::detail::promise<void>) >= sizeof(std::coroutine_handle<>) + sizeof(std::exception_ptr));
+    // The continuation and the task locals, which are a nullptr unless a task_local is set.
+#ifdef LIBCORO_FEATURE_ASYNC_STACK
+    REQUIRE(
+        sizeof(coro::detail::promise<int32_t>) == sizeof(std::coroutine_handle<>) + sizeof(void*) +
+                                                      sizeof(coro::async_stack_frame) +
+                                                      sizeof(std::variant<int32_t, std::exception_ptr>));
+#else
     REQUIRE(
         sizeof(coro::detail::promise<int32_t>) ==
-        sizeof(std::coroutine_handle<>) + sizeof(std::variant<int32_t, std::exception_ptr>));
+        sizeof(std::coroutine_handle<>) + sizeof(void*) + sizeof(std::variant<int32_t, std::exception_ptr>));
+#endif
     REQUIRE(
         sizeof(coro::detail::promise<int64_t>) >=
         sizeof(std::coroutine_handle<>) + sizeof(std::variant<int64_t, std::exception_ptr>));
@@ -447,6 +482,62 @@ TEST_CASE("task promise sizeof", "[task]")
         sizeof(std::coroutine_handle<>) + sizeof(std::variant<std::vector<int64_t>, std::exception_ptr>));
 }
 
+TEST_CASE("task allocator_arg allocates the frame from the allocator", "[task]")
+{
+    counting_memory_resource                resource{};
+    std::pmr::polymorphic_allocator<std::byte> alloc{&resource};
+
+    auto make_task = [](std::allocator_arg_t, std::pmr::polymorphic_allocator<std::byte>, uint64_t value)
+        -> coro::task<uint64_t> { co_return value * 2; };
+
+    REQUIRE(coro::sync_wait(make_task(std::allocator_arg, alloc, 21)) == 42);
+    REQUIRE(resource.m_allocations == 1);
+    REQUIRE(resource.m_deallocations == 1);
+
+    // std::allocator is the default allocation and leaves the resource alone.
+    auto make_default_task = [](std::allocator_arg_t, std::allocator<std::byte>, uint64_t value)
+        -> coro::task<uint64_t> { co_return value; };
+    REQUIRE(coro::sync_wait(make_default_task(std::allocator_arg, std::allocator<std::byte>{}, 7)) == 7);
+    REQUIRE(resource.m_allocations == 1);
+}
+
+TEST_CASE("task allocator_arg with a monotonic buffer arena", "[task]")
+{
+    counting_memory_resource            upstream{};
+    std::pmr::monotonic_buffer_resource arena{4096, &upstream};
+
+    struct handler
+    {
+        uint64_t m_base{100};
+
+        // A member function coroutine, the allocator follows the implicit object parameter.
+        auto handle(std::allocator_arg_t, std::pmr::polymorphic_allocator<std::byte>, uint64_t value)
+            -> coro::task<uint64_t>
+        {
+            co_return m_base + value;
+        }
+    };
+
+    auto make_request = [](std::allocator_arg_t, std::pmr::polymorphic_allocator<std::byte> alloc, handler& h)
+        -> coro::task<uint64_t>
+    {
+        uint64_t total{0};
+        for (uint64_t i = 0; i < 10; ++i)
+        {
+            total += co_await h.handle(std::allocator_arg, alloc, i);
+        }
+        co_return total;
+    };
+
+    handler h{};
+    REQUIRE(coro::sync_wait(make_request(std::allocator_arg, &arena, h)) == 1045);
+
+    // Every frame came out of the arena's single upstream block, which is freed all at once.
+    REQUIRE(upstream.m_allocations == 1);
+    arena.release();
+    REQUIRE(upstream.m_deallocations == 1);
+}
+
 TEST_CASE("~task", "[task]")
 {
     std::cerr << "[~task]\n\n";
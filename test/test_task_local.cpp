@@ -0,0 +1,172 @@
+#include "catch_amalgamated.hpp"
+
+#include <coro/coro.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace
+{
+coro::task_local<std::string> trace_id{};
+coro::task_local<uint64_t>    tenant_id{};
+} // namespace
+
+TEST_CASE("task_local", "[task_local]")
+{
+    std::cerr << "[task_local]\n\n";
+}
+
+TEST_CASE("task_local unset and set", "[task_local]")
+{
+    auto make_task = []() -> coro::task<void>
+    {
+        auto locals = co_await coro::this_task::locals();
+        REQUIRE(locals.get(trace_id) == nullptr);
+
+        locals.set(trace_id, "abc");
+        REQUIRE(*locals.get(trace_id) == "abc");
+        REQUIRE(locals.get(tenant_id) == nullptr);
+
+        locals.set(tenant_id, uint64_t{42});
+        locals.set(trace_id, "def");
+        REQUIRE(*locals.get(trace_id) == "def");
+        REQUIRE(*locals.get(tenant_id) == 42);
+        co_return;
+    };
+
+    coro::sync_wait(make_task());
+}
+
+TEST_CASE("task_local inherited by awaited tasks", "[task_local]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 2});
+
+    auto make_leaf = [](std::shared_ptr<coro::thread_pool> tp) -> coro::task<std::string>
+    {
+        // The value follows the task onto the pool's threads.
+        co_await tp->schedule();
+        auto locals = co_await coro::this_task::locals();
+        co_return *locals.get(trace_id);
+    };
+
+    auto make_child = [&]() -> coro::task<std::string>
+    {
+        auto locals = co_await coro::this_task::locals();
+        auto before = co_await make_leaf(tp);
+
+        // Overriding in a child is visible to its own children but never to the parent.
+        locals.set(trace_id, "child");
+        auto after = co_await make_leaf(tp);
+        co_return before + "," + after;
+    };
+
+    auto make_task = [&]() -> coro::task<std::string>
+    {
+        auto locals = co_await coro::this_task::locals();
+        locals.set(trace_id, "parent");
+
+        auto result = co_await make_child();
+        REQUIRE(*locals.get(trace_id) == "parent");
+        co_return result;
+    };
+
+    REQUIRE(coro::sync_wait(make_task()) == "parent,child");
+    tp->shutdown();
+}
+
+TEST_CASE("task_local inherited through when_all and when_any", "[task_local]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 2});
+
+    auto make_leaf = [](std::shared_ptr<coro::thread_pool> tp) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        auto locals = co_await coro::this_task::locals();
+        co_return *locals.get(tenant_id);
+    };
+
+    auto make_task = [&]() -> coro::task<uint64_t>
+    {
+        auto locals = co_await coro::this_task::locals();
+        locals.set(tenant_id, uint64_t{7});
+
+        std::vector<coro::task<uint64_t>> tasks{};
+        for (int i = 0; i < 4; ++i)
+        {
+            tasks.emplace_back(make_leaf(tp));
+        }
+
+        uint64_t sum{0};
+        auto     results = co_await coro::when_all(std::move(tasks));
+        for (auto& t : results)
+        {
+            sum += t.return_value();
+        }
+
+        auto [first, second] = co_await coro::when_all(make_leaf(tp), make_leaf(tp));
+        sum += first.return_value() + second.return_value();
+
+#ifndef EMSCRIPTEN
+        std::vector<coro::task<uint64_t>> racers{};
+        racers.emplace_back(make_leaf(tp));
+        racers.emplace_back(make_leaf(tp));
+        sum += co_await coro::when_any(std::move(racers));
+
+        auto winner = co_await coro::when_any(make_leaf(tp), make_leaf(tp));
+        sum += std::visit([](uint64_t v) { return v; }, winner);
+#endif
+        co_return sum;
+    };
+
+#ifndef EMSCRIPTEN
+    REQUIRE(coro::sync_wait(make_task()) == 56);
+#else
+    REQUIRE(coro::sync_wait(make_task()) == 42);
+#endif
+    tp->shutdown();
+}
+
+TEST_CASE("task_local spawned tasks inherit through with_task_locals", "[task_local]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+
+    coro::latch              latch{2};
+    std::vector<std::string> seen{};
+    std::mutex               mutex{};
+
+    auto make_spawned = [&]() -> coro::task<void>
+    {
+        auto        locals = co_await coro::this_task::locals();
+        const auto* value  = locals.get(trace_id);
+        {
+            std::scoped_lock lk{mutex};
+            seen.emplace_back(value != nullptr ? *value : "unset");
+        }
+        latch.count_down();
+        co_return;
+    };
+
+    auto make_task = [&]() -> coro::task<void>
+    {
+        auto locals = co_await coro::this_task::locals();
+        locals.set(trace_id, "spawner");
+
+        tp->spawn(coro::with_task_locals(locals, make_spawned()));
+        tp->spawn(make_spawned());
+        co_await latch;
+    };
+
+    coro::sync_wait(make_task());
+    std::sort(seen.begin(), seen.end());
+    REQUIRE(seen == std::vector<std::string>{"spawner", "unset"});
+    tp->shutdown();
+}
+
+TEST_CASE("~task_local", "[task_local]")
+{
+    std::cerr << "[~task_local]\n\n";
+}
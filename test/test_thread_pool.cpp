@@ -273,6 +273,47 @@ TEST_CASE("thread_pool::schedule(task)", "[thread_pool]")
     REQUIRE(main_tid != coroutine_tid);
 }
 
+TEST_CASE("thread_pool current worker and resume on a preferred worker", "[thread_pool]")
+{
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 4});
+
+    REQUIRE(coro::thread_pool::current() == nullptr);
+    REQUIRE(coro::thread_pool::current_worker() == coro::thread_pool::no_worker);
+
+    struct resume_on_worker
+    {
+        coro::thread_pool& m_tp;
+        std::size_t        m_worker;
+
+        auto await_ready() const noexcept -> bool { return false; }
+        auto await_suspend(std::coroutine_handle<> awaiting_coroutine) noexcept -> void
+        {
+            m_tp.resume(awaiting_coroutine, m_worker);
+        }
+        auto await_resume() noexcept -> void {}
+    };
+
+    auto make_task = [](std::shared_ptr<coro::thread_pool> tp) -> coro::task<void>
+    {
+        co_await tp->schedule();
+        REQUIRE(coro::thread_pool::current() == tp.get());
+        REQUIRE(coro::thread_pool::current_worker() < tp->thread_count());
+
+        // Hop across every executor thread, each resumption lands on the requested worker.
+        for (std::size_t i = 0; i < tp->thread_count() * 4; ++i)
+        {
+            auto target = (coro::thread_pool::current_worker() + 1) % tp->thread_count();
+            co_await resume_on_worker{*tp, target};
+            REQUIRE(coro::thread_pool::current_worker() == target);
+        }
+        co_return;
+    };
+
+    coro::sync_wait(make_task(tp));
+    tp->shutdown();
+    REQUIRE(tp->empty());
+}
+
 TEST_CASE("~thread_pool", "[thread_pool]")
 {
     std::cerr << "[~thread_pool]\n\n";
@@ -2,7 +2,9 @@
 
 #include <coro/coro.hpp>
 
+#include <array>
 #include <list>
+#include <memory_resource>
 #include <ranges>
 #include <vector>
 #include <iostream>
@@ -233,6 +235,63 @@ TEST_CASE("when_all return void", "[when_all]")
     REQUIRE(counter == 1 + 2 + 3 + 4);
 }
 
+TEST_CASE("when_all allocator_arg", "[when_all]")
+{
+    std::array<std::byte, 4096>         buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    std::pmr::polymorphic_allocator<std::byte> alloc{&arena};
+
+    auto make_task = [](uint64_t amount) -> coro::task<uint64_t> { co_return amount; };
+
+    // The arena has no upstream, every when_all frame must have come from the buffer.
+    auto results = coro::sync_wait(coro::when_all(std::allocator_arg, alloc, make_task(1), make_task(2)));
+    REQUIRE(std::get<0>(results).return_value() + std::get<1>(results).return_value() == 3);
+
+    std::vector<coro::task<uint64_t>> tasks{};
+    tasks.emplace_back(make_task(10));
+    tasks.emplace_back(make_task(20));
+    auto     output_tasks = coro::sync_wait(coro::when_all(std::allocator_arg, alloc, std::move(tasks)));
+    uint64_t counter{0};
+    for (auto& t : output_tasks)
+    {
+        counter += t.return_value();
+    }
+    REQUIRE(counter == 30);
+}
+
+TEST_CASE("when_all tasks are attached without wrapper frames", "[when_all]")
+{
+    // Every allocation from this allocator throws, coro::task children must not need any.
+    std::pmr::polymorphic_allocator<std::byte> alloc{std::pmr::null_memory_resource()};
+
+    auto make_task = [](uint64_t amount) -> coro::task<uint64_t> { co_return amount; };
+    auto make_void = []() -> coro::task<void> { co_return; };
+
+    auto results = coro::sync_wait(coro::when_all(std::allocator_arg, alloc, make_task(1), make_void(), make_task(2)));
+    REQUIRE(std::get<0>(results).return_value() + std::get<2>(results).return_value() == 3);
+
+    std::vector<coro::task<uint64_t>> tasks{};
+    for (uint64_t i = 0; i < 100; ++i)
+    {
+        tasks.emplace_back(make_task(i));
+    }
+    auto     output_tasks = coro::sync_wait(coro::when_all(std::allocator_arg, alloc, std::move(tasks)));
+    uint64_t counter{0};
+    for (auto& t : output_tasks)
+    {
+        counter += t.return_value();
+    }
+    REQUIRE(counter == 4950);
+
+    auto make_throw = []() -> coro::task<uint64_t>
+    {
+        throw std::runtime_error{"child"};
+        co_return 0;
+    };
+    auto thrown = coro::sync_wait(coro::when_all(std::allocator_arg, alloc, make_throw()));
+    REQUIRE_THROWS_AS(std::get<0>(thrown).return_value(), std::runtime_error);
+}
+
 TEST_CASE("~when_all", "[when_all]")
 {
     std::cerr << "[~when_all]\n\n";
@@ -1,9 +1,12 @@
 #include "catch_amalgamated.hpp"
 #include "catch_extensions.hpp"
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <coro/coro.hpp>
 #include <iostream>
+#include <memory_resource>
 #include <stop_token>
 #include <variant>
 
@@ -282,6 +285,58 @@ TEST_CASE("when_any io_scheduler::schedule(task, timeout)", "[when_any]")
     }
 }
 
+    #if defined(CORO_PLATFORM_UNIX)
+TEST_CASE("when_any cancels the losing timer", "[when_any]")
+{
+    std::cerr << "BEGIN when_any cancels the losing timer\n";
+    using namespace std::chrono_literals;
+    auto s = coro::io_scheduler::make_shared(
+        coro::io_scheduler::options{.pool = coro::thread_pool::options{.thread_count = 1}});
+
+    auto make_task = [](std::shared_ptr<coro::io_scheduler> s) -> coro::task<int64_t>
+    {
+        co_await s->schedule();
+        co_return 1;
+    };
+
+    // The task wins, its 10 second timeout must be removed from the event loop rather than left to expire.
+    auto start  = std::chrono::steady_clock::now();
+    auto result = coro::sync_wait(s->schedule(make_task(s), 10s));
+    REQUIRE(result.has_value());
+    REQUIRE(result.value() == 1);
+
+    while (!s->empty())
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+    REQUIRE(s->stats().timed_events == 0);
+
+    // A losing branch observing the stop token resumes as cancelled once the winner completes.
+    std::atomic<coro::poll_status> loser_status{coro::poll_status::event};
+    auto make_loser = [](std::shared_ptr<coro::io_scheduler> s,
+                         std::stop_token                     stop_token,
+                         std::atomic<coro::poll_status>&     loser_status) -> coro::task<coro::poll_status>
+    {
+        co_await s->schedule();
+        loser_status = co_await s->yield_for(10s, std::move(stop_token));
+        co_return loser_status.load();
+    };
+
+    std::stop_source stop_source{};
+    auto             loser = make_loser(s, stop_source.get_token(), loser_status);
+    auto winner = coro::sync_wait(coro::when_any(std::move(stop_source), make_task(s), std::move(loser)));
+    REQUIRE(winner.index() == 0);
+
+    while (loser_status.load() == coro::poll_status::event || !s->empty())
+    {
+        std::this_thread::sleep_for(1ms);
+    }
+    REQUIRE(loser_status.load() == coro::poll_status::cancelled);
+    REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+}
+    #endif
+
     #ifndef EMSCRIPTEN
 TEST_CASE("when_any io_scheduler::schedule(task, timeout stop_token)", "[when_any]")
 {
@@ -386,6 +441,105 @@ TEST_CASE("when_any tuple multiple", "[when_any]")
 
 #endif
 
+TEST_CASE("when_any allocator_arg", "[when_any]")
+{
+    std::cerr << "BEGIN when_any allocator_arg\n";
+    std::array<std::byte, 8192>         buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    std::pmr::polymorphic_allocator<std::byte> alloc{&arena};
+
+    auto make_task = [](uint64_t amount) -> coro::task<uint64_t> { co_return amount; };
+
+    // The arena has no upstream, every when_any frame must have come from the buffer.
+    std::vector<coro::task<uint64_t>> tasks{};
+    tasks.emplace_back(make_task(1));
+    tasks.emplace_back(make_task(2));
+    REQUIRE(coro::sync_wait(coro::when_any(std::allocator_arg, alloc, std::move(tasks))) == 1);
+
+    auto make_string_task = []() -> coro::task<std::string> { co_return "arena"; };
+    auto result = coro::sync_wait(coro::when_any(std::allocator_arg, alloc, make_task(3), make_string_task()));
+    REQUIRE(std::holds_alternative<uint64_t>(result));
+    REQUIRE(std::get<uint64_t>(result) == 3);
+}
+
+TEST_CASE("when_any range of tasks is attached without wrapper frames", "[when_any]")
+{
+    std::cerr << "BEGIN when_any range of tasks is attached without wrapper frames\n";
+    // Far too small for a wrapper frame per task, only when_any's own frame and its shared state fit.
+    std::array<std::byte, 2048>         buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    std::pmr::polymorphic_allocator<std::byte> alloc{&arena};
+
+    auto make_task = [](uint64_t amount) -> coro::task<uint64_t> { co_return amount; };
+
+    std::vector<coro::task<uint64_t>> tasks{};
+    for (uint64_t i = 1; i <= 100; ++i)
+    {
+        tasks.emplace_back(make_task(i));
+    }
+    REQUIRE(coro::sync_wait(coro::when_any(std::allocator_arg, alloc, std::move(tasks))) == 1);
+
+    auto make_void = []() -> coro::task<void> { co_return; };
+    std::vector<coro::task<void>> void_tasks{};
+    void_tasks.emplace_back(make_void());
+    void_tasks.emplace_back(make_void());
+    coro::sync_wait(coro::when_any(std::move(void_tasks)));
+}
+
+TEST_CASE("when_any range of tasks propagates the winner's exception", "[when_any]")
+{
+    std::cerr << "BEGIN when_any range of tasks propagates the winner's exception\n";
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+
+    auto make_throw = []() -> coro::task<uint64_t>
+    {
+        throw std::runtime_error{"winner"};
+        co_return 0;
+    };
+    auto make_task = [](std::shared_ptr<coro::thread_pool> tp) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        co_return 1;
+    };
+
+    std::vector<coro::task<uint64_t>> tasks{};
+    tasks.emplace_back(make_throw());
+    tasks.emplace_back(make_task(tp));
+    REQUIRE_THROWS_AS(coro::sync_wait(coro::when_any(std::move(tasks))), std::runtime_error);
+    tp->shutdown();
+}
+
+TEST_CASE("when_any tuple of tasks is attached without wrapper frames", "[when_any]")
+{
+    std::cerr << "BEGIN when_any tuple of tasks is attached without wrapper frames\n";
+    // Only when_any's own frame and its shared state fit, a controller and a wrapper per task do not.
+    std::array<std::byte, 1024>         buffer{};
+    std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    std::pmr::polymorphic_allocator<std::byte> alloc{&arena};
+
+    auto make_task        = [](uint64_t amount) -> coro::task<uint64_t> { co_return amount; };
+    auto make_string_task = []() -> coro::task<std::string> { co_return "arena"; };
+
+    auto result = coro::sync_wait(coro::when_any(
+        std::allocator_arg, alloc, make_string_task(), make_task(1), make_task(2), make_task(3), make_task(4)));
+    REQUIRE(result.index() == 0);
+    REQUIRE(std::get<0>(result) == "arena");
+
+    auto tp = coro::thread_pool::make_shared(coro::thread_pool::options{.thread_count = 1});
+    auto make_scheduled_task = [](std::shared_ptr<coro::thread_pool> tp) -> coro::task<uint64_t>
+    {
+        co_await tp->schedule();
+        co_return 1;
+    };
+    auto make_throw = []() -> coro::task<std::string>
+    {
+        throw std::runtime_error{"winner"};
+        co_return "";
+    };
+    REQUIRE_THROWS_AS(coro::sync_wait(coro::when_any(make_scheduled_task(tp), make_throw())), std::runtime_error);
+    tp->shutdown();
+}
+
 TEST_CASE("~when_any", "[when_any]")
 {
     std::cerr << "[~when_any]\n\n";